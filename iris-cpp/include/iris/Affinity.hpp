@@ -0,0 +1,170 @@
+/*!
+ * Contains the processor and memory topology of the machine, and the means to
+ * pin worker threads and their agents to it.
+ */
+#ifndef IRIS_AFFINITY_HPP_
+#define IRIS_AFFINITY_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    /*!
+     * The ways in which worker threads may be laid out across the machine.
+     */
+    enum class AffinityPolicy
+    {
+        /*! Workers may run anywhere; their agents stay where they are. */
+        None,
+
+        /*! Workers fill up one NUMA node before moving on to the next. */
+        Compact,
+
+        /*! Workers are dealt out across the NUMA nodes in turn. */
+        Scatter
+    };
+
+    /*!
+     * Represents where a single worker thread should run.
+     */
+    struct Placement
+    {
+        /*! The processor to pin the worker to, or -1 for any. */
+        types::int32 m_cpu;
+
+        /*! The NUMA node to keep the worker's agents on, or -1 for any. */
+        types::int32 m_node;
+    };
+
+    /*!
+     * Represents the processors available to this process, grouped by the
+     * NUMA node they belong to.
+     *
+     * On Linux the nodes are read from sysfs and restricted to the processors
+     * this process may run on.  Elsewhere, or when sysfs is unavailable, the
+     * machine is treated as a single node.
+     */
+    class Topology
+    {
+        public:
+            /*! Constructor (detects the topology of this machine). */
+            Topology();
+
+            /*!
+             * Constructor.
+             *
+             * @param nodes
+             *        The processors of each NUMA node.
+             * @throws runtime_error
+             *         If there are no processors at all.
+             */
+            explicit Topology(const std::vector<Uint32List>& nodes);
+
+            /*! Destructor. */
+            ~Topology();
+
+            /*!
+             * Returns the processors of the specified NUMA node.
+             *
+             * @param node
+             *        The node to query.
+             * @return A list of processors.
+             */
+            const Uint32List& getCpus(types::uint32 node) const
+            { return m_nodes[node]; }
+
+            /*!
+             * Returns the number of NUMA nodes with at least one processor.
+             *
+             * @return The number of nodes.
+             */
+            types::uint32 getNodeCount() const
+            { return static_cast<types::uint32>(m_nodes.size()); }
+
+            /*!
+             * Lays out the specified number of worker threads according to
+             * the specified policy.  When there are more workers than
+             * processors, the layout wraps around.
+             *
+             * @param numThreads
+             *        The number of worker threads.
+             * @param policy
+             *        The layout to use.
+             * @return The placement of each worker, in order.
+             */
+            std::vector<Placement> place(types::uint32 numThreads,
+                                         AffinityPolicy policy) const;
+
+            /*!
+             * Moves every whole memory page within the specified range onto
+             * the specified NUMA node (on Linux only).
+             *
+             * Pages that cannot be moved are simply left where they are, so
+             * this is purely an optimization.
+             *
+             * @param begin
+             *        The start of the range.
+             * @param bytes
+             *        The length of the range in bytes.
+             * @param node
+             *        The destination node.
+             * @return The number of pages that were moved.
+             */
+            static std::size_t moveToNode(const void* begin,
+                                          std::size_t bytes,
+                                          types::int32 node);
+
+            /*!
+             * Converts the name of an affinity policy into the policy itself.
+             *
+             * @param name
+             *        One of "none", "compact", or "scatter".
+             * @return The matching policy.
+             * @throws runtime_error
+             *         If the name is not recognized.
+             */
+            static AffinityPolicy parsePolicy(const std::string& name);
+
+            /*!
+             * Parses a Linux processor list (e.g. "0-3,8,10-11").
+             *
+             * @param list
+             *        The list to parse.
+             * @return Every processor in the list, in order.
+             * @throws runtime_error
+             *         If the list is malformed.
+             */
+            static Uint32List parseCpuList(const std::string& list);
+
+            /*!
+             * Pins the calling thread to the specified processor (on Linux
+             * only).
+             *
+             * @param cpu
+             *        The processor to run on.
+             * @return Whether the thread was pinned.
+             */
+            static bool pinCurrentThread(types::uint32 cpu);
+
+        private:
+            /*!
+             * Reads the NUMA nodes of this machine from sysfs.
+             *
+             * @return Whether any processors were found.
+             */
+            bool detect();
+
+        private:
+            /*! The processors of each NUMA node. */
+            std::vector<Uint32List> m_nodes;
+
+            /*! The identifier of each NUMA node, as the kernel knows it. */
+            Uint32List              m_nodeIds;
+    };
+}
+
+#endif
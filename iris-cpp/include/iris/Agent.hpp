@@ -4,13 +4,12 @@
 #ifndef IRIS_AGENT_HPP_
 #define IRIS_AGENT_HPP_
 
-#include <memory>
-#include <mutex>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "iris/Parameters.hpp"
+#include "iris/Random.hpp"
+#include "iris/Span.hpp"
 #include "iris/Types.hpp"
 
 namespace iris
@@ -68,43 +67,26 @@ namespace iris
         types::unumeric m_reinforced;
     };
 
+    // Forward declare to avoid inclusion problems.
+    class AgentStore;
+    class DeltaBuffer;
+    class ScratchArena;
+
     /*!
-     * Represents the state of an agent in terms of the behaviors she exhibits
-     * at some time <i>t</i>.
+     * Represents a single agent in a simulation.
+     *
+     * An agent does not own any state itself; it is a lightweight handle to a
+     * position in an AgentStore, which keeps the state of every agent in
+     * contiguous columns.  Handles are cheap to create and copy and are
+     * obtained by indexing into a store.
      */
-    struct State
-    {
-        /*!
-         * The time that this step was updated at.
-         *
-         * This does <i>not</i> correspond to any real measurement of time.
-         * Instead, <i>m_time</i> represents the current step count when the
-         * behavior list was updated.
-         */
-        types::uint64   m_time;
-
-        /*!
-         * The list of current behaviors at some time <i>t</i>.
-         */
-        BehaviorList    m_behavior;
-
-        /*!
-         * Assignment operator.
-         *
-         * @param state
-         *        The state to copy from.
-         * @return A reference to this state.
-         */
-        State& operator = (const State& state);
-    };
-    
     class Agent
     {
         public:
             typedef std::vector<AgentID>                     Network;
-            typedef std::unordered_map<AgentID, Interaction> InteractionMap;
+            typedef Span<const AgentID>                      NetworkView;
+            typedef Span<AgentID>                            Group;
             typedef std::pair<types::uint32, types::uint32>  Sides;
-            typedef std::lock_guard<std::mutex>              mutex_guard;
             
         public:            
             /*!
@@ -153,8 +135,15 @@ namespace iris
                 Keep,
             };
 
-            /*! Constructor. */
-            Agent();
+            /*!
+             * Constructor.
+             *
+             * @param store
+             *        The store that holds the state of this agent.
+             * @param index
+             *        The position of this agent in the store.
+             */
+            Agent(AgentStore& store, AgentID index);
 
             /*! Destructor. */
             ~Agent();
@@ -167,14 +156,20 @@ namespace iris
              * @param totalAgents
              * @param behaviors
              * @param time
-             * @param random
+             * @param deltas
+             *        Where to record changes to the counters and privilege of
+             *        any agent, to be merged once every agent has stepped.
+             * @param arena
+             *        The scratch memory of the calling thread, which is reset
+             *        and then holds every temporary of this step.
              */
             void step(const Parameters& params,
-                      Agent* const agents,
+                      AgentStore& agents,
                       AgentID totalAgents,
                       const BehaviorList& behaviors,
                       types::uint64 time,
-                      types::mersenne_twister& random);
+                      DeltaBuffer& deltas,
+                      ScratchArena& arena);
 
         public:
             // The following functions are used exclusively by each agent every
@@ -183,23 +178,21 @@ namespace iris
             // These methods are grouped together to make them easy to unit test
             // (and find).
 
-            BehaviorList cacheBehaviorsAsSet(const Network& powerGroup,
-                                             Agent* const agents,
-                                             types::uint32 index,
-                                             types::uint64 time);
+            Span<types::uint32> cacheBehaviorsAsSet(NetworkView powerGroup,
+                                                    AgentStore& agents,
+                                                    types::uint32 index,
+                                                    ScratchArena& arena);
 
             Outcome computeOutcomeDirectly(const Sides& sides) const;
 
             Outcome computeOutcomeSociodynamically(const Sides& sides,
                                                    const Parameters& params,
-                                         types::mersenne_twister& random) const;
+                                         CounterRandom& random) const;
             
             Sides computeSides(types::uint32 index,
                                types::uint32 behavior,
-                               Network socialGroup,
-                               Agent* const agents,
-                               AgentID totalAgents,
-                               types::uint64 time) const;
+                               NetworkView socialGroup,
+                               AgentStore& agents) const;
 
             CommType determineCommType(const types::uint32& me,
                                        const types::uint32& you,
@@ -207,18 +200,19 @@ namespace iris
 
             void distributePrivilege(types::uint32 currentIndex,
                                      types::uint32 currentBehavior,
-                                     const Network& socialGroup,
+                                     NetworkView socialGroup,
                                      const Outcome& outcome,
-                                     Agent* const agents,
-                                     types::uint64 time);
+                                     AgentStore& agents,
+                                     DeltaBuffer& deltas);
 
             void distributePrivilegeWithPower(types::uint32 currentIndex,
                                               types::uint32 currentBehavior,
-                                              const Network& socialGroup,
-                                              const Network& powerGroup,
+                                              NetworkView socialGroup,
+                                              NetworkView powerGroup,
                                               const Outcome& outcome,
-                                              Agent* const agents,
-                                              types::uint64 time);
+                                              AgentStore& agents,
+                                              DeltaBuffer& deltas,
+                                              ScratchArena& arena);
         
         
             /*!
@@ -234,44 +228,70 @@ namespace iris
                                            types::uint32 x) const;
             
             
-            Network extractPowerful(const Network& network, Agent* const agents,
-                                    AgentID totalAgents);
-
-            Network obtainRandomInfluentialGroup(types::uint32 qIn,
-                                                 types::uint32 qOut,
-                                                 Agent* const agents,
-                                                 AgentID totalAgents,
-                                               types::mersenne_twister& random);
+            Group extractPowerful(NetworkView network, AgentStore& agents,
+                                  ScratchArena& arena);
+
+            Group obtainRandomInfluentialGroup(types::uint32 qIn,
+                                               types::uint32 qOut,
+                                               AgentStore& agents,
+                                               AgentID totalAgents,
+                                               CounterRandom& random,
+                                               ScratchArena& arena);
             
             /*!
+             * Draws distinct agents, uniformly at random, from this agent's
+             * network.
              *
+             * Only qIn positions of the network are ever looked at, using
+             * Floyd's algorithm (which draws the same subsets as a partial
+             * Fisher-Yates shuffle, but without a scratch copy to shuffle).
+             * Nothing is allocated.
              *
              * @param qIn
-             *        The 
-             * @return
+             *        The number of agents to draw.
+             * @param random
+             *        The random stream to draw from.
+             * @param sample
+             *        Where to write the agents drawn, with room for at least
+             *        min(qIn, network size) of them.
+             * @return The number of agents drawn, which is less than qIn only
+             *         if the network is smaller than that.
              */
-            Network obtainRandomInGroup(types::uint32 qIn,
-                                        types::mersenne_twister& random);
+            types::uint32 sampleInGroup(types::uint32 qIn,
+                                        CounterRandom& random,
+                                        AgentID* sample) const;
 
             /*!
+             * Draws distinct agents, uniformly at random, from outside this
+             * agent's network (excluding this agent itself).
              *
+             * Candidates are drawn and rejected if they are in the network
+             * (a binary search) or were already drawn (a scan of the sample
+             * so far, which is only ever a handful of agents).  When no more
+             * than the requested number of agents are left to choose from,
+             * every one of them is taken instead.  Nothing is allocated and
+             * nothing is thrown.
              *
              * @param qOut
-             *
+             *        The number of agents to draw.
              * @param totalAgents
-             *
-             * @return
+             *        The total number of agents in the simulation.
+             * @param random
+             *        The random stream to draw from.
+             * @param sample
+             *        Where to write the agents drawn, with room for at least
+             *        min(qOut, totalAgents) of them.
+             * @return The number of agents drawn, which is less than qOut
+             *         only if the population was exhausted.
              */
-            Network obtainRandomOutGroup(types::uint32 qOut,
+            types::uint32 sampleOutGroup(types::uint32 qOut,
                                          AgentID totalAgents,
-                                         types::mersenne_twister& random);
-
-            void removeNonPowerful(Network& network, Agent* const agents,
-                                   AgentID totalAgents);
+                                         CounterRandom& random,
+                                         AgentID* sample) const;
 
             types::uint32 selectNewBehavior(types::uint32 currentBehavior,
                                             types::uint32 behaviorRange,
-                                            types::mersenne_twister& random);
+                                            CounterRandom& random);
 
         public:
             // The following functions are used as accessors by the graph
@@ -286,13 +306,42 @@ namespace iris
              *
              * @param to
              *        The unique id of the agent to add to the network.
+             * @throws runtime_error
+             *         If the networks of the store have been frozen.
              */
             void addConnection(AgentID to);
 
-            types::uint32 getBehaviorAt(types::uint32 index,
-                                        types::uint64 time);
+            /*!
+             * Returns this agent's current behavior for the specified
+             * variable.
+             *
+             * While a simulation step is in progress this is the behavior
+             * from the previous step, regardless of whether this agent has
+             * already been updated.
+             *
+             * @param index
+             *        The behavior variable to read.
+             * @return The current behavior.
+             */
+            types::uint32 getBehaviorAt(types::uint32 index) const;
 
-            InteractionMap::iterator getInteractionsWith(const AgentID& id);
+            /*!
+             * Returns the counters of communication events between this agent
+             * and the specified one, creating them if necessary.
+             *
+             * Agents in this agent's (frozen) network use counters aligned
+             * with the network itself; everybody else is looked up in the
+             * store's out-group table.
+             *
+             * This is not safe to call while agents are being stepped
+             * concurrently; changes made during a step go through a
+             * DeltaBuffer instead.
+             *
+             * @param id
+             *        The agent that was interacted with.
+             * @return A reference to the interaction counters.
+             */
+            Interaction& getInteractionsWith(const AgentID& id);
             
             /*!
              * Increases the amount of privilege this agent possesses by one.
@@ -325,6 +374,8 @@ namespace iris
              *
              * @param behavior
              *        The vector of behaviors to use.
+             * @throws runtime_error
+             *         If the behaviors do not match the store's encoding.
              */
             void setInitialBehavior(BehaviorList behavior);
 
@@ -336,6 +387,8 @@ namespace iris
              *
              * @param values
              *        The vector of values to use.
+             * @throws runtime_error
+             *         If the values do not match the store's encoding.
              */
             void setInitialValues(ValueList values);
 
@@ -356,13 +409,19 @@ namespace iris
              */
             void setUId(AgentID uid);
 
-            void updateCommunicationWith(const Network& network);
-            
-            void updateInfluenceOn(const AgentID& targetId,
-                                   const CommType& commType);
-            
-            void updateState(types::uint32 index, types::uint32 behavior,
-                             types::uint64 time);
+            /*!
+             * Writes this agent's behaviors for the next time step, which are
+             * the current ones with a single variable replaced.
+             *
+             * The result becomes visible once the store's behavior buffers
+             * are swapped.
+             *
+             * @param index
+             *        The behavior variable to change.
+             * @param behavior
+             *        The new behavior.
+             */
+            void updateState(types::uint32 index, types::uint32 behavior);
             
         public:
             // The following methods are used as accessors by the I/O
@@ -397,15 +456,6 @@ namespace iris
              */
             types::uint32 getFamilySize() const;
             
-            /*!
-             * Returns the map of communication events that have transpired
-             * between this agent and all other agents she has encountered
-             * since the start of the simulation.
-             *
-             * @return The communication map.
-             */
-            InteractionMap getInteractions() const;
-            
             /*!
              * Returns the social (egocentric) network with this agent as its
              * center.
@@ -414,9 +464,11 @@ namespace iris
              * network; it contains only links from other agents to this one
              * that act as the "in" group to which she belongs.
              *
+             * The returned view is only valid until the network is modified.
+             *
              * @return The social network.
              */
-            Network getNetwork() const;
+            NetworkView getNetwork() const;
             
             /*!
              * Returns the amount of privilege this agent possesses.
@@ -458,18 +510,11 @@ namespace iris
             bool isPowerful() const;
             
         private:
-            types::uint32          m_familySize;
-            InteractionMap         m_interactions;
-            Network                m_network;
-            bool                   m_powerful;
-            types::atomic_unumeric m_privilege;
-            State                  m_state[2];
-            AgentID                m_uid;
-            ValueList              m_values;
+            /*! The position of this agent in the store. */
+            AgentID     m_index;
 
-        private:
-mutable            std::mutex     m_bMutex;
-mutable            std::mutex     m_iMutex;
+            /*! The store that holds the state of this agent. */
+            AgentStore* m_store;
     };
 }
 
@@ -0,0 +1,599 @@
+/*!
+ * Contains the column-oriented storage for the state of every agent in a
+ * simulation.
+ */
+#ifndef IRIS_AGENT_STORE_HPP_
+#define IRIS_AGENT_STORE_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "iris/Agent.hpp"
+#include "iris/AttributeCodec.hpp"
+#include "iris/InteractionTable.hpp"
+#include "iris/MappedFile.hpp"
+#include "iris/Span.hpp"
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    /*!
+     * Represents the collective state of an agent population stored as a
+     * structure of arrays.
+     *
+     * Each per-agent quantity lives in its own contiguous column indexed by an
+     * agent's position in the store.  This keeps the data a simulation step
+     * actually touches (behaviors, privilege, power) densely packed instead of
+     * interleaved with cold data such as values and interaction histories.
+     * Individual agents are accessed through lightweight handles obtained via
+     * the subscript operator.
+     *
+     * Behaviors and values are bit-packed into a single word per agent, using
+     * codecs sized from the ranges of the discrete variables given at
+     * initialization.  Behaviors are additionally double-buffered: the
+     * simulation reads from one population-wide buffer while writing the next
+     * time step into the other, and the two are swapped between steps.
+     *
+     * Social networks are built up one list per agent during graph generation
+     * and are then frozen into a single compressed sparse row (CSR) structure,
+     * after which they are read-only and accessed exclusively through spans.
+     * Frozen networks may also be memory-mapped from a file instead, so that
+     * graphs larger than memory are paged in on demand.
+     *
+     * Interaction counters between an agent and a member of its network are
+     * kept in an array aligned with the frozen network targets; all other
+     * contacts are kept in hash tables sharded by owner.
+     *
+     * The counters and privilege of an agent may be modified by any other
+     * agent that interacts with it.  During a simulation step such
+     * modifications are recorded in a DeltaBuffer, bucketed by shard, and
+     * applied once every agent has been stepped; since shards own disjoint
+     * sets of agents, they may then be merged concurrently without locking.
+     */
+    class AgentStore
+    {
+        public:
+            /*!
+             * The number of shards mutable per-agent state is divided into;
+             * must be a power of two.
+             */
+            static const types::uint32 ShardCount = 256;
+
+            /*!
+             * Represents the start of a network file, which is followed by
+             * the offsets and then the targets of every frozen network, all
+             * in native byte order.
+             */
+            struct NetworkHeader
+            {
+                /*! Identifies the file as a network file. */
+                char          m_magic[8];
+
+                /*! The number of agents. */
+                types::uint64 m_agents;
+
+                /*! The number of edges. */
+                types::uint64 m_edges;
+
+                /*! The size of an agent identifier in bytes. */
+                types::uint32 m_idBytes;
+
+                /*! Unused (zero). */
+                types::uint32 m_reserved;
+            };
+
+        public:
+            /*! Constructor. */
+            AgentStore();
+
+            /*!
+             * Constructor.
+             *
+             * @param totalAgents
+             *        The total number of agents to allocate.
+             * @param values
+             *        The vector of value factors.
+             * @param behaviors
+             *        The vector of behavior factors.
+             */
+            AgentStore(AgentID totalAgents, const ValueList& values,
+                       const BehaviorList& behaviors);
+
+            /*! Destructor. */
+            ~AgentStore();
+
+            /*!
+             * Returns a handle to the agent at the specified position.
+             *
+             * @param index
+             *        The position of the agent in this store.
+             * @return A handle to an agent.
+             */
+            Agent operator [] (AgentID index)
+            { return Agent(*this, index); }
+
+            /*!
+             * Releases all columns, returning this store to its uninitialized
+             * state.
+             */
+            void clear();
+
+            /*!
+             * Compacts the social network of every agent into a single pair of
+             * offset and target arrays and releases the per-agent lists used
+             * during construction.
+             *
+             * This also allocates an interaction counter for every edge.
+             *
+             * Once frozen, networks may no longer be modified.
+             *
+             * @throws runtime_error
+             *         If the networks have already been frozen.
+             */
+            void freezeNetworks();
+
+            /*!
+             * Adopts networks that were built directly in compressed sparse
+             * row form, releasing the per-agent lists used during
+             * construction.
+             *
+             * This also allocates an interaction counter for every edge.
+             *
+             * @param offsets
+             *        The start of each agent's network in the targets, with
+             *        one trailing entry holding the total number of edges.
+             * @param targets
+             *        The networks of every agent, back to back, each sorted
+             *        by position.
+             * @throws runtime_error
+             *         If the networks have already been frozen or the offsets
+             *         do not match this store and the targets.
+             */
+            void freezeNetworks(std::vector<types::uint64> offsets,
+                                std::vector<AgentID> targets);
+
+            /*!
+             * Fills in the header of a network file.
+             *
+             * @param agents
+             *        The number of agents.
+             * @param edges
+             *        The number of edges.
+             * @return A header for the networks of that many agents.
+             */
+            static NetworkHeader createNetworkHeader(AgentID agents,
+                                                     types::uint64 edges);
+
+            /*!
+             * Allocates every column for the specified number of agents, where
+             * the encoding of the behavior and value columns is derived from
+             * the ranges of the discrete variables in each specification.
+             *
+             * All columns are zero-initialized.
+             *
+             * @param totalAgents
+             *        The total number of agents to allocate.
+             * @param values
+             *        The vector of value factors.
+             * @param behaviors
+             *        The vector of behavior factors.
+             * @throws runtime_error
+             *         If this store has already been initialized or the
+             *         variables do not fit into a packed word.
+             */
+            void initialize(AgentID totalAgents, const ValueList& values,
+                            const BehaviorList& behaviors);
+
+            /*!
+             * Freezes the networks by memory-mapping them from the specified
+             * network file (see NetworkHeader), releasing the per-agent lists
+             * used during construction.
+             *
+             * This also allocates an interaction counter for every edge.
+             * The file must stay in place for as long as this store uses it.
+             *
+             * @param filename
+             *        The network file to map.
+             * @throws runtime_error
+             *         If the networks have already been frozen, or the file
+             *         cannot be mapped or does not match this store.
+             */
+            void mapNetworks(const std::string& filename);
+
+            /*!
+             * Moves the columns of the specified agents, along with their
+             * frozen networks, onto the specified NUMA node.
+             *
+             * @param first
+             *        The position of the first agent.
+             * @param last
+             *        One past the position of the last agent.
+             * @param node
+             *        The destination node.
+             * @return The number of memory pages that were moved.
+             */
+            std::size_t moveToNode(AgentID first, AgentID last,
+                                   types::int32 node);
+
+            /*!
+             * Returns whether or not this store has been allocated.
+             *
+             * @return Whether any agents are present.
+             */
+            bool isInitialized() const
+            { return !m_uid.empty(); }
+
+            /*!
+             * Returns the shard the specified agent belongs to.
+             *
+             * @param index
+             *        The position of the agent.
+             * @return A shard index.
+             */
+            static types::uint32 getShard(AgentID index)
+            { return static_cast<types::uint32>(index & (ShardCount - 1)); }
+
+            /*!
+             * Returns whether or not the social networks have been compacted
+             * and are therefore read-only.
+             *
+             * @return Whether the networks are frozen.
+             */
+            bool isFrozen() const
+            { return !m_offsetView.empty(); }
+
+            /*!
+             * Returns a read-only view of the social network of the specified
+             * agent, which is valid both before and after freezing.
+             *
+             * @param index
+             *        The position of the agent.
+             * @return A view of a social network.
+             */
+            Agent::NetworkView getNetwork(AgentID index) const
+            {
+                if(this->isFrozen())
+                {
+                    const auto targets = m_targetView.data();
+                    return Agent::NetworkView(targets + m_offsetView[index],
+                                              targets +
+                                              m_offsetView[index + 1]);
+                }
+
+                return Agent::NetworkView(m_networks[index]);
+            }
+
+            /*!
+             * Returns the number of agents in this store.
+             *
+             * @return The total number of agents.
+             */
+            AgentID size() const
+            { return static_cast<AgentID>(m_uid.size()); }
+
+        public:
+            // The following functions provide direct access to individual
+            // columns and are used by the simulation, generators, and writers
+            // alike.
+
+            /*!
+             * Returns the encoding used for the behaviors of every agent.
+             *
+             * @return The behavior codec.
+             */
+            const AttributeCodec& getBehaviorCodec() const
+            { return m_behaviorCodec; }
+
+            /*!
+             * Returns the encoding used for the values of every agent.
+             *
+             * @return The value codec.
+             */
+            const AttributeCodec& getValueCodec() const
+            { return m_valueCodec; }
+
+            /*!
+             * Returns the current (packed) behaviors of the specified agent.
+             *
+             * During a simulation step this is the state every agent reads
+             * from; it does not change until the epoch is advanced.
+             *
+             * @param index
+             *        The position of the agent.
+             * @return A reference to a packed behavior word.
+             */
+            types::attribute_word& getBehaviorWord(AgentID index)
+            { return m_behaviors[m_epoch][index]; }
+
+            types::attribute_word getBehaviorWord(AgentID index) const
+            { return m_behaviors[m_epoch][index]; }
+
+            /*!
+             * Returns the (packed) behaviors the specified agent will have
+             * once the epoch is advanced.
+             *
+             * @param index
+             *        The position of the agent.
+             * @return A reference to a packed behavior word.
+             */
+            types::attribute_word& getNextBehaviorWord(AgentID index)
+            { return m_behaviors[m_epoch ^ 1][index]; }
+
+            /*!
+             * Makes the behaviors written during the current simulation step
+             * visible by swapping the current and next behavior buffers.
+             *
+             * Every agent is expected to have written its next behaviors
+             * since the last swap.
+             */
+            void swapBehaviors()
+            { m_epoch ^= 1; }
+
+            /*!
+             * Returns the (packed) values of the specified agent.
+             *
+             * @param index
+             *        The position of the agent.
+             * @return A reference to a packed value word.
+             */
+            types::attribute_word& getValueWord(AgentID index)
+            { return m_values[index]; }
+
+            types::attribute_word getValueWord(AgentID index) const
+            { return m_values[index]; }
+
+            std::vector<types::uint32>& getFamilySizes()
+            { return m_familySize; }
+
+            const std::vector<types::uint32>& getFamilySizes() const
+            { return m_familySize; }
+
+            /*!
+             * Returns the interaction counters of every network edge, in the
+             * same order as the frozen network targets.
+             *
+             * @return The edge-aligned interaction counters.
+             */
+            std::vector<Interaction>& getEdgeInteractions()
+            { return m_edgeInteractions; }
+
+            const std::vector<Interaction>& getEdgeInteractions() const
+            { return m_edgeInteractions; }
+
+            /*!
+             * Returns the interaction counters, owned by the specified agent,
+             * with agents that are not connected to it in a social network.
+             *
+             * The table is shared by every agent in the same shard.
+             *
+             * @param index
+             *        The position of the agent.
+             * @return The out-group interaction counters of a shard.
+             */
+            InteractionTable& getOutGroupInteractions(AgentID index)
+            { return m_outGroupInteractions[getShard(index)]; }
+
+            /*!
+             * Returns the out-group interaction counters of every shard.
+             *
+             * @return The out-group interaction counters.
+             */
+            const std::vector<InteractionTable>& getOutGroupShards() const
+            { return m_outGroupInteractions; }
+
+            /*!
+             * Moves every agent to a new position, rewriting the frozen
+             * networks to match.
+             *
+             * Agents keep their unique identifiers (and so their random
+             * streams), so output may still be written in terms of the
+             * original numbering.  Each network stays sorted by position.
+             *
+             * @param order
+             *        The current position of the agent to place at each new
+             *        position.
+             * @throws runtime_error
+             *         If the networks are not frozen, the order is not a
+             *         permutation of every position, or out-group contacts
+             *         have already been recorded.
+             */
+            void renumber(const IDList& order);
+
+            /*!
+             * Sets whether or not the specified agent is "powerful".
+             *
+             * @param index
+             *        The position of the agent.
+             * @param isPowerful
+             *        Whether or not it is to be considered "powerful".
+             */
+            void setPowerful(AgentID index, bool isPowerful);
+
+            /*!
+             * Makes exactly the specified agents "powerful".
+             *
+             * @param positions
+             *        The position of every powerful agent, in strictly
+             *        ascending order.
+             * @throws runtime_error
+             *         If the positions are out of order or out of range.
+             */
+            void setPowerfulAgents(IDList positions);
+
+            /*!
+             * Orders the out-group interaction counters of every shard by
+             * pair, so they read the same however the agents were stepped.
+             */
+            void sortOutGroupInteractions();
+
+            /*!
+             * Returns the per-agent social networks that are under
+             * construction; these are empty once the store is frozen.
+             *
+             * @return The social networks being built.
+             */
+            std::vector<Agent::Network>& getNetworks()
+            { return m_networks; }
+
+            const std::vector<Agent::Network>& getNetworks() const
+            { return m_networks; }
+
+            /*!
+             * Returns the start of each agent's frozen network in the
+             * targets, with one trailing entry holding the total number of
+             * edges.
+             *
+             * @return The frozen network offsets (empty until frozen).
+             */
+            Span<const types::uint64> getNetworkOffsets() const
+            { return m_offsetView; }
+
+            /*!
+             * Returns the frozen networks of every agent, back to back.
+             *
+             * @return The frozen network targets.
+             */
+            Span<const AgentID> getNetworkTargets() const
+            { return m_targetView; }
+
+            const std::vector<types::uint8>& getPowerFlags() const
+            { return m_powerful; }
+
+            /*!
+             * Returns the position of every powerful agent, so they may be
+             * visited without scanning the power flags of every agent.
+             *
+             * @return The powerful agents, in ascending order.
+             */
+            const IDList& getPowerfulAgents() const
+            { return m_powerIndex; }
+
+            std::vector<types::unumeric>& getPrivileges()
+            { return m_privilege; }
+
+            const std::vector<types::unumeric>& getPrivileges() const
+            { return m_privilege; }
+
+            std::vector<AgentID>& getUIds()
+            { return m_uid; }
+
+            const std::vector<AgentID>& getUIds() const
+            { return m_uid; }
+
+        private:
+            /*!
+             * Points the network views at the mapped file, if any, and at
+             * the in-memory networks otherwise.
+             */
+            void refreshViews();
+
+            /*!
+             * Rearranges the specified column so that each new position holds
+             * the entry of the agent moved there.
+             *
+             * @param column
+             *        The column to rearrange.
+             * @param order
+             *        The current position of the agent at each new position.
+             */
+            template <typename T>
+            static void permute(std::vector<T>& column, const IDList& order)
+            {
+                std::vector<T> permuted(column.size());
+
+                for(std::size_t i = 0; i < order.size(); i++)
+                {
+                    permuted[i] = column[order[i]];
+                }
+
+                column.swap(permuted);
+            }
+
+        private:
+            /*! The encoding of the behaviors of every agent. */
+            AttributeCodec                     m_behaviorCodec;
+
+            /*! The encoding of the values of every agent. */
+            AttributeCodec                     m_valueCodec;
+
+            /*! The behavior buffer holding the current state (zero or one). */
+            types::uint32                      m_epoch;
+
+        private:
+            /*! The current and next (packed) behaviors of every agent. */
+            std::vector<types::attribute_word> m_behaviors[2];
+
+            /*! The size of the family each agent belongs to. */
+            std::vector<types::uint32>         m_familySize;
+
+            /*! Whether or not each agent is "powerful" (zero or one). */
+            std::vector<types::uint8>          m_powerful;
+
+            /*! The position of every powerful agent, in ascending order. */
+            IDList                             m_powerIndex;
+
+            /*! The amount of privilege each agent possesses. */
+            std::vector<types::unumeric>       m_privilege;
+
+            /*! The unique identifier of each agent. */
+            std::vector<AgentID>               m_uid;
+
+            /*! The (packed) values of every agent. */
+            std::vector<types::attribute_word> m_values;
+
+        private:
+            // The following columns are only touched once per contact and
+            // during output.
+
+            /*!
+             * The history of communication events along each network edge.
+             */
+            std::vector<Interaction>           m_edgeInteractions;
+
+            /*! The history of all other communication events, per shard. */
+            std::vector<InteractionTable>      m_outGroupInteractions;
+
+        private:
+            /*! The social network of each agent while under construction. */
+            std::vector<Agent::Network>        m_networks;
+
+            /*!
+             * The start of each agent's frozen network in the targets array,
+             * with one trailing entry holding the total number of edges.
+             */
+            std::vector<types::uint64>         m_offsets;
+
+            /*! The frozen social networks of every agent, back to back. */
+            std::vector<AgentID>               m_targets;
+
+            /*! The network file the frozen networks are mapped from, if any. */
+            MappedFile                         m_mapping;
+
+            /*! The frozen network offsets, wherever they are held. */
+            Span<const types::uint64>          m_offsetView;
+
+            /*! The frozen network targets, wherever they are held. */
+            Span<const AgentID>                m_targetView;
+    };
+
+    /*!
+     * Visits the counters of every pair of agents that actually interacted:
+     * first those of each used network edge, in order of the network, then
+     * those of each out-group table.
+     *
+     * @param agents
+     *        The store of agents.
+     * @param totalAgents
+     *        The total number of agents present.
+     * @param visit
+     *        What to do with the identifiers of each pair and their counters.
+     */
+    void forEachInteraction(const AgentStore& agents, AgentID totalAgents,
+                            const std::function<void(AgentID, AgentID,
+                                                     const Interaction&)>&
+                            visit);
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*!
+ * Contains a bump allocator for the short-lived temporaries of an agent step.
+ */
+#ifndef IRIS_ARENA_HPP_
+#define IRIS_ARENA_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "iris/Span.hpp"
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    /*!
+     * Represents scratch memory that is handed out by bumping an offset and
+     * reclaimed all at once.
+     *
+     * Each thread that steps agents owns one arena, which is reset at the
+     * start of every agent step.  Should a step ever need more than the
+     * current block, another block is chained on; the next reset then merges
+     * every block into one large enough for that step, so a warmed-up arena
+     * never touches the heap again.
+     *
+     * Memory is handed out uninitialized and is never destroyed, so only
+     * trivially destructible types may be allocated.
+     */
+    class ScratchArena
+    {
+        public:
+            /*! The default size of the first block, in bytes. */
+            static const std::size_t DefaultCapacity = 16384;
+
+        public:
+            /*!
+             * Constructor.
+             *
+             * @param capacity
+             *        The size of the first block, in bytes.
+             */
+            explicit ScratchArena(std::size_t capacity = DefaultCapacity);
+
+            /*!
+             * Copy constructor.
+             *
+             * Scratch memory is never shared, so the copy is simply a fresh
+             * arena with the same capacity.
+             *
+             * @param arena
+             *        The arena to copy the capacity of.
+             */
+            ScratchArena(const ScratchArena& arena);
+
+            /*! Destructor. */
+            ~ScratchArena();
+
+            ScratchArena& operator = (const ScratchArena&) = delete;
+
+            /*!
+             * Hands out room for the specified number of elements, which
+             * remains valid until the next reset.
+             *
+             * @param count
+             *        The number of elements.
+             * @return A span over the (uninitialized) elements.
+             */
+            template<typename T>
+            Span<T> allocate(std::size_t count)
+            {
+                static_assert(std::is_trivially_destructible<T>::value,
+                              "Arena memory is never destroyed.");
+
+                const auto memory = this->allocateBytes(count * sizeof(T),
+                                                        alignof(T));
+
+                return Span<T>(static_cast<T*>(memory), count);
+            }
+
+            /*!
+             * Returns the total size of every block, in bytes.
+             *
+             * @return The capacity of this arena.
+             */
+            std::size_t getCapacity() const;
+
+            /*!
+             * Returns the number of bytes handed out since the last reset.
+             *
+             * @return The used portion of this arena.
+             */
+            std::size_t getUsed() const
+            { return m_spilled + m_offset; }
+
+            /*!
+             * Reclaims everything handed out so far.
+             */
+            void reset();
+
+        private:
+            /*!
+             * Represents a single contiguous block of scratch memory.
+             */
+            struct Block
+            {
+                /*! The memory itself. */
+                std::unique_ptr<types::uint8[]> m_data;
+
+                /*! The size of the memory, in bytes. */
+                std::size_t                     m_size;
+            };
+
+        private:
+            /*!
+             * Hands out the specified number of bytes at the specified
+             * alignment, chaining on a new block if necessary.
+             *
+             * @param bytes
+             *        The number of bytes.
+             * @param alignment
+             *        The alignment (a power of two).
+             * @return The start of the memory.
+             */
+            void* allocateBytes(std::size_t bytes, std::size_t alignment);
+
+        private:
+            /*! Every block, with the one being bumped through last. */
+            std::vector<Block> m_blocks;
+
+            /*! The offset of the next free byte in the last block. */
+            std::size_t        m_offset;
+
+            /*! The bytes handed out from every block before the last. */
+            std::size_t        m_spilled;
+    };
+}
+
+#endif
@@ -0,0 +1,145 @@
+/*!
+ * Contains the bit-packed encoding used to store the values and behaviors of
+ * an agent in a single machine word.
+ */
+#ifndef IRIS_ATTRIBUTE_CODEC_HPP_
+#define IRIS_ATTRIBUTE_CODEC_HPP_
+
+#include <vector>
+
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    /*!
+     * Represents a mapping between a list of discrete variables and a single
+     * packed word.
+     *
+     * Each variable is given a fixed-width bit field just large enough to
+     * hold every value in its range, with the first variable occupying the
+     * least significant bits.  For the small ranges typical of a simulation
+     * (e.g. two behaviors of two choices each) this stores an entire list in
+     * a handful of bits rather than a vector of 32-bit integers.
+     *
+     * The width of a word is controlled by types::attribute_word, which may be
+     * widened to 64 bits with IRIS_USE_64BIT_ATTRIBUTES.
+     */
+    class AttributeCodec
+    {
+        public:
+            typedef types::attribute_word Word;
+
+        public:
+            /*! Constructor. */
+            AttributeCodec();
+
+            /*!
+             * Constructor.
+             *
+             * @param ranges
+             *        The number of choices for each discrete variable.
+             * @throws runtime_error
+             *         If the variables do not fit into a single word.
+             */
+            explicit AttributeCodec(const Uint32List& ranges);
+
+            /*! Destructor. */
+            ~AttributeCodec();
+
+            /*!
+             * Unpacks every variable in the specified word into a list.
+             *
+             * @param word
+             *        The packed word to decode.
+             * @return A list of variables.
+             */
+            Uint32List decode(Word word) const;
+
+            /*!
+             * Packs the specified list of variables into a single word.
+             *
+             * @param list
+             *        The list of variables to encode.
+             * @return A packed word.
+             * @throws runtime_error
+             *         If the list is the wrong size or a variable is outside
+             *         of its range.
+             */
+            Word encode(const Uint32List& list) const;
+
+            /*!
+             * Returns a single variable from the specified packed word.
+             *
+             * @param word
+             *        The packed word to read from.
+             * @param index
+             *        The variable to read.
+             * @return The value of a variable.
+             */
+            types::uint32 get(Word word, types::uint32 index) const
+            {
+                return static_cast<types::uint32>(
+                    (word >> m_shifts[index]) & m_masks[index]);
+            }
+
+            /*!
+             * Returns the number of choices for the specified variable.
+             *
+             * @param index
+             *        The variable to query.
+             * @return The range of a variable.
+             */
+            types::uint32 getRange(types::uint32 index) const
+            { return m_ranges[index]; }
+
+            /*!
+             * Returns the total number of bits used by a packed word.
+             *
+             * @return The number of bits in use.
+             */
+            types::uint32 getWidth() const
+            { return m_width; }
+
+            /*!
+             * Returns a copy of the specified packed word with a single
+             * variable replaced.
+             *
+             * @param word
+             *        The packed word to modify.
+             * @param index
+             *        The variable to replace.
+             * @param value
+             *        The new value of the variable.
+             * @return A new packed word.
+             */
+            Word set(Word word, types::uint32 index, types::uint32 value) const
+            {
+                const auto field = m_masks[index] << m_shifts[index];
+                return (word & ~field) |
+                    ((static_cast<Word>(value) << m_shifts[index]) & field);
+            }
+
+            /*!
+             * Returns the number of variables in a packed word.
+             *
+             * @return The number of variables.
+             */
+            types::uint32 size() const
+            { return static_cast<types::uint32>(m_ranges.size()); }
+
+        private:
+            /*! The bit mask of each variable, before shifting. */
+            std::vector<Word>          m_masks;
+
+            /*! The number of choices for each variable. */
+            Uint32List                 m_ranges;
+
+            /*! The position of the lowest bit of each variable. */
+            std::vector<types::uint32> m_shifts;
+
+            /*! The total number of bits in use. */
+            types::uint32              m_width;
+    };
+}
+
+#endif
@@ -0,0 +1,144 @@
+/*!
+ * Contains a reusable barrier for synchronizing simulation steps.
+ */
+#ifndef IRIS_BARRIER_HPP_
+#define IRIS_BARRIER_HPP_
+
+#include <atomic>
+
+#ifndef __linux__
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    /*!
+     * Represents a reusable barrier at which a fixed number of threads meet
+     * once or more per simulation step.
+     *
+     * A thread that arrives early first spins for a short while, since on a
+     * small population the others are usually only microseconds behind, and
+     * then sleeps until the last thread arrives.  On Linux, sleeping threads
+     * wait directly on the barrier's generation counter with a futex, and the
+     * last thread only makes a system call if anybody actually went to sleep;
+     * elsewhere a condition variable is used.
+     *
+     * The barrier may be used again as soon as it has been passed; a thread
+     * that races ahead into the next phase simply waits for the next
+     * generation.
+     */
+    class StepBarrier
+    {
+        public:
+            /*!
+             * The default number of times to poll before sleeping when more
+             * than one hardware thread is available.
+             */
+            static const types::uint32 DefaultSpins = 4096;
+
+        public:
+            /*!
+             * Constructor.
+             *
+             * Spinning is disabled entirely on a single hardware thread,
+             * where it could only delay the threads being waited for.
+             *
+             * @param parties
+             *        The number of threads that must arrive to pass.
+             */
+            explicit StepBarrier(types::uint32 parties = 1);
+
+            /*!
+             * Constructor.
+             *
+             * @param parties
+             *        The number of threads that must arrive to pass.
+             * @param spins
+             *        The number of times to poll before sleeping.
+             */
+            StepBarrier(types::uint32 parties, types::uint32 spins);
+
+            /*! Destructor. */
+            ~StepBarrier();
+
+            StepBarrier(const StepBarrier&) = delete;
+            StepBarrier& operator = (const StepBarrier&) = delete;
+
+            /*!
+             * Returns the number of threads that must arrive to pass.
+             *
+             * @return The number of parties.
+             */
+            types::uint32 getParties() const
+            { return m_parties; }
+
+            /*!
+             * Sets the number of threads that must arrive to pass.
+             *
+             * This must not be called while any thread is waiting.
+             *
+             * @param parties
+             *        The new number of parties.
+             * @throws runtime_error
+             *         If the number of parties is zero.
+             */
+            void reset(types::uint32 parties);
+
+            /*!
+             * Waits until every party has arrived.
+             *
+             * @return The time spent waiting, in nanoseconds.
+             */
+            types::uint64 wait();
+
+        private:
+            /*!
+             * Hints to the processor that the calling thread is
+             * busy-waiting.
+             */
+            static void relax();
+
+            /*!
+             * Puts the calling thread to sleep until the generation moves
+             * past the specified one.
+             *
+             * @param generation
+             *        The generation the caller arrived in.
+             */
+            void sleep(types::uint32 generation);
+
+            /*!
+             * Wakes every sleeping thread.
+             */
+            void wakeAll();
+
+        private:
+            /*! The number of threads that have arrived this generation. */
+            std::atomic<types::uint32> m_arrived;
+
+            /*! The number of times the barrier has been passed. */
+            std::atomic<types::uint32> m_generation;
+
+            /*! The number of threads that are (about to be) asleep. */
+            std::atomic<types::uint32> m_sleepers;
+
+            /*! The number of threads that must arrive to pass. */
+            types::uint32              m_parties;
+
+            /*! The number of times to poll before sleeping. */
+            types::uint32              m_spins;
+
+#ifndef __linux__
+            /*! Guards sleeping on the condition variable. */
+            std::mutex                 m_mutex;
+
+            /*! Signaled whenever the generation moves on. */
+            std::condition_variable    m_wake;
+#endif
+    };
+}
+
+#endif
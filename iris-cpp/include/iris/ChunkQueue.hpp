@@ -0,0 +1,115 @@
+/*!
+ * Contains a work-stealing queue of agent chunks.
+ */
+#ifndef IRIS_CHUNK_QUEUE_HPP_
+#define IRIS_CHUNK_QUEUE_HPP_
+
+#include <atomic>
+
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    /*!
+     * Represents the chunks of agents a single worker thread is responsible
+     * for stepping, which other workers may steal once they run out of their
+     * own.
+     *
+     * A worker's chunks are always a contiguous range, so the queue is just
+     * the front and back of that range packed into one word.  The owner takes
+     * chunks from the front, walking its agents in order, while thieves take
+     * them from the back; both claim a chunk with a single compare-and-swap.
+     * Nothing is ever pushed during a step, so once a queue is seen empty it
+     * stays empty until it is refilled.
+     */
+    class ChunkQueue
+    {
+        public:
+            /*! Constructor. */
+            ChunkQueue();
+
+            /*! Destructor. */
+            ~ChunkQueue();
+
+            ChunkQueue(const ChunkQueue&) = delete;
+            ChunkQueue& operator = (const ChunkQueue&) = delete;
+
+            /*!
+             * Sets the chunks that this queue is refilled with and fills it.
+             *
+             * @param first
+             *        The first chunk.
+             * @param last
+             *        One past the last chunk.
+             * @throws runtime_error
+             *         If the range is ill-formed.
+             */
+            void assign(types::uint32 first, types::uint32 last);
+
+            /*!
+             * Takes the next chunk from the front of this queue.
+             *
+             * @param chunk
+             *        The chunk that was taken, if any.
+             * @return Whether a chunk was taken.
+             */
+            bool pop(types::uint32& chunk);
+
+            /*!
+             * Returns the first assigned chunk.
+             *
+             * @return The first chunk.
+             */
+            types::uint32 getFirst() const
+            { return m_first; }
+
+            /*!
+             * Returns one past the last assigned chunk.
+             *
+             * @return The end of the assigned chunks.
+             */
+            types::uint32 getLast() const
+            { return m_last; }
+
+            /*!
+             * Restores every assigned chunk.
+             *
+             * This must not be called while any worker is using the queue.
+             */
+            void refill();
+
+            /*!
+             * Returns the number of chunks left in this queue.
+             *
+             * @return The number of chunks.
+             */
+            types::uint32 size() const;
+
+            /*!
+             * Takes the last chunk from the back of this queue.
+             *
+             * @param chunk
+             *        The chunk that was taken, if any.
+             * @return Whether a chunk was taken.
+             */
+            bool steal(types::uint32& chunk);
+
+        private:
+            /*! The front (high half) and back (low half) of the range. */
+            std::atomic<types::uint64> m_range;
+
+            /*! The first assigned chunk. */
+            types::uint32              m_first;
+
+            /*! One past the last assigned chunk. */
+            types::uint32              m_last;
+
+            /*!
+             * Keeps queues that sit next to each other in memory on separate
+             * cache lines.
+             */
+            char                       m_padding[48];
+    };
+}
+
+#endif
@@ -0,0 +1,225 @@
+/*!
+ * Contains a buffer of deferred changes to the mutable state of agents.
+ */
+#ifndef IRIS_DELTA_BUFFER_HPP_
+#define IRIS_DELTA_BUFFER_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    /*!
+     * Represents the changes a single thread makes to the interaction
+     * counters and privilege of agents during one simulation step.
+     *
+     * Nothing is written to the store while agents are being stepped;
+     * instead, every change is appended to a bucket for the shard of the
+     * agent it applies to.  Once every agent has been stepped, the buffers of
+     * all threads are merged shard by shard.  Because a shard owns a disjoint
+     * set of agents (and its own out-group table), different shards may be
+     * merged by different threads at the same time without any locking.
+     *
+     * Buckets keep their capacity after a merge, so a buffer stops allocating
+     * once it has seen a typical step.
+     *
+     * Alongside the changes, a buffer keeps a tally of what its thread did to
+     * the population as a whole during the step (which behaviors changed, and
+     * by how much privilege grew), so that statistics may be kept up to date
+     * without counting every agent.  The tally is not touched by a merge and
+     * is only discarded when it is cleared.
+     */
+    class DeltaBuffer
+    {
+        public:
+            /*!
+             * Represents a change of an agent's behaviors from one packed
+             * word to another.
+             */
+            struct Transition
+            {
+                /*! The behaviors before the change. */
+                types::attribute_word m_from;
+
+                /*! The behaviors after the change. */
+                types::attribute_word m_to;
+            };
+
+            typedef std::vector<Transition> TransitionList;
+
+        public:
+            /*! Constructor. */
+            DeltaBuffer();
+
+            /*! Destructor. */
+            ~DeltaBuffer();
+
+            /*!
+             * Records that one agent communicated with another.
+             *
+             * @param from
+             *        The position of the agent that owns the counters.
+             * @param to
+             *        The agent that was communicated with.
+             */
+            void addCommunication(AgentID from, AgentID to)
+            { this->add(from, to, Agent::CommType::Neither); }
+
+            /*!
+             * Records a communication that may also have influenced the
+             * other agent.
+             *
+             * @param from
+             *        The position of the agent that owns the counters.
+             * @param to
+             *        The agent that was communicated with.
+             * @param commType
+             *        The kind of influence, if any.
+             */
+            void addInfluence(AgentID from, AgentID to,
+                              Agent::CommType commType)
+            { this->add(from, to, commType); }
+
+            /*!
+             * Records that an agent's privilege increased by one.
+             *
+             * @param index
+             *        The position of the agent.
+             */
+            void addPrivilege(AgentID index)
+            {
+                this->add(index, index, Privileged);
+                m_privileged++;
+            }
+
+            /*!
+             * Records that an agent's behaviors changed.
+             *
+             * @param from
+             *        The behaviors before the change.
+             * @param to
+             *        The behaviors after the change.
+             */
+            void addTransition(types::attribute_word from,
+                               types::attribute_word to)
+            { m_transitions.push_back(Transition{from, to}); }
+
+            /*!
+             * Discards the tally of behavior transitions and privilege.
+             */
+            void clearTally();
+
+            /*!
+             * Returns whether or not any changes are waiting to be merged.
+             *
+             * @return Whether this buffer is empty.
+             */
+            bool empty() const
+            { return this->size() == 0; }
+
+            /*!
+             * Applies, then discards, the changes recorded for the specified
+             * range of shards.
+             *
+             * @param agents
+             *        The store of agents to apply the changes to.
+             * @param firstShard
+             *        The first shard to merge.
+             * @param lastShard
+             *        One past the last shard to merge.
+             */
+            void merge(AgentStore& agents, types::uint32 firstShard,
+                       types::uint32 lastShard);
+
+            /*!
+             * Returns the total privilege given out since the tally was last
+             * cleared.
+             *
+             * @return The number of privilege increases.
+             */
+            types::uint64 getPrivilegeTally() const
+            { return m_privileged; }
+
+            /*!
+             * Makes room for the specified number of changes, assuming they
+             * are spread evenly across the shards, and behavior transitions
+             * so that recording them does not allocate.
+             *
+             * @param records
+             *        The number of changes to make room for.
+             * @param transitions
+             *        The number of transitions to make room for.
+             */
+            void reserve(std::size_t records, std::size_t transitions = 0);
+
+            /*!
+             * Returns the number of changes waiting to be merged.
+             *
+             * @return The number of recorded changes.
+             */
+            std::size_t size() const;
+
+            /*!
+             * Returns the behavior transitions recorded since the tally was
+             * last cleared.
+             *
+             * @return The list of transitions.
+             */
+            const TransitionList& getTransitions() const
+            { return m_transitions; }
+
+        private:
+            /*!
+             * The kind of a change that is not a communication, numbered past
+             * every CommType.
+             */
+            static const types::uint32 Privileged = 3;
+
+            /*!
+             * Represents a single recorded change.
+             */
+            struct Record
+            {
+                /*! The position of the agent that owns the state. */
+                AgentID       m_from;
+
+                /*! The agent that was communicated with, if any. */
+                AgentID       m_to;
+
+                /*! The kind of change (a CommType, or Privileged). */
+                types::uint32 m_kind;
+            };
+
+            /*!
+             * Appends a change to the bucket of the owning agent's shard.
+             *
+             * @param from
+             *        The position of the agent that owns the state.
+             * @param to
+             *        The agent that was communicated with, if any.
+             * @param kind
+             *        The kind of change.
+             */
+            void add(AgentID from, AgentID to, types::uint32 kind)
+            {
+                m_buckets[AgentStore::getShard(from)]
+                    .push_back(Record{from, to, kind});
+            }
+
+        private:
+            /*! The recorded changes, one bucket per shard. */
+            std::vector<std::vector<Record>> m_buckets;
+
+            /*! The number of privilege increases in the tally. */
+            types::uint64                    m_privileged;
+
+            /*! The behavior transitions in the tally. */
+            TransitionList                   m_transitions;
+    };
+}
+
+#endif
@@ -0,0 +1,143 @@
+/*!
+ * Contains a flat hash table of interaction counters between pairs of agents.
+ */
+#ifndef IRIS_INTERACTION_TABLE_HPP_
+#define IRIS_INTERACTION_TABLE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "iris/Agent.hpp"
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    /*!
+     * Represents the interaction counters for pairs of agents that are not
+     * connected in a social network, i.e. contacts made through an agent's
+     * out-group.
+     *
+     * Entries are kept densely in insertion order so they may be iterated
+     * without gaps, while lookups go through an open-addressing index with
+     * linear probing.  Nothing is ever removed short of clearing the entire
+     * table.
+     */
+    class InteractionTable
+    {
+        public:
+            /*!
+             * Represents the interaction counters of a single pair of agents.
+             */
+            struct Entry
+            {
+                /*! The position of the agent that owns the counters. */
+                AgentID     m_from;
+
+                /*! The agent that was interacted with. */
+                AgentID     m_to;
+
+                /*! The counters themselves. */
+                Interaction m_counts;
+            };
+
+            typedef std::vector<Entry>::const_iterator const_iterator;
+
+        public:
+            /*! Constructor. */
+            InteractionTable();
+
+            /*! Destructor. */
+            ~InteractionTable();
+
+            const_iterator begin() const
+            { return m_entries.begin(); }
+
+            const_iterator end() const
+            { return m_entries.end(); }
+
+            /*!
+             * Removes every entry from this table.
+             */
+            void clear();
+
+            /*!
+             * Returns the counters between the specified pair of agents,
+             * if any.
+             *
+             * @param from
+             *        The position of the agent that owns the counters.
+             * @param to
+             *        The agent that was interacted with.
+             * @return A pointer to the counters, or null if none exist.
+             */
+            const Interaction* find(AgentID from, AgentID to) const;
+
+            /*!
+             * Returns the counters between the specified pair of agents,
+             * creating zeroed counters if none exist yet.
+             *
+             * @param from
+             *        The position of the agent that owns the counters.
+             * @param to
+             *        The agent that was interacted with.
+             * @return A reference to the counters.
+             */
+            Interaction& get(AgentID from, AgentID to);
+
+            /*!
+             * Ensures that the specified number of entries may be added
+             * without growing the index.
+             *
+             * @param count
+             *        The number of entries to make room for.
+             */
+            void reserve(std::size_t count);
+
+            /*!
+             * Orders the entries of this table by pair, so that iteration no
+             * longer depends on the order in which they were added.
+             */
+            void sort();
+
+            /*!
+             * Returns the number of pairs with counters in this table.
+             *
+             * @return The number of entries.
+             */
+            std::size_t size() const
+            { return m_entries.size(); }
+
+        private:
+            /*!
+             * Computes the first slot to probe for the specified pair.
+             *
+             * @param from
+             *        The position of the agent that owns the counters.
+             * @param to
+             *        The agent that was interacted with.
+             * @return A hash of the pair.
+             */
+            std::size_t hash(AgentID from, AgentID to) const;
+
+            /*!
+             * Rebuilds the index with the specified number of slots, which
+             * must be a power of two.
+             *
+             * @param capacity
+             *        The new number of slots.
+             */
+            void rehash(std::size_t capacity);
+
+        private:
+            /*! The counters of every pair, in insertion order. */
+            std::vector<Entry>       m_entries;
+
+            /*!
+             * The open-addressing index, where each slot holds a position in
+             * the entries plus one (zero marks an empty slot).
+             */
+            std::vector<std::size_t> m_slots;
+    };
+}
+
+#endif
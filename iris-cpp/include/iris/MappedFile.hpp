@@ -0,0 +1,103 @@
+/*!
+ * Contains a read-only view of a file mapped into memory.
+ */
+#ifndef IRIS_MAPPED_FILE_HPP_
+#define IRIS_MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    /*!
+     * Represents the contents of a file, mapped into memory read-only so the
+     * operating system may page it in and out on demand.
+     *
+     * On Linux the file is mapped with mmap; elsewhere it is simply read into
+     * memory, which behaves the same but offers no relief on memory.
+     */
+    class MappedFile
+    {
+        public:
+            /*! Constructor (maps nothing). */
+            MappedFile();
+
+            /*!
+             * Constructor.
+             *
+             * @param filename
+             *        The file to map.
+             * @throws runtime_error
+             *         If the file cannot be opened or mapped.
+             */
+            explicit MappedFile(const std::string& filename);
+
+            /*!
+             * Move constructor.
+             *
+             * @param file
+             *        The mapping to take over.
+             */
+            MappedFile(MappedFile&& file);
+
+            /*! Destructor (unmaps the file). */
+            ~MappedFile();
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator = (const MappedFile&) = delete;
+
+            /*!
+             * Move assignment operator.
+             *
+             * @param file
+             *        The mapping to take over.
+             * @return This mapping.
+             */
+            MappedFile& operator = (MappedFile&& file);
+
+            /*!
+             * Returns the start of the mapped contents.
+             *
+             * @return The first byte of the file, or null if none is mapped.
+             */
+            const types::uint8* data() const
+            { return m_data; }
+
+            /*!
+             * Returns whether or not a file is mapped.
+             *
+             * @return Whether a file is mapped.
+             */
+            bool isOpen() const
+            { return m_data != nullptr; }
+
+            /*!
+             * Returns the size of the mapped contents.
+             *
+             * @return The size of the file in bytes.
+             */
+            std::size_t size() const
+            { return m_size; }
+
+        private:
+            /*!
+             * Unmaps the current file, if any.
+             */
+            void release();
+
+        private:
+            /*! The mapped contents. */
+            const types::uint8*             m_data;
+
+            /*! The contents, when read rather than mapped. */
+            std::unique_ptr<types::uint8[]> m_buffer;
+
+            /*! The size of the contents in bytes. */
+            std::size_t                     m_size;
+    };
+}
+
+#endif
@@ -1,24 +1,32 @@
 #ifndef IRIS_MODEL_HPP_
 #define IRIS_MODEL_HPP_
 
+#include <atomic>
 #include <fstream>
+#include <memory>
 #include <random>
 #include <vector>
 #include <string>
 
+#include "iris/Affinity.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/Arena.hpp"
+#include "iris/DeltaBuffer.hpp"
 #include "iris/Parameters.hpp"
 #include "iris/Threading.hpp"
 #include "iris/Types.hpp"
 
+#include "iris/gen/Ordering.hpp"
+
+#include "iris/io/Columnar.hpp"
 #include "iris/io/CommandLine.hpp"
 #include "iris/io/reader/CensusReader.hpp"
+#include "iris/io/writer/AsyncStatisticsWriter.hpp"
+#include "iris/io/writer/ColumnWriter.hpp"
 #include "iris/io/writer/StatisticsWriter.hpp"
 
 namespace iris
 {
-    // Forward declare to avoid inclusion problems.
-    class Agent;
-
     /*!
      * Represents a mechanism to create, configure, and run a single
      * simulation.
@@ -64,14 +72,15 @@ namespace iris
 
             /*!
              * Creates and configures all of the agents for this simulation.
-             *
-             * This also allocates the (shuffled) indice collection.
              */
             void setUpAgents();
 
             /*!
-             * Configures the random number generator to use the specified
-             * seed.
+             * Configures every random stream of this simulation to derive
+             * from the specified seed.
+             *
+             * This must be called before the graph structure and attributes
+             * are generated.
              *
              * @param seed
              *        The random seed to use.
@@ -83,10 +92,22 @@ namespace iris
              * simulation.
              */
             void setUpIoStreams();
+
+            /*!
+             * Creates and starts the worker pool if more than one thread was
+             * requested, partitioning the agents evenly between workers.
+             *
+             * This must be called after the graph structure has been
+             * generated.
+             */
+            void setUpThreading();
       
             /*!
              * Generates a randomized social network for each agent in the
              * simulation, giving rise to a unique graph structure per run.
+             *
+             * When streaming, the graph is written to a network file in the
+             * data directory and memory-mapped from there.
              */
             void generateGraphStructure();
 
@@ -102,6 +123,15 @@ namespace iris
              * on the simulation dynamics.
              */
             void generateAttributes();
+
+            /*!
+             * Renumbers the generated population (if requested) so that
+             * socially connected agents sit close to each other in memory.
+             *
+             * Agents keep their unique identifiers, so every output file is
+             * still written in terms of the original numbering.
+             */
+            void renumberAgents();
             
             /*!
              * Runs the simulation for a specific number of time steps.
@@ -127,15 +157,33 @@ namespace iris
              */
             void checkForLoops();
 #endif
+
+            /*!
+             * Creates the description of this run kept by every binary column
+             * file.
+             *
+             * @return The metadata of this run.
+             */
+            io::Metadata createMetadata() const;
+
+            /*!
+             * Writes the current census to the statistics file, in whichever
+             * format was chosen.
+             */
+            void recordStatistics();
+
+            /*!
+             * Brings the statistics up to date with the changes tallied
+             * during the current step, checking them against a full count if
+             * it is time to.
+             */
+            void updateStatistics();
             
         private:
             /*!
-             * The array of agents in a simulation.
-             *
-             * Note that this is a naked pointer array and the total number of
-             * elements [in this array] is held in the parameter object.
+             * The state of every agent in a simulation.
              */
-            Agent*                  m_agents;
+            AgentStore              m_agents;
 
             /*!
              * The list of behavioral factors, where each index corresponds to
@@ -159,11 +207,6 @@ namespace iris
              */
             Parameters              m_params;
 
-            /*!
-             * The (core) random number generator.
-             */
-            types::mersenne_twister m_random;
-      
             /*!
              * The list of value factors, where each index corresponds to an
              * independent discrete variable.
@@ -187,32 +230,123 @@ namespace iris
              */
             std::ofstream              m_statsFile;
 
+            /*!
+             * The barrier wait file stream (only used with worker threads).
+             */
+            std::ofstream              m_barrierFile;
+
+            /*!
+             * The barrier wait column file, if results are binary.
+             */
+            std::unique_ptr<io::ColumnWriter> m_barrierColumns;
+
+            /*!
+             * The form in which results are written.
+             */
+            io::OutputFormat           m_format;
+
+            /*!
+             * The description of this run kept by every binary column file.
+             */
+            io::Metadata               m_metadata;
+
+            /*!
+             * The current simulation run.
+             */
+            types::uint32              m_run;
+
+            /*!
+             * The statistics column file, if results are binary.
+             */
+            std::unique_ptr<io::ColumnWriter> m_statsColumns;
+
             /*!
              * The statistics tracker.
              */
             io::StatisticsWriter       m_statistics;
 
+            /*!
+             * The background writer of statistics, if any; declared after
+             * everything it writes with, so that it stops first.
+             */
+            std::unique_ptr<io::AsyncStatisticsWriter> m_statsWriter;
+
         private:
             /*!
-             * The threading controller (unused).
+             * How worker threads are laid out across the machine.
+             */
+            AffinityPolicy             m_affinity;
+
+            /*!
+             * The number of agents per block when the graph is streamed to
+             * disk, or zero to build it in memory.
+             */
+            AgentID                    m_blockSize;
+
+            /*!
+             * The number of steps between full counts of an incrementally
+             * kept census, or zero to never check it.
+             */
+            types::uint64              m_checkInterval;
+
+            /*!
+             * The number of agents per work-stealing chunk.
+             */
+            AgentID                    m_chunkSize;
+
+            /*!
+             * Whether statistics are kept up to date from the changes of
+             * each step rather than counted in full.
+             */
+            bool                       m_incremental;
+
+            /*!
+             * The order to renumber the population in after generation.
+             */
+            gen::Ordering              m_ordering;
+
+            /*!
+             * The number of steps of statistics waiting to be written in the
+             * background, or zero to write them on the simulation thread.
+             */
+            types::uint32              m_queueDepth;
+
+            /*!
+             * Whether statistics only count the occupied permutations of
+             * behaviors.
+             */
+            bool                       m_sparse;
+
+            /*!
+             * The most permutations written per step by a sparse census, or
+             * zero for every occupied one.
+             */
+            types::uint64              m_sparseLimit;
+
+            /*!
+             * The threading controller.
              */
             ThreadController           m_controller;
 
             /*!
-             * The number of threads to use (unused).
+             * The scratch memory of agents stepped on the main thread.
              */
-            types::uint32              m_numThreads;
+            ScratchArena               m_arena;
 
             /*!
-             * The current time step.
+             * The changes made by agents stepped on the main thread.
              */
-            types::uint64              m_time;
+            DeltaBuffer                m_deltas;
 
-        private:
             /*!
-             * The iteration order (shuffled each step).
+             * The number of threads to use.
+             */
+            types::uint32              m_numThreads;
+
+            /*!
+             * The current time step.
              */
-            std::vector<AgentID>       m_indices;
+            std::atomic<types::uint64> m_time;
     };
 }
 
@@ -83,6 +83,11 @@ namespace iris
          * during graph generation (non-family).
          */
         types::fnumeric m_recip;
+
+        /*!
+         * The seed from which every random stream in a simulation is derived.
+         */
+        types::uint64   m_seed;
     };
 }
 
@@ -0,0 +1,129 @@
+/*!
+ * Contains a counter-based random number generator that derives independent,
+ * reproducible streams from a single seed.
+ */
+#ifndef IRIS_RANDOM_HPP_
+#define IRIS_RANDOM_HPP_
+
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    /*!
+     * Represents a random number generator based on the Philox4x32-10 block
+     * cipher (Salmon et al., 2011).
+     *
+     * Unlike a conventional engine, every output is a pure function of a key
+     * and a counter: the key is the simulation seed, and the counter is made
+     * up of a stream identifier (typically an agent's unique id), a time step,
+     * and the index of the draw within that stream and step.  Any agent may
+     * therefore construct its own generator for any step, on any thread, and
+     * obtain exactly the same numbers as it would have on any other.
+     *
+     * Time steps are taken modulo 2^32.  The largest step values are reserved
+     * for the generation phases listed below.
+     *
+     * This class satisfies the requirements of a uniform random bit generator
+     * and so may be used with any of the standard distributions.
+     */
+    class CounterRandom
+    {
+        public:
+            typedef types::uint32 result_type;
+
+        public:
+            /*! The step used to choose family sizes. */
+            static const types::uint64 FamilyStep    = 0xFFFFFFFF;
+
+            /*! The step used to wire out-group connections. */
+            static const types::uint64 OutGroupStep  = 0xFFFFFFFE;
+
+            /*! The step used to assign values and behaviors. */
+            static const types::uint64 AttributeStep = 0xFFFFFFFD;
+
+            /*! The step used to choose powerful agents. */
+            static const types::uint64 PowerStep     = 0xFFFFFFFC;
+
+            /*! The step used to shuffle dispensed attributes. */
+            static const types::uint64 ShuffleStep   = 0xFFFFFFFB;
+
+        public:
+            /*!
+             * Constructor.
+             *
+             * @param seed
+             *        The seed shared by every stream in a simulation.
+             * @param stream
+             *        The identifier of this stream (e.g. an agent's id).
+             * @param step
+             *        The time step or generation phase.
+             */
+            CounterRandom(types::uint64 seed, types::uint64 stream,
+                          types::uint64 step);
+
+            /*! Destructor. */
+            ~CounterRandom();
+
+            /*!
+             * Returns the next 32 random bits of this stream.
+             *
+             * @return A random integer.
+             */
+            result_type operator () ()
+            {
+                if(m_used == 4)
+                {
+                    this->refill();
+                }
+
+                return m_block[m_used++];
+            }
+
+            static constexpr result_type min()
+            { return 0; }
+
+            static constexpr result_type max()
+            { return 0xFFFFFFFF; }
+
+            /*!
+             * Returns the number of 32-bit draws taken from this stream.
+             *
+             * @return The draw count.
+             */
+            types::uint64 getDrawCount() const;
+
+            /*!
+             * Applies the Philox4x32-10 bijection to the specified counter in
+             * place.
+             *
+             * @param counter
+             *        The four words of the counter to encrypt.
+             * @param key
+             *        The two words of the key to use.
+             */
+            static void encrypt(types::uint32 counter[4],
+                                const types::uint32 key[2]);
+
+        private:
+            /*!
+             * Generates the next block of four outputs and advances the
+             * counter.
+             */
+            void refill();
+
+        private:
+            /*! The current output block. */
+            types::uint32 m_block[4];
+
+            /*! The counter of the next block to generate. */
+            types::uint32 m_counter[4];
+
+            /*! The key (seed). */
+            types::uint32 m_key[2];
+
+            /*! The number of outputs of the current block already used. */
+            types::uint32 m_used;
+    };
+}
+
+#endif
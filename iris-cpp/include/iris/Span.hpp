@@ -0,0 +1,113 @@
+/*!
+ * Contains a lightweight, non-owning view over a contiguous sequence of
+ * elements.
+ */
+#ifndef IRIS_SPAN_HPP_
+#define IRIS_SPAN_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace iris
+{
+    /*!
+     * Represents a read-only or mutable window into memory owned by somebody
+     * else, typically a single row of a column in an AgentStore.
+     *
+     * A span never allocates and is only valid for as long as the memory it
+     * points to is; it is intended to be passed around by value.
+     */
+    template<typename T>
+    class Span
+    {
+        public:
+            typedef T            value_type;
+            typedef T*           iterator;
+            typedef T*           const_iterator;
+            typedef std::size_t  size_type;
+
+        public:
+            /*! Constructor. */
+            Span()
+                : m_data(nullptr), m_size(0)
+            {}
+
+            /*!
+             * Constructor.
+             *
+             * @param data
+             *        The first element to view.
+             * @param size
+             *        The number of elements to view.
+             */
+            Span(T* data, size_type size)
+                : m_data(data), m_size(size)
+            {}
+
+            /*!
+             * Constructor.
+             *
+             * @param first
+             *        The first element to view.
+             * @param last
+             *        One past the last element to view.
+             */
+            Span(T* first, T* last)
+                : m_data(first), m_size(static_cast<size_type>(last - first))
+            {}
+
+            /*!
+             * Creates a view over the entire contents of the specified vector.
+             *
+             * @param vec
+             *        The vector to view.
+             */
+            template<typename U>
+            Span(std::vector<U>& vec)
+                : m_data(vec.data()), m_size(vec.size())
+            {}
+
+            template<typename U>
+            Span(const std::vector<U>& vec)
+                : m_data(vec.data()), m_size(vec.size())
+            {}
+
+            /*!
+             * Converts a mutable span to a read-only one.
+             *
+             * @param span
+             *        The span to convert.
+             */
+            template<typename U>
+            Span(const Span<U>& span)
+                : m_data(span.data()), m_size(span.size())
+            {}
+
+            T& operator [] (size_type index) const
+            { return m_data[index]; }
+
+            iterator begin() const
+            { return m_data; }
+
+            T* data() const
+            { return m_data; }
+
+            bool empty() const
+            { return m_size == 0; }
+
+            iterator end() const
+            { return m_data + m_size; }
+
+            size_type size() const
+            { return m_size; }
+
+        private:
+            /*! The first element in view. */
+            T*        m_data;
+
+            /*! The number of elements in view. */
+            size_type m_size;
+    };
+}
+
+#endif
@@ -6,26 +6,33 @@
 #include <thread>
 #include <vector>
 
+#include "iris/Affinity.hpp"
+#include "iris/Arena.hpp"
+#include "iris/Barrier.hpp"
+#include "iris/ChunkQueue.hpp"
+#include "iris/DeltaBuffer.hpp"
 #include "iris/Parameters.hpp"
 
 namespace iris
 {
-    class Agent;
+    class AgentStore;
   
     class ThreadWorker
     {
         public:
-            ThreadWorker(std::atomic<types::uint32>& complete,
+            ThreadWorker(StepBarrier& step, StepBarrier& merge,
                          std::atomic<types::uint64>& time);
             ThreadWorker(const ThreadWorker& worker);
             ~ThreadWorker();
 
-            void initialize(Agent* agents, AgentID start, AgentID end,
-                            Parameters params, BehaviorList behaviors);
+            void initialize(AgentStore* agents, AgentID totalAgents,
+                            AgentID chunkSize, Parameters params,
+                            BehaviorList behaviors);
+            void share(std::vector<DeltaBuffer>* deltas,
+                       std::vector<ChunkQueue>* queues, types::uint32 slot);
+            void pin(const Placement& placement);
 
             void join();
-            void signal()
-            { m_signal = true;  }
 
             void start(types::uint32 id);
             void stop();
@@ -33,26 +40,34 @@ namespace iris
             // These functions are for unit testing only !!!
       
             BehaviorList getBehaviorList() const;
-            std::vector<AgentID> getIndices() const;
+            AgentID getChunkSize() const;
             Parameters getParameters() const;
+            Placement getPlacement() const;
             types::uint64 getTime() const;
+            types::uint64 getWaitTime() const;
       
         private:
-            void prepareRandom();
             void run();
+            void stepChunk(types::uint32 chunk, types::uint64 time);
 
         private:
-            Agent*                      m_agents;
+            AgentStore*                 m_agents;
+            ScratchArena                m_arena;
             BehaviorList                m_behaviors;
-            std::atomic<types::uint32>& m_complete;
+            AgentID                     m_chunkSize;
+            std::vector<DeltaBuffer>*   m_deltas;
             types::uint32               m_id;
-            std::vector<AgentID>        m_indices;
+            StepBarrier&                m_merge;
             Parameters                  m_params;
-            types::mersenne_twister     m_random;
+            Placement                   m_placement;
+            std::vector<ChunkQueue>*    m_queues;
             std::atomic<bool>           m_running;
-            std::atomic<bool>           m_signal;
+            types::uint32               m_slot;
+            StepBarrier&                m_step;
             std::thread                 m_thread;
             std::atomic<types::uint64>& m_time;
+            AgentID                     m_totalAgents;
+            types::uint64               m_waited;
     };
 
     typedef std::vector<ThreadWorker> WorkerPool;
@@ -63,10 +78,19 @@ namespace iris
             ThreadController();
             ~ThreadController();
 
-            void initialize(Agent* agents, AgentID totalAgents,
+            void initialize(AgentStore* agents, AgentID totalAgents,
                             const Parameters& params, BehaviorList behaviors,
-                            types::uint32 numThreads,
+                            types::uint32 numThreads, AgentID chunkSize,
+                            AffinityPolicy affinity,
                             std::atomic<types::uint64>& time);
+
+            const std::vector<DeltaBuffer>& getDeltaBuffers() const
+            { return m_deltas; }
+
+            std::vector<types::uint64> getWaitTimes() const;
+
+            bool isInitialized() const
+            { return !m_pool.empty(); }
       
             void signalAll();
             void start();
@@ -75,8 +99,12 @@ namespace iris
             void waitForCompletion();
 
         private:
-            std::atomic<types::uint32> m_completions;
+            std::vector<DeltaBuffer>   m_deltas;
+            StepBarrier                m_merge;
             WorkerPool                 m_pool;
+            std::vector<ChunkQueue>    m_queues;
+            bool                       m_running;
+            StepBarrier                m_step;
     };
 }
 
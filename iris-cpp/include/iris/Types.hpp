@@ -28,6 +28,12 @@ namespace iris
 #endif
         typedef double     fnumeric;
 
+#if defined(IRIS_USE_64BIT_ATTRIBUTES) || defined(IRIS_FORCE_64BIT_TYPES)
+        typedef uint64     attribute_word;
+#else
+        typedef uint32     attribute_word;
+#endif
+
         typedef std::atomic<numeric>  atomic_numeric;
         typedef std::atomic<unumeric> atomic_unumeric;
 
@@ -41,6 +47,7 @@ namespace iris
 #endif
 
     typedef std::pair<AgentID, AgentID>   IDInterval;
+    typedef std::vector<AgentID>          IDList;
 
     /*
      * Behavior/value types.
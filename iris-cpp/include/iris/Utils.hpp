@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <functional>
 #include <locale>
 #include <sstream>
 #include <string>
@@ -210,6 +211,44 @@ namespace iris
             return type;
         }
 
+        /*!
+         * Runs the specified task on every part of the specified range, one
+         * part per thread, and waits for all of them.
+         *
+         * The range is split into parts of (almost) equal size, and the
+         * calling thread takes the first part itself.
+         *
+         * @param count
+         *        The size of the range.
+         * @param numThreads
+         *        The number of parts.
+         * @param task
+         *        The task, given its part and the part's bounds.
+         */
+        template<class Task>
+        inline void runParts(types::uint64 count, types::uint32 numThreads,
+                             const Task& task)
+        {
+            std::vector<std::thread> threads;
+
+            threads.reserve(numThreads - 1);
+
+            for(types::uint32 i = 1; i < numThreads; i++)
+            {
+                threads.emplace_back(std::cref(task), i,
+                                     count * i / numThreads,
+                                     count * (i + 1) / numThreads);
+            }
+
+            task(static_cast<types::uint32>(0), static_cast<types::uint64>(0),
+                 count / numThreads);
+
+            for(auto& thread : threads)
+            {
+                thread.join();
+            }
+        }
+
         /*!
          * Inserts the specified element into the specified list in sorted
          * order, where "sorted" in this case means in ascending order.
@@ -0,0 +1,84 @@
+/*!
+ * Contains a table for drawing from a discrete distribution in constant time.
+ */
+#ifndef IRIS_ALIAS_TABLE_HPP_
+#define IRIS_ALIAS_TABLE_HPP_
+
+#include <vector>
+
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    namespace gen
+    {
+        /*!
+         * Represents a discrete distribution over [0, n) prepared for
+         * sampling with Walker's alias method (as constructed by Vose).
+         *
+         * Each of the n columns holds the probability of keeping its own
+         * outcome and the outcome (its alias) to fall back on otherwise, so a
+         * draw costs one column lookup no matter how many outcomes there are.
+         */
+        class AliasTable
+        {
+            public:
+                /*! Constructor (an empty table). */
+                AliasTable();
+
+                /*!
+                 * Constructor.
+                 *
+                 * @param weights
+                 *        The relative weight of each outcome, which need not
+                 *        sum to one.
+                 * @throws runtime_error
+                 *         If there are no weights, any is negative, or all
+                 *         are zero.
+                 */
+                explicit AliasTable(
+                    const std::vector<types::fnumeric>& weights);
+
+                /*! Destructor. */
+                ~AliasTable();
+
+                /*!
+                 * Selects the outcome corresponding to the specified uniform
+                 * draw.
+                 *
+                 * @param p
+                 *        A uniform random number in [0, 1].
+                 * @return An outcome in [0, size()).
+                 */
+                types::uint32 choose(types::fnumeric p) const;
+
+                /*!
+                 * Returns the expected outcome of a draw.
+                 *
+                 * @return The mean of the distribution.
+                 */
+                types::fnumeric getMean() const
+                { return m_mean; }
+
+                /*!
+                 * Returns the number of outcomes.
+                 *
+                 * @return The number of columns.
+                 */
+                types::uint32 size() const
+                { return static_cast<types::uint32>(m_alias.size()); }
+
+            private:
+                /*! The outcome each column falls back on. */
+                std::vector<types::uint32>   m_alias;
+
+                /*! The mean of the distribution. */
+                types::fnumeric              m_mean;
+
+                /*! The probability that each column keeps its own outcome. */
+                std::vector<types::fnumeric> m_probability;
+        };
+    }
+}
+
+#endif
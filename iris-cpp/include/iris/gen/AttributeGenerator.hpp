@@ -10,6 +10,8 @@
 #include <vector>
 
 #include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/Random.hpp"
 #include "iris/Types.hpp"
 
 #include "iris/gen/PopulationDispenser.hpp"
@@ -59,7 +61,7 @@ namespace iris
          * @return A list of random discrete variables.
          */
         Uint32List createAttributeList(PopDispensers& dispensers,
-                                       types::mersenne_twister& random);
+                                       CounterRandom& random);
 
         /*!
          * Creates a list of population dispensers that combined are capable of
@@ -109,25 +111,32 @@ namespace iris
          * weighting, no preference, and no heed paid to the location of the
          * agent assigned a certain attribute combination.
          *
+         * Each variable is dispensed to the whole population at once (see
+         * PopulationDispenser::dispenseAll) and written directly into the
+         * packed words of the store, so the result depends on the seed alone
+         * and not on the number of threads.
+         *
          * @param agents
-         *        A collection of agents.
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents in a simulation.
          * @param values
          *        The vector of value factors.
          * @param behaviors
          *        The vector of behavior factors.
-         * @param random
-         *        The random generator to use.
+         * @param seed
+         *        The seed from which every random stream is derived.
+         * @param numThreads
+         *        The number of threads to generate with.
          * @throws runtime_error
          *         If the behavior specification is greater than the values;
          *         that is, if either the length of the vectors are different
          *         or if each behavior element is greater than the corresponding
          *         values element.
          */
-        void generateAttributes(Agent* const agents, AgentID totalAgents,
+        void generateAttributes(AgentStore& agents, AgentID totalAgents,
                                 ValueList values, BehaviorList behaviors,
-                                types::mersenne_twister& random);
+                                types::uint64 seed, types::uint32 numThreads);
 
         /*!
          * Randomly assigns a specified portion of an agent population to be
@@ -138,8 +147,13 @@ namespace iris
          * simulation that are considered to be powerful is given as an input
          * parameter.
          *
+         * The agents are chosen with Floyd's sampling algorithm, which takes
+         * exactly one draw per powerful agent, and are recorded in the power
+         * index of the store (see AgentStore::getPowerfulAgents) as well as
+         * in its power flags.
+         *
          * @param agents
-         *        A collection of agents.
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents in a simulation.
          * @param powerPercent
@@ -151,13 +165,15 @@ namespace iris
          *        population.  This is useful/required for simulations that
          *        use small agent populations and desire correspondingly small
          *        power agent percentages.
-         * @param random
-         *        The random generator to use.
+         * @param seed
+         *        The seed from which the selection stream is derived.
+         * @throws runtime_error
+         *         If more agents are to be powerful than exist.
          */
-        void generatePowerfulAgents(Agent* const agents, AgentID totalAgents,
+        void generatePowerfulAgents(AgentStore& agents, AgentID totalAgents,
                                     types::fnumeric powerPercent,
                                     bool requireAtLeastOne,
-                                    types::mersenne_twister& random);
+                                    types::uint64 seed);
 
         /*!
          * Creates a list of string permutations of the specified variable list.
@@ -0,0 +1,353 @@
+/*!
+ * Contains a parallel builder for the urban social network described in
+ * GraphGenerator.hpp.
+ *
+ * The serial generator wires one agent at a time into per-agent lists, so
+ * every out-going connection pays for a sorted insertion and every
+ * reciprocal connection for a search of another agent's network.  Yet each
+ * agent draws from its own counter-based stream, and an agent that has not
+ * been wired yet has an empty network, which Agent::isNetworkFull counts as
+ * full; so only agents that were wired earlier ever reciprocate, and what an
+ * agent attempts never depends on any other agent.  The builder therefore
+ * draws every attempt up front on several threads, gathers the reciprocal
+ * candidates by target with a parallel sort, and assembles the frozen
+ * networks directly, applying the degree cap of each agent in bulk.
+ *
+ * For populations whose graph does not fit in memory, the same phases may
+ * run a block of agents at a time: the reciprocal candidates of each block
+ * are spilled to disk as a sorted run, and the networks are then assembled
+ * block by block from a merge of those runs into a network file that the
+ * agent store memory-maps.
+ */
+#ifndef IRIS_GRAPH_BUILDER_HPP_
+#define IRIS_GRAPH_BUILDER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "iris/AgentStore.hpp"
+#include "iris/Types.hpp"
+
+#include "iris/gen/AliasTable.hpp"
+#include "iris/gen/GraphGenerator.hpp"
+
+#include "iris/io/reader/CensusReader.hpp"
+
+namespace iris
+{
+    namespace gen
+    {
+        /*!
+         * Builds exactly the same social network as wireGraph, using several
+         * threads.
+         *
+         * Family units are laid out, and the attempts of every agent are
+         * drawn from the same streams in the same order, as by wireGraph, so
+         * the result does not depend on the number of threads either.
+         */
+        class GraphBuilder
+        {
+            public:
+                /*!
+                 * Constructor.
+                 *
+                 * @param totalAgents
+                 *        The total number of agents in the simulation.
+                 * @param census
+                 *        The census data to use.
+                 * @param outConnections
+                 *        The maximum number of non-family connections that
+                 *        may be made.
+                 * @param connectionProb
+                 *        The probability that a non-family connection will be
+                 *        made.
+                 * @param recipProb
+                 *        The probability that a non-family connection is
+                 *        reciprocated.
+                 * @param seed
+                 *        The seed from which each family's and agent's random
+                 *        stream is derived.
+                 */
+                GraphBuilder(AgentID totalAgents,
+                             const io::CensusData& census,
+                             types::uint32 outConnections,
+                             types::fnumeric connectionProb,
+                             types::fnumeric recipProb,
+                             types::uint64 seed);
+
+                /*! Destructor. */
+                ~GraphBuilder();
+
+                /*!
+                 * Wires and freezes the networks of the specified store, and
+                 * fills in the family size of every agent.
+                 *
+                 * @param agents
+                 *        The store of agents, whose networks must be empty
+                 *        and not yet frozen.
+                 * @param numThreads
+                 *        The number of threads to build with.
+                 * @throws runtime_error
+                 *         If the store does not hold the total number of
+                 *         agents, or the number of threads is zero.
+                 */
+                void build(AgentStore& agents, types::uint32 numThreads);
+
+                /*!
+                 * Wires the networks of the specified store a block of agents
+                 * at a time into the specified network file, which the store
+                 * then memory-maps; fills in the family size of every agent.
+                 *
+                 * Besides the columns of the store, only a block's worth of
+                 * networks (plus the sorted runs on disk) is ever held, and
+                 * the result is exactly that of build.
+                 *
+                 * @param agents
+                 *        The store of agents, whose networks must be empty
+                 *        and not yet frozen.
+                 * @param filename
+                 *        The network file to write; its runs are written
+                 *        alongside it and removed once merged.
+                 * @param blockSize
+                 *        The (approximate) number of agents per block.
+                 * @param numThreads
+                 *        The number of threads to build each block with.
+                 * @throws runtime_error
+                 *         If the store does not hold the total number of
+                 *         agents, the block size or number of threads is
+                 *         zero, or a file cannot be written.
+                 */
+                void stream(AgentStore& agents, const std::string& filename,
+                            AgentID blockSize, types::uint32 numThreads);
+
+                /*!
+                 * Lays out the family units of a population.
+                 *
+                 * The size of the k-th family is drawn from a stream keyed by
+                 * k, so every size may be drawn at once; the sizes are then
+                 * prefix-summed into the boundaries of the units, with the
+                 * last unit cut short at the end of the population.
+                 *
+                 * @param sizes
+                 *        The distribution of family sizes (less one).
+                 * @param totalAgents
+                 *        The total number of agents in the simulation.
+                 * @param seed
+                 *        The seed of every family's random stream.
+                 * @param numThreads
+                 *        The number of threads to draw with.
+                 * @param familySizes
+                 *        The family size (as drawn) of every agent.
+                 * @return Every family unit, in order.
+                 */
+                static std::vector<FamilyUnit> layoutFamilies(
+                    const AliasTable& sizes, AgentID totalAgents,
+                    types::uint64 seed, types::uint32 numThreads,
+                    std::vector<types::uint32>& familySizes);
+
+            private:
+                /*!
+                 * Represents a connection that may be reciprocated.
+                 */
+                struct Candidate
+                {
+                    /*! The agent that made the connection. */
+                    AgentID m_from;
+
+                    /*! The agent that may reciprocate. */
+                    AgentID m_to;
+                };
+
+            private:
+                /*!
+                 * Assembles the sorted network of every agent in the
+                 * specified range into the specified list, and records each
+                 * network's size.
+                 *
+                 * @param first
+                 *        The position of the first agent.
+                 * @param last
+                 *        One past the position of the last agent.
+                 * @param targets
+                 *        The list to append the networks to.
+                 * @param sizes
+                 *        The size of every network, by position (relative to
+                 *        the block) plus one.
+                 */
+                void assemble(AgentID first, AgentID last, IDList& targets,
+                              std::vector<types::uint64>& sizes) const;
+
+                /*!
+                 * Assembles the networks of the current block, which must
+                 * have been drawn and had its candidates indexed.
+                 *
+                 * @param numThreads
+                 *        The number of threads to assemble with.
+                 * @param offsets
+                 *        The start of each network in the targets (relative
+                 *        to the block), plus the total.
+                 * @param targets
+                 *        The networks of the block, back to back.
+                 */
+                void assembleBlock(types::uint32 numThreads,
+                                   std::vector<types::uint64>& offsets,
+                                   IDList& targets) const;
+
+                /*!
+                 * Validates the arguments of a build and draws the family
+                 * units.
+                 *
+                 * @param agents
+                 *        The store of agents.
+                 * @param numThreads
+                 *        The number of threads to build with.
+                 * @throws runtime_error
+                 *         If the store does not hold the total number of
+                 *         agents, or the number of threads is zero.
+                 */
+                void begin(AgentStore& agents, types::uint32 numThreads);
+
+                /*!
+                 * Makes the specified range of family units the current block
+                 * and draws the out-going connections of its agents.
+                 *
+                 * @param firstUnit
+                 *        The first family unit.
+                 * @param lastUnit
+                 *        One past the last family unit.
+                 * @param numThreads
+                 *        The number of threads to draw with.
+                 * @param runs
+                 *        The reciprocal candidates drawn by each thread.
+                 */
+                void drawBlock(types::uint64 firstUnit, types::uint64 lastUnit,
+                               types::uint32 numThreads,
+                               std::vector<std::vector<Candidate>>& runs);
+
+                /*!
+                 * Draws every out-going connection of the agents in the
+                 * specified range of family units.
+                 *
+                 * @param firstUnit
+                 *        The first family unit.
+                 * @param lastUnit
+                 *        One past the last family unit.
+                 * @param connections
+                 *        The list to append the connections to.
+                 * @param candidates
+                 *        The list to append the reciprocal candidates to.
+                 */
+                void drawConnections(types::uint64 firstUnit,
+                                     types::uint64 lastUnit,
+                                     IDList& connections,
+                                     std::vector<Candidate>& candidates);
+
+                /*!
+                 * Releases everything held during a build.
+                 */
+                void end();
+
+                /*!
+                 * Returns the largest network the specified agent may have.
+                 *
+                 * @param index
+                 *        The position of the agent.
+                 * @return The upper bound on its network size.
+                 */
+                types::uint32 getUpperBound(AgentID index) const;
+
+                /*!
+                 * Finds where the reciprocal candidates of each agent of the
+                 * current block start.
+                 *
+                 * @param numThreads
+                 *        The number of threads to search with.
+                 */
+                void indexCandidates(types::uint32 numThreads);
+
+                /*!
+                 * Sorts the specified runs of candidates, each by the agent
+                 * that may reciprocate, and merges them into one.
+                 *
+                 * @param runs
+                 *        The runs of candidates (consumed).
+                 * @param numThreads
+                 *        The number of threads to sort with.
+                 */
+                void mergeCandidates(std::vector<std::vector<Candidate>>& runs,
+                                     types::uint32 numThreads);
+
+                /*!
+                 * Orders candidates by the agent that may reciprocate, and
+                 * then by the agent that connected.
+                 *
+                 * @param a
+                 *        The first candidate.
+                 * @param b
+                 *        The second candidate.
+                 * @return Whether the first comes before the second.
+                 */
+                static bool orderByTarget(const Candidate& a,
+                                          const Candidate& b)
+                {
+                    return (a.m_to < b.m_to) ||
+                        (a.m_to == b.m_to && a.m_from < b.m_from);
+                }
+
+            private:
+                /*! The probability that a connection will be made. */
+                types::fnumeric            m_connectionProb;
+
+                /*! The distribution of family sizes (less one). */
+                AliasTable                 m_familyTable;
+
+                /*! The maximum number of non-family connections. */
+                types::uint32              m_outConnections;
+
+                /*! The probability that a connection is reciprocated. */
+                types::fnumeric            m_recipProb;
+
+                /*! The seed of every random stream. */
+                types::uint64              m_seed;
+
+                /*! The total number of agents. */
+                AgentID                    m_totalAgents;
+
+            private:
+                // The following are only valid during a build, and cover
+                // the current block of agents only.
+
+                /*! The first agent of the current block. */
+                AgentID                    m_first;
+
+                /*! One past the last agent of the current block. */
+                AgentID                    m_last;
+
+                /*! Every reciprocal candidate, sorted by (to, from). */
+                std::vector<Candidate>     m_candidates;
+
+                /*!
+                 * The start of each agent's reciprocal candidates, by
+                 * position relative to the block.
+                 */
+                std::vector<types::uint64> m_candidateOffsets;
+
+                /*! The out-going connections of every agent, back to back. */
+                IDList                     m_connections;
+
+                /*!
+                 * The start of each agent's out-going connections, by
+                 * position relative to the block.
+                 */
+                std::vector<types::uint64> m_connectionOffsets;
+
+                /*! The family size drawn for each agent. */
+                const std::vector<types::uint32>* m_familySizes;
+
+                /*! Every family unit, in order. */
+                std::vector<FamilyUnit>    m_units;
+        };
+    }
+}
+
+#endif
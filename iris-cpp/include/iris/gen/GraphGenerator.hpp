@@ -39,6 +39,8 @@
 #include <vector>
 
 #include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/Random.hpp"
 #include "iris/Types.hpp"
 
 #include "iris/io/reader/CensusReader.hpp"
@@ -92,7 +94,7 @@ namespace iris
          * @param unit
          *        The family unit the agent belongs to.
          */
-        void wireFamilyUnit(Agent& agent, const FamilyUnit& unit);
+        void wireFamilyUnit(Agent agent, const FamilyUnit& unit);
         
         /*!
          * Wires the specified list of agents to form an interconnected network
@@ -107,8 +109,12 @@ namespace iris
          * Finally, non-family connections are reciprocal in nature with some
          * additional specified probability.
          *
+         * Family units are laid out by GraphBuilder::layoutFamilies; agents
+         * are then wired one at a time.  This is the serial reference for
+         * GraphBuilder.
+         *
          * @param agents
-         *        The list of agents.
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents in the simulation.
          * @param census
@@ -119,15 +125,16 @@ namespace iris
          *        The probability that a non-family connection will be made.
          * @param recipProb
          *        The probability that a non-family connection is reciprocated.
-         * @param random
-         *        The random number generator to use.
+         * @param seed
+         *        The seed from which each family's and agent's random stream
+         *        is derived.
          */
-        void wireGraph(Agent* const agents, AgentID totalAgents,
+        void wireGraph(AgentStore& agents, AgentID totalAgents,
                        const io::CensusData census,
                        types::uint32 outConnections,
                        types::fnumeric connectionProb,
                        types::fnumeric recipProb,
-                       types::mersenne_twister& random);
+                       types::uint64 seed);
 
         /*!
          * Wires the specified agent randomly to a maximum of other agents.
@@ -141,7 +148,7 @@ namespace iris
          * @param id
          *        The agent to wire.
          * @param agents
-         *        The list of agents.
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents in the simulation.
          * @param outConnections
@@ -155,11 +162,11 @@ namespace iris
          * @param random
          *        The random generator to use.
          */
-        void wireOutGroup(const AgentID& id, Agent* const agents,
+        void wireOutGroup(const AgentID& id, AgentStore& agents,
                           AgentID totalAgents, types::uint32 outConnections,
                           types::fnumeric connectionProb,
                           types::fnumeric recipProb,
-                          types::mersenne_twister& random);
+                          CounterRandom& random);
     }
 }
 
@@ -0,0 +1,89 @@
+/*!
+ * Contains mechanisms to renumber a generated population so that socially
+ * connected agents sit close to each other in memory.
+ *
+ * Family units are generated with contiguous positions, but out-group
+ * friendships connect agents chosen uniformly at random from the whole
+ * population.  Every time an agent looks at its network it therefore touches
+ * cache lines scattered across every column of the store.  Ordering agents by
+ * a traversal of the graph instead keeps most neighbours within a small window
+ * of positions around each agent.
+ */
+#ifndef IRIS_ORDERING_HPP_
+#define IRIS_ORDERING_HPP_
+
+#include <string>
+
+#include "iris/AgentStore.hpp"
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    namespace gen
+    {
+        /*!
+         * The ways in which a population may be renumbered.
+         */
+        enum class Ordering
+        {
+            /*! Agents keep the positions they were generated with. */
+            None,
+
+            /*! Agents are numbered in breadth-first order. */
+            BreadthFirst,
+
+            /*! Agents are numbered in reverse Cuthill-McKee order. */
+            ReverseCuthillMcKee
+        };
+
+        /*!
+         * Computes a new order for the agents of the specified store.
+         *
+         * @param agents
+         *        The store of agents, whose networks must be frozen.
+         * @param ordering
+         *        The ordering to compute.
+         * @return The current position of the agent to place at each new
+         *         position (see AgentStore::renumber).
+         */
+        IDList computeOrder(const AgentStore& agents, Ordering ordering);
+
+        /*!
+         * Numbers every agent in breadth-first order, starting each connected
+         * component from its lowest position and visiting neighbours in
+         * network order.
+         *
+         * @param agents
+         *        The store of agents, whose networks must be frozen.
+         * @return The current position of the agent at each new position.
+         */
+        IDList orderBreadthFirst(const AgentStore& agents);
+
+        /*!
+         * Numbers every agent in reverse Cuthill-McKee order.
+         *
+         * Each connected component is started from its unvisited agent of
+         * lowest degree, neighbours are visited in order of increasing degree,
+         * and the complete order is then reversed, which narrows the band of
+         * positions that each agent's network spans.
+         *
+         * @param agents
+         *        The store of agents, whose networks must be frozen.
+         * @return The current position of the agent at each new position.
+         */
+        IDList orderReverseCuthillMcKee(const AgentStore& agents);
+
+        /*!
+         * Converts the name of an ordering into the ordering itself.
+         *
+         * @param name
+         *        One of "none", "bfs", or "rcm".
+         * @return The matching ordering.
+         * @throws runtime_error
+         *         If the name is not recognized.
+         */
+        Ordering parseOrdering(const std::string& name);
+    }
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include <cmath>
 #include <vector>
 
+#include "iris/Random.hpp"
 #include "iris/Types.hpp"
 
 namespace iris
@@ -34,6 +35,35 @@ namespace iris
                  */
                 void clear();
 
+                /*!
+                 * Dispenses every remaining population at once, in a random
+                 * order, and empties this dispenser.
+                 *
+                 * Rather than choosing one group at a time, the exact quota
+                 * of every group is laid out in order and then shuffled in
+                 * parallel: each position is dealt to one of several buckets,
+                 * the buckets are gathered chunk by chunk, and each bucket is
+                 * then shuffled on its own, which gives a uniformly random
+                 * order in a few linear passes.  Every draw comes from a
+                 * stream keyed by its chunk or bucket, so the order does not
+                 * depend on the number of threads.
+                 *
+                 * @param groups
+                 *        The group of every population, in dispensed order.
+                 * @param seed
+                 *        The seed of every random stream.
+                 * @param stream
+                 *        The identifier of this dispenser's streams (e.g. the
+                 *        index of its variable).
+                 * @param numThreads
+                 *        The number of threads to shuffle with.
+                 * @throws runtime_error
+                 *         If the number of threads is zero.
+                 */
+                void dispenseAll(Uint32List& groups, types::uint64 seed,
+                                 types::uint64 stream,
+                                 types::uint32 numThreads);
+
                 /*!
                  * Returns whether or not there are any groups with available
                  * populations left to be created or used.
@@ -90,7 +120,14 @@ namespace iris
                  * @throws runtime_error
                  *         If the dispenser is empty.
                  */
-                types::uint32 nextGroup(types::mersenne_twister& random);
+                types::uint32 nextGroup(CounterRandom& random);
+
+            public:
+                /*! The number of positions dealt from a single stream. */
+                static const types::uint64 ShuffleChunk = 65536;
+
+                /*! The largest number of buckets a shuffle deals into. */
+                static const types::uint64 ShuffleBuckets = 1024;
 
             private:
                 /*!
@@ -0,0 +1,197 @@
+/*!
+ * Contains the layout of the binary columnar files that every writer may
+ * produce instead of CSV (comma separated value) files.
+ *
+ * A column file is laid out as follows, in the byte order of the machine that
+ * wrote it:
+ *
+ *   1) A ColumnFileHeader.
+ *   2) Every metadata entry, as a key and then a value, where each string is
+ *      its length (a uint32) followed by its characters.
+ *   3) Every column, as its type (a uint32) followed by its name (as above).
+ *   4) Padding up to a multiple of eight bytes.
+ *   5) Any number of blocks, each a BlockHeader followed by the values of
+ *      every column in turn, each padded up to a multiple of eight bytes.
+ *
+ * Within a block, a column of numbers is simply an array of its values.  A
+ * column of text is an array of (uint64) offsets, one past the end of each
+ * row's characters, followed by the characters of every row.  Because every
+ * array starts on a multiple of eight bytes, a mapped file may be read in
+ * place.
+ */
+#ifndef IRIS_COLUMNAR_HPP_
+#define IRIS_COLUMNAR_HPP_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "iris/Types.hpp"
+
+namespace iris
+{
+    namespace io
+    {
+        /*!
+         * The kinds of values a column may hold.
+         */
+        enum class ColumnType : types::uint32
+        {
+            /*! Unsigned 8-bit integers. */
+            UInt8   = 0,
+
+            /*! Unsigned 32-bit integers. */
+            UInt32  = 1,
+
+            /*! Unsigned 64-bit integers. */
+            UInt64  = 2,
+
+            /*! Double precision floating point numbers. */
+            Float64 = 3,
+
+            /*! Strings of characters. */
+            Text    = 4
+        };
+
+        /*!
+         * The forms in which results may be written.
+         */
+        enum class OutputFormat
+        {
+            /*! CSV (comma separated value) text files. */
+            Csv,
+
+            /*! Binary column files. */
+            Binary
+        };
+
+        /*!
+         * Represents the name and type of a single column.
+         */
+        struct ColumnSpec
+        {
+            /*! The name of the column (as in a CSV header). */
+            std::string m_name;
+
+            /*! The kind of values the column holds. */
+            ColumnType  m_type;
+        };
+
+        typedef std::vector<ColumnSpec>                          ColumnList;
+        typedef std::vector<std::pair<std::string, std::string>> Metadata;
+
+        /*!
+         * Represents the start of every column file.
+         */
+        struct ColumnFileHeader
+        {
+            /*! Identifies the file as a column file. */
+            char          m_magic[8];
+
+            /*! The version of the layout. */
+            types::uint32 m_version;
+
+            /*! The number of columns. */
+            types::uint32 m_columns;
+
+            /*! The number of metadata entries. */
+            types::uint32 m_metadata;
+
+            /*! Unused (zero). */
+            types::uint32 m_reserved;
+        };
+
+        /*!
+         * Represents the start of every block of rows in a column file.
+         */
+        struct BlockHeader
+        {
+            /*! The number of rows in the block. */
+            types::uint64 m_rows;
+
+            /*! The number of bytes of column values that follow. */
+            types::uint64 m_bytes;
+        };
+
+        /*!
+         * Creates the header of a column file with the specified number of
+         * columns and metadata entries.
+         *
+         * @param columns
+         *        The number of columns.
+         * @param metadata
+         *        The number of metadata entries.
+         * @return A new header.
+         */
+        ColumnFileHeader createColumnFileHeader(types::uint32 columns,
+                                                types::uint32 metadata);
+
+        /*!
+         * Returns the size of a single value of the specified type, or of a
+         * single offset for text.
+         *
+         * @param type
+         *        The type of column.
+         * @return The width of a value in bytes.
+         */
+        types::uint32 getColumnWidth(ColumnType type);
+
+        /*!
+         * Returns the type of column that holds values of the specified
+         * type.
+         *
+         * @return The type of column.
+         */
+        template<typename T>
+        inline ColumnType getColumnType();
+
+        template<>
+        inline ColumnType getColumnType<types::uint8>()
+        { return ColumnType::UInt8; }
+
+        template<>
+        inline ColumnType getColumnType<types::uint32>()
+        { return ColumnType::UInt32; }
+
+        template<>
+        inline ColumnType getColumnType<types::uint64>()
+        { return ColumnType::UInt64; }
+
+        template<>
+        inline ColumnType getColumnType<types::fnumeric>()
+        { return ColumnType::Float64; }
+
+        /*!
+         * Returns the file extension used by the specified output format.
+         *
+         * @param format
+         *        The output format.
+         * @return An extension, including its leading dot.
+         */
+        std::string getExtension(OutputFormat format);
+
+        /*!
+         * Converts the name of an output format as given on the command line.
+         *
+         * @param name
+         *        One of "csv" or "binary".
+         * @return The output format.
+         * @throws runtime_error
+         *         If the name is not recognized.
+         */
+        OutputFormat parseOutputFormat(const std::string& name);
+
+        /*!
+         * Returns the number of bytes needed to pad the specified size up to
+         * a multiple of eight.
+         *
+         * @param bytes
+         *        The unpadded size.
+         * @return The amount of padding.
+         */
+        inline types::uint64 getPadding(types::uint64 bytes)
+        { return (8 - (bytes % 8)) % 8; }
+    }
+}
+
+#endif
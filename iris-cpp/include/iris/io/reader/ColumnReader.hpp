@@ -0,0 +1,236 @@
+/*!
+ * Contains a mechanism to read binary column files in place, and to convert
+ * them back to CSV (comma separated value) files.
+ */
+#ifndef IRIS_COLUMN_READER_HPP_
+#define IRIS_COLUMN_READER_HPP_
+
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "iris/MappedFile.hpp"
+#include "iris/Span.hpp"
+#include "iris/Types.hpp"
+
+#include "iris/io/Columnar.hpp"
+
+namespace iris
+{
+    namespace io
+    {
+        /*!
+         * Represents a reader of column files (see Columnar.hpp).
+         *
+         * The file is mapped into memory and only its header and the
+         * headers of its blocks are parsed up front; the values themselves
+         * are viewed where they lie.
+         */
+        class ColumnReader
+        {
+            public:
+                /*!
+                 * Constructor.
+                 *
+                 * @param filename
+                 *        The column file to map.
+                 * @throws runtime_error
+                 *         If the file cannot be mapped or is not a column
+                 *         file.
+                 */
+                explicit ColumnReader(const std::string& filename);
+
+                /*!
+                 * Constructor.
+                 *
+                 * @param data
+                 *        The contents of a column file, which must outlive
+                 *        this reader and start on a multiple of eight bytes.
+                 * @param size
+                 *        The size of the contents in bytes.
+                 * @throws runtime_error
+                 *         If the contents are not a column file.
+                 */
+                ColumnReader(const types::uint8* data, std::size_t size);
+
+                /*! Destructor. */
+                ~ColumnReader();
+
+                ColumnReader(const ColumnReader&) = delete;
+                ColumnReader& operator = (const ColumnReader&) = delete;
+
+                /*!
+                 * Returns the number of blocks of rows.
+                 *
+                 * @return The number of blocks.
+                 */
+                std::size_t getBlockCount() const
+                { return m_blocks.size(); }
+
+                /*!
+                 * Returns the number of rows in the specified block.
+                 *
+                 * @param block
+                 *        The index of the block.
+                 * @return The number of rows.
+                 */
+                types::uint64 getBlockRows(std::size_t block) const
+                { return m_blocks.at(block).m_rows; }
+
+                /*!
+                 * Returns the names and types of every column.
+                 *
+                 * @return The list of columns.
+                 */
+                const ColumnList& getColumns() const
+                { return m_columns; }
+
+                /*!
+                 * Returns every metadata entry, in the order written.
+                 *
+                 * @return The metadata.
+                 */
+                const Metadata& getMetadata() const
+                { return m_metadata; }
+
+                /*!
+                 * Returns the value of the specified metadata entry.
+                 *
+                 * @param key
+                 *        The key of the entry.
+                 * @return Its value.
+                 * @throws runtime_error
+                 *         If there is no such entry.
+                 */
+                std::string getMetadata(const std::string& key) const;
+
+                /*!
+                 * Returns the total number of rows in every block.
+                 *
+                 * @return The number of rows.
+                 */
+                types::uint64 getRows() const
+                { return m_rows; }
+
+                /*!
+                 * Returns the text of a single row of the specified column.
+                 *
+                 * @param block
+                 *        The index of the block.
+                 * @param column
+                 *        The index of the column.
+                 * @param row
+                 *        The row, within the block.
+                 * @return The text.
+                 * @throws out_of_range
+                 *         If the row is past the end of the block.
+                 * @throws runtime_error
+                 *         If the column does not hold text.
+                 */
+                std::string getText(std::size_t block, types::uint32 column,
+                                    types::uint64 row) const;
+
+                /*!
+                 * Returns a view of the values of the specified column within
+                 * the specified block.
+                 *
+                 * @param block
+                 *        The index of the block.
+                 * @param column
+                 *        The index of the column.
+                 * @return The values, in place.
+                 * @throws runtime_error
+                 *         If the column does not hold values of this type.
+                 */
+                template<typename T>
+                Span<const T> getValues(std::size_t block,
+                                        types::uint32 column) const
+                {
+                    if(m_columns.at(column).m_type != getColumnType<T>())
+                    {
+                        throw std::runtime_error("Column " +
+                                                 m_columns[column].m_name +
+                                                 " holds another type.");
+                    }
+
+                    const auto& found = m_blocks.at(block);
+
+                    return Span<const T>(
+                        reinterpret_cast<const T*>(found.m_columns[column]),
+                        static_cast<std::size_t>(found.m_rows));
+                }
+
+            private:
+                /*!
+                 * Parses the header and finds every block.
+                 *
+                 * @param name
+                 *        The name of the contents, for errors.
+                 */
+                void parse(const std::string& name);
+
+            private:
+                /*!
+                 * Represents where the values of a single block lie.
+                 */
+                struct Block
+                {
+                    /*! The number of rows. */
+                    types::uint64                    m_rows;
+
+                    /*! The start of the values of every column. */
+                    std::vector<const types::uint8*> m_columns;
+                };
+
+                /*! The blocks of rows, in order. */
+                std::vector<Block> m_blocks;
+
+                /*! The names and types of the columns. */
+                ColumnList         m_columns;
+
+                /*! The contents of the file. */
+                const types::uint8* m_data;
+
+                /*! The mapping of the file, if it was mapped. */
+                MappedFile         m_file;
+
+                /*! The metadata entries. */
+                Metadata           m_metadata;
+
+                /*! The total number of rows. */
+                types::uint64      m_rows;
+
+                /*! The size of the contents in bytes. */
+                std::size_t        m_size;
+        };
+
+        /*!
+         * Converts the specified column file to a CSV (comma separated value)
+         * file, laid out exactly as the CSV writers would have.
+         *
+         * @param input
+         *        The column file to read.
+         * @param output
+         *        The CSV file to write.
+         * @throws runtime_error
+         *         If either file cannot be opened.
+         */
+        void convertToCsv(const std::string& input, const std::string& output);
+
+        /*!
+         * Writes the contents of a column file to a stream in CSV (comma
+         * separated value) form, laid out exactly as the CSV writers would
+         * have.
+         *
+         * @param out
+         *        The stream to write to.
+         * @param reader
+         *        The column file to read.
+         */
+        void outputCsv(std::ostream& out, const ColumnReader& reader);
+    }
+}
+
+#endif
@@ -0,0 +1,254 @@
+/*!
+ * Contains a mechanism to write statistics on a background thread, so that
+ * the simulation never waits on the file system.
+ */
+#ifndef IRIS_ASYNC_STATISTICS_WRITER_HPP_
+#define IRIS_ASYNC_STATISTICS_WRITER_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iris/Types.hpp"
+
+#include "iris/io/Columnar.hpp"
+#include "iris/io/writer/StatisticsWriter.hpp"
+
+namespace iris
+{
+    namespace io
+    {
+        class ColumnWriter;
+
+        /*!
+         * Represents how well a background writer kept up with the
+         * simulation feeding it.
+         */
+        struct QueueMetrics
+        {
+            /*! The number of snapshots handed over. */
+            types::uint64 m_pushes;
+
+            /*! The number of times the queue was full on a hand over. */
+            types::uint64 m_stalls;
+
+            /*! The total time spent waiting on a full queue, in nanoseconds. */
+            types::uint64 m_stallTime;
+
+            /*! The most snapshots waiting to be written at once. */
+            types::uint64 m_peakDepth;
+
+            /*! The number of blocks of text written to the stream. */
+            types::uint64 m_blocks;
+
+            /*! The time spent formatting and writing, in nanoseconds. */
+            types::uint64 m_busyTime;
+        };
+
+        /*!
+         * Represents a writer of statistics on a background thread.
+         *
+         * Each step, the simulation copies the census into the next free
+         * slot of a bounded ring of snapshots and moves on; the writer thread
+         * formats the snapshots in order, gathering text into blocks of at
+         * least BlockBytes before writing them (a column file gathers its own
+         * blocks).  The simulation only waits if every slot is still waiting
+         * to be written, i.e. when the file system falls behind for longer
+         * than the queue can absorb, and every such wait is counted.
+         *
+         * The snapshots are taken by, and written through, the same
+         * statistics writer; only what was fixed when it was initialized is
+         * read on the writer thread.
+         */
+        class AsyncStatisticsWriter
+        {
+            public:
+                /*! The amount of text gathered before it is written. */
+                static const std::size_t BlockBytes = 1 << 20;
+
+            public:
+                /*!
+                 * Constructor; starts the writer thread.
+                 *
+                 * @param statistics
+                 *        The census to take snapshots of and write with.
+                 * @param out
+                 *        The stream to write to.
+                 * @param capacity
+                 *        The most snapshots waiting to be written.
+                 * @throws runtime_error
+                 *         If the capacity is zero.
+                 */
+                AsyncStatisticsWriter(StatisticsWriter& statistics,
+                                      std::ostream& out,
+                                      types::uint32 capacity);
+
+                /*!
+                 * Constructor; starts the writer thread.
+                 *
+                 * @param statistics
+                 *        The census to take snapshots of and write with.
+                 * @param out
+                 *        The column file to write to.
+                 * @param capacity
+                 *        The most snapshots waiting to be written.
+                 * @throws runtime_error
+                 *         If the capacity is zero.
+                 */
+                AsyncStatisticsWriter(StatisticsWriter& statistics,
+                                      ColumnWriter& out,
+                                      types::uint32 capacity);
+
+                /*!
+                 * Destructor; writes whatever is waiting and stops the writer
+                 * thread, ignoring any error.
+                 */
+                ~AsyncStatisticsWriter();
+
+                AsyncStatisticsWriter(const AsyncStatisticsWriter&) = delete;
+                AsyncStatisticsWriter& operator = (
+                    const AsyncStatisticsWriter&) = delete;
+
+                /*!
+                 * Writes whatever is waiting, flushes the output, and stops
+                 * the writer thread.
+                 *
+                 * @throws runtime_error
+                 *         If anything could not be written.
+                 */
+                void close();
+
+                /*!
+                 * Returns the capacity of the queue.
+                 *
+                 * @return The most snapshots waiting to be written.
+                 */
+                types::uint32 getCapacity() const
+                { return static_cast<types::uint32>(m_slots.size()); }
+
+                /*!
+                 * Returns how well the writer has kept up so far.
+                 *
+                 * @return The metrics of the queue.
+                 */
+                QueueMetrics getMetrics() const;
+
+                /*!
+                 * Takes a snapshot of the current census and hands it to the
+                 * writer thread, waiting only if the queue is full.
+                 *
+                 * @param currentTime
+                 *        The current time step.
+                 * @throws runtime_error
+                 *         If the writer has been closed, or if anything
+                 *         could not be written.
+                 */
+                void push(types::uint64 currentTime);
+
+            private:
+                /*! Writes every snapshot handed over until closed. */
+                void run();
+
+                /*! Writes the text gathered so far, if any, to the stream. */
+                void writeBlock();
+
+            private:
+                /*! The text gathered for the next block. */
+                std::ostringstream                     m_block;
+
+                /*! Whether the writer has been asked to stop. */
+                bool                                   m_closing;
+
+                /*! The column file to write to, if any. */
+                ColumnWriter*                          m_columns;
+
+                /*! Signals that a snapshot has been written. */
+                std::condition_variable                m_consumed;
+
+                /*! The number of snapshots waiting to be written. */
+                types::uint32                          m_count;
+
+                /*! The first error on the writer thread, if any. */
+                std::exception_ptr                     m_error;
+
+                /*! The slot of the next snapshot to write. */
+                types::uint32                          m_head;
+
+                /*! The metrics of the queue. */
+                QueueMetrics                           m_metrics;
+
+                /*! Guards the queue, the error, and the metrics. */
+                mutable std::mutex                     m_mutex;
+
+                /*! The stream to write to, if any. */
+                std::ostream*                          m_out;
+
+                /*! Signals that a snapshot has been handed over. */
+                std::condition_variable                m_produced;
+
+                /*! The ring of snapshots. */
+                std::vector<StatisticsWriter::Snapshot> m_slots;
+
+                /*! The census to take snapshots of and write with. */
+                StatisticsWriter&                      m_statistics;
+
+                /*! The writer thread. */
+                std::thread                            m_thread;
+        };
+
+        /*!
+         * Writes the metrics of a background writer to the specified file.
+         *
+         * @param filename
+         *        The name of the file to write to.
+         * @param metrics
+         *        The metrics to write.
+         * @param format
+         *        Whether to write a CSV or a binary column file.
+         * @param metadata
+         *        Information about the run, kept by a binary column file.
+         */
+        void writeQueueMetrics(const std::string& filename,
+                               const QueueMetrics& metrics,
+                               OutputFormat format = OutputFormat::Csv,
+                               const Metadata& metadata = Metadata());
+
+        /*!
+         * Returns the columns written by outputQueueMetrics.
+         *
+         * @return The list of columns.
+         */
+        ColumnList getQueueColumns();
+
+        /*!
+         * Writes the metrics of a background writer to the specified stream.
+         *
+         * @param out
+         *        The stream to write to.
+         * @param metrics
+         *        The metrics to write.
+         */
+        void outputQueueMetrics(std::ostream& out,
+                                const QueueMetrics& metrics);
+
+        /*!
+         * Writes the metrics of a background writer to the specified column
+         * file.
+         *
+         * @param out
+         *        The column file to write to (see getQueueColumns).
+         * @param metrics
+         *        The metrics to write.
+         */
+        void outputQueueMetrics(ColumnWriter& out,
+                                const QueueMetrics& metrics);
+    }
+}
+
+#endif
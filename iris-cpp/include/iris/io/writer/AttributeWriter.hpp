@@ -9,12 +9,16 @@
 
 #include "iris/Types.hpp"
 
+#include "iris/io/Columnar.hpp"
+
 namespace iris
 {
-    class Agent;
+    class AgentStore;
     
     namespace io
     {
+        class ColumnWriter;
+
         /*!
          * Writes the attributes of all agents to the specified file, one
          * agent per line.
@@ -23,15 +27,28 @@ namespace iris
          * supply vertex information.
          *
          * @param filename
-         *        The name of the CSV file to write to.
+         *        The name of the file to write to.
          * @param agents
-         *        The array of agents.
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents present.
+         * @param format
+         *        Whether to write a CSV or a binary column file.
+         * @param metadata
+         *        Information about the run, kept by a binary column file.
          */
         void writeAttributes(const std::string& filename,
-                             Agent* const agents,
-                             AgentID totalAgents);
+                             const AgentStore& agents,
+                             AgentID totalAgents,
+                             OutputFormat format = OutputFormat::Csv,
+                             const Metadata& metadata = Metadata());
+
+        /*!
+         * Returns the columns written by outputAttributes.
+         *
+         * @return The list of columns.
+         */
+        ColumnList getAttributeColumns();
 
         /*!
          * Writes the attributes of all agents to the specified stream, one
@@ -40,11 +57,25 @@ namespace iris
          * @param out
          *        The stream to write to.
          * @param agents
-         *        The array of agents.
+         *        The store of agents.
+         * @param totalAgents
+         *        The total number of agents present.
+         */
+        void outputAttributes(std::ostream& out, const AgentStore& agents,
+                              AgentID totalAgents);
+
+        /*!
+         * Writes the attributes of all agents to the specified column file,
+         * one agent per row.
+         *
+         * @param out
+         *        The column file to write to (see getAttributeColumns).
+         * @param agents
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents present.
          */
-        void outputAttributes(std::ostream& out, Agent* const agents,
+        void outputAttributes(ColumnWriter& out, const AgentStore& agents,
                               AgentID totalAgents);
     }
 }
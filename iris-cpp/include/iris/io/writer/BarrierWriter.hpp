@@ -0,0 +1,71 @@
+#ifndef IRIS_BARRIER_WRITER_HPP_
+#define IRIS_BARRIER_WRITER_HPP_
+
+#include <ostream>
+#include <vector>
+
+#include "iris/Types.hpp"
+
+#include "iris/io/Columnar.hpp"
+
+namespace iris
+{
+    namespace io
+    {
+        class ColumnWriter;
+
+        /*!
+         * Returns the columns of the barrier wait file, which match its CSV
+         * header.
+         *
+         * @param numThreads
+         *        The number of worker threads.
+         * @return The list of columns.
+         */
+        ColumnList getBarrierColumns(types::uint32 numThreads);
+
+        /*!
+         * Writes the header of the barrier wait file, with one column per
+         * worker thread, to the specified stream.
+         *
+         * @param out
+         *        The stream to write to.
+         * @param numThreads
+         *        The number of worker threads.
+         */
+        void writeBarrierHeader(std::ostream& out, types::uint32 numThreads);
+
+        /*!
+         * Writes the time each worker spent waiting for the others to finish
+         * stepping during a single time step to the specified stream.
+         *
+         * Since every worker waits for the slowest one, a large spread across
+         * a row indicates that the agents are unevenly divided.
+         *
+         * @param out
+         *        The stream to write to.
+         * @param time
+         *        The time step the waits were recorded in.
+         * @param waits
+         *        The wait of each worker, in nanoseconds.
+         */
+        void writeBarrierWaits(std::ostream& out, types::uint64 time,
+                               const std::vector<types::uint64>& waits);
+
+        /*!
+         * Writes the time each worker spent waiting for the others to finish
+         * stepping during a single time step to the specified column file.
+         *
+         * @param out
+         *        The column file to write to (see getBarrierColumns).
+         * @param time
+         *        The time step the waits were recorded in.
+         * @param waits
+         *        The wait of each worker, in nanoseconds.
+         */
+        void writeBarrierWaits(ColumnWriter& out, types::uint64 time,
+                               const std::vector<types::uint64>& waits);
+    }
+}
+
+#endif
@@ -0,0 +1,172 @@
+/*!
+ * Contains a mechanism to write rows of typed values to a binary column file.
+ */
+#ifndef IRIS_COLUMN_WRITER_HPP_
+#define IRIS_COLUMN_WRITER_HPP_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "iris/Types.hpp"
+
+#include "iris/io/Columnar.hpp"
+
+namespace iris
+{
+    namespace io
+    {
+        /*!
+         * Represents a writer of column files (see Columnar.hpp).
+         *
+         * Values are given a row at a time, in the order of the columns, and
+         * are gathered column by column in memory.  Once they take up at
+         * least BlockBytes, or when flushed, the gathered rows are written
+         * out as a single block, so neither the number of rows nor how they
+         * are produced has to be known in advance.
+         */
+        class ColumnWriter
+        {
+            public:
+                /*! The amount of buffered values that triggers a block. */
+                static const std::size_t BlockBytes = 4 << 20;
+
+            public:
+                /*!
+                 * Constructor; writes the header, metadata, and columns.
+                 *
+                 * @param out
+                 *        The (binary) stream to write to.
+                 * @param columns
+                 *        The names and types of the columns.
+                 * @param metadata
+                 *        Any information about the run, as key/value pairs.
+                 */
+                ColumnWriter(std::ostream& out, const ColumnList& columns,
+                             const Metadata& metadata);
+
+                /*! Destructor (does not flush). */
+                ~ColumnWriter();
+
+                ColumnWriter(const ColumnWriter&) = delete;
+                ColumnWriter& operator = (const ColumnWriter&) = delete;
+
+                /*!
+                 * Finishes the current row.
+                 *
+                 * @throws runtime_error
+                 *         If a value is missing for any column.
+                 */
+                void endRow();
+
+                /*!
+                 * Writes every finished row as a block, if there are any, and
+                 * flushes the stream.
+                 */
+                void flush();
+
+                /*!
+                 * Returns the columns of this writer.
+                 *
+                 * @return The list of columns.
+                 */
+                const ColumnList& getColumns() const
+                { return m_columns; }
+
+                /*!
+                 * Returns the number of rows finished so far.
+                 *
+                 * @return The number of rows.
+                 */
+                types::uint64 getRows() const
+                { return m_rows; }
+
+                /*!
+                 * Gives the next column of the current row a floating point
+                 * value.
+                 *
+                 * @param value
+                 *        The value to give.
+                 * @return This writer.
+                 * @throws runtime_error
+                 *         If the column does not hold floating point values.
+                 */
+                ColumnWriter& putReal(types::fnumeric value);
+
+                /*!
+                 * Gives the next column of the current row a string value.
+                 *
+                 * @param value
+                 *        The value to give.
+                 * @return This writer.
+                 * @throws runtime_error
+                 *         If the column does not hold text.
+                 */
+                ColumnWriter& putText(const std::string& value);
+
+                /*!
+                 * Gives the next column of the current row an integer value,
+                 * stored at the width of the column.
+                 *
+                 * @param value
+                 *        The value to give.
+                 * @return This writer.
+                 * @throws runtime_error
+                 *         If the column does not hold integers, or the value
+                 *         does not fit in it.
+                 */
+                ColumnWriter& putUnsigned(types::uint64 value);
+
+            private:
+                /*!
+                 * Appends the specified bytes to the next column, after
+                 * checking that it has the specified type.
+                 *
+                 * @param type
+                 *        The type the value was given as.
+                 * @param bytes
+                 *        The value itself.
+                 * @param size
+                 *        The size of the value in bytes.
+                 */
+                void append(ColumnType type, const void* bytes,
+                            std::size_t size);
+
+                /*!
+                 * Writes the specified string, prefixed by its length.
+                 *
+                 * @param value
+                 *        The string to write.
+                 */
+                void writeString(const std::string& value);
+
+            private:
+                /*! The number of bytes gathered since the last block. */
+                std::size_t                             m_buffered;
+
+                /*! The names and types of the columns. */
+                ColumnList                              m_columns;
+
+                /*! The index of the column to give a value to next. */
+                types::uint32                           m_next;
+
+                /*! The stream to write to. */
+                std::ostream&                           m_out;
+
+                /*! The rows gathered since the last block. */
+                types::uint64                           m_pending;
+
+                /*! The number of rows finished. */
+                types::uint64                           m_rows;
+
+                /*! The offset past each row of every text column. */
+                std::vector<std::vector<types::uint64>> m_textEnds;
+
+                /*! The values gathered for every column. */
+                std::vector<std::vector<char>>          m_values;
+        };
+    }
+}
+
+#endif
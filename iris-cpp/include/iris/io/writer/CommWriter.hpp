@@ -6,28 +6,45 @@
 
 #include "iris/Types.hpp"
 
+#include "iris/io/Columnar.hpp"
+
 namespace iris
 {
-    class Agent;
+    class AgentStore;
     
     namespace io
     {
+        class ColumnWriter;
+
         /*!
          * Writes the communication graph that comprises the history of each
          * agent's interaction(s) with each other up to the current time step
          * to the specified file.
          *
          * @param filename
-         *        The name of the CSV file to write to.
+         *        The name of the file to write to.
          * @param agents
-         *        The array of agents.
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents present.
          * @param time
          *        The current time step.
+         * @param format
+         *        Whether to write a CSV or a binary column file.
+         * @param metadata
+         *        Information about the run, kept by a binary column file.
+         */
+        void writeComm(const std::string& filename, const AgentStore& agents,
+                       AgentID totalAgents, types::uint64 time,
+                       OutputFormat format = OutputFormat::Csv,
+                       const Metadata& metadata = Metadata());
+
+        /*!
+         * Returns the columns written by outputComm.
+         *
+         * @return The list of columns.
          */
-        void writeComm(const std::string& filename, Agent* const agents,
-                       AgentID totalAgents, types::uint64 time);
+        ColumnList getCommColumns();
 
         /*!
          * Writes the communication graph that comprises the history of each
@@ -37,13 +54,30 @@ namespace iris
          * @param out
          *        The stream to write to.
          * @param agents
-         *        The array of agents.
+         *        The store of agents.
+         * @param totalAgents
+         *        The total number of agents present.
+         * @param time
+         *        The current time step.
+         */
+        void outputComm(std::ostream& out, const AgentStore& agents,
+                        AgentID totalAgents, types::uint64 time);
+
+        /*!
+         * Writes the communication graph that comprises the history of each
+         * agent's interaction(s) with each other up to the current time step
+         * to the specified column file.
+         *
+         * @param out
+         *        The column file to write to (see getCommColumns).
+         * @param agents
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents present.
          * @param time
          *        The current time step.
          */
-        void outputComm(std::ostream& out, Agent* const agents,
+        void outputComm(ColumnWriter& out, const AgentStore& agents,
                         AgentID totalAgents, types::uint64 time);
     }
 }
@@ -9,27 +9,43 @@
 
 #include "iris/Types.hpp"
 
+#include "iris/io/Columnar.hpp"
+
 namespace iris
 {
-    class Agent;
+    class AgentStore;
     
     namespace io
     {
+        class ColumnWriter;
 
         /*!
          * Writes the social network created from the specified collection of
          * agents to a CSV (comma separated value) file.
          *
          * @param filename
-         *        The name of the CSV file to write to.
+         *        The name of the file to write to.
          * @param agents
-         *        The array of agents.
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents present.
+         * @param format
+         *        Whether to write a CSV or a binary column file.
+         * @param metadata
+         *        Information about the run, kept by a binary column file.
          */
         void writeNetwork(const std::string& filename,
-                          iris::Agent* const agents,
-                          AgentID totalAgents);
+                          const AgentStore& agents,
+                          AgentID totalAgents,
+                          OutputFormat format = OutputFormat::Csv,
+                          const Metadata& metadata = Metadata());
+
+        /*!
+         * Returns the columns written by outputNetwork.
+         *
+         * @return The list of columns.
+         */
+        ColumnList getNetworkColumns();
         
         /*!
          * Writes the social network represented by the specified collection of
@@ -38,11 +54,25 @@ namespace iris
          * @param out
          *        The stream to write to.
          * @param agents
-         *        The array of agents.
+         *        The store of agents.
+         * @param totalAgents
+         *        The total number of agents present.
+         */
+        void outputNetwork(std::ostream& out, const AgentStore& agents,
+                           AgentID totalAgents);
+
+        /*!
+         * Writes the social network represented by the specified collection of
+         * agents to a column file, one edge per row.
+         *
+         * @param out
+         *        The column file to write to (see getNetworkColumns).
+         * @param agents
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents present.
          */
-        void outputNetwork(std::ostream& out, iris::Agent* const agents,
+        void outputNetwork(ColumnWriter& out, const AgentStore& agents,
                            AgentID totalAgents);
     }
 }
@@ -6,25 +6,53 @@
 
 #include "iris/Types.hpp"
 
+#include "iris/io/Columnar.hpp"
+
 namespace iris
 {
-    class Agent;
+    class AgentStore;
+    struct Interaction;
     
     namespace io
     {
+        class ColumnWriter;
+
+        /*!
+         * Computes the probability that one agent influenced another over the
+         * course of their interactions.
+         *
+         * @param comm
+         *        The interaction counters of a pair of agents.
+         * @return The influence probability.
+         */
+        types::fnumeric computePower(const Interaction& comm);
+
         /*!
          * Writes the graph of interactions between agents whose edges
          * represent power to the specified file.
          *
          * @param filename
-         *        The name of the CSV file to write to.
+         *        The name of the file to write to.
          * @param agents
-         *        The array of agents.
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents present.
+         * @param format
+         *        Whether to write a CSV or a binary column file.
+         * @param metadata
+         *        Information about the run, kept by a binary column file.
+         */
+        void writePower(const std::string& filename, const AgentStore& agents,
+                        AgentID totalAgents,
+                        OutputFormat format = OutputFormat::Csv,
+                        const Metadata& metadata = Metadata());
+
+        /*!
+         * Returns the columns written by outputPower.
+         *
+         * @return The list of columns.
          */
-        void writePower(const std::string& filename, Agent* const agents,
-                        AgentID totalAgents);
+        ColumnList getPowerColumns();
 
         /*!
          * Writes the graph of interactions between agents whose edges
@@ -33,11 +61,25 @@ namespace iris
          * @param out
          *        The stream to write to.
          * @param agents
-         *        The array of agents.
+         *        The store of agents.
+         * @param totalAgents
+         *        The total number of agents present.
+         */
+        void outputPower(std::ostream& out, const AgentStore& agents,
+                         AgentID totalAgents);
+
+        /*!
+         * Writes the graph of interactions between agents whose edges
+         * represent power to the specified column file.
+         *
+         * @param out
+         *        The column file to write to (see getPowerColumns).
+         * @param agents
+         *        The store of agents.
          * @param totalAgents
          *        The total number of agents present.
          */
-        void outputPower(std::ostream& out, Agent* const agents,
+        void outputPower(ColumnWriter& out, const AgentStore& agents,
                          AgentID totalAgents);
     }
 }
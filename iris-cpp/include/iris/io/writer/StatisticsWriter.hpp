@@ -4,19 +4,25 @@
 #include <locale>
 #include <sstream>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "iris/AttributeCodec.hpp"
+#include "iris/Span.hpp"
 #include "iris/Types.hpp"
 
 #include "iris/gen/AttributeGenerator.hpp"
 
+#include "iris/io/Columnar.hpp"
+
 namespace iris
 {
-    class Agent;
+    class AgentStore;
+    class DeltaBuffer;
     
     namespace io
     {
+        class ColumnWriter;
+
         /*!
          * Returns the current date and time in string form.
          *
@@ -50,12 +56,77 @@ namespace iris
         /*!
          * Represents a mechanism for managing and writing certain kinds of
          * statistics to a stream repeatedly over the lifespan of a simulation.
+         *
+         * The census of behaviors is kept as a dense array of counts, one per
+         * permutation, indexed by the permutation's mixed-radix number (the
+         * first behavior being the most significant digit); this is also the
+         * order in which the permutations are written.  Packed behavior words
+         * of up to LookupBits bits are mapped to that index through a table,
+         * so counting the population is a single pass over integers, split
+         * into per-thread partial histograms for large populations.
+         *
+         * Alternatively, the census may be counted once and then kept up to
+         * date from the behavior transitions and privilege tallied by each
+         * step, which costs as much as the number of changes rather than the
+         * number of agents; it should be verified against a full count every
+         * so often to make sure the two have not drifted apart.
+         *
+         * When there are far more permutations than agents, the census may
+         * instead be kept sparse: only the permutations held by at least one
+         * agent are recorded (by index, in order) and the permutations are
+         * never listed.  Each thread sorts the indices of its share of the
+         * population and counts the runs, and the runs of every thread are
+         * then combined.  A sparse census is written in long form, one row
+         * per occupied permutation (or only the most common ones, if
+         * limited).  When kept up to date, a sparse census gathers the
+         * changes of a step and sorts them into itself only when read.
          */
         class StatisticsWriter
         {
-            public:             
-                typedef std::unordered_map<std::string, types::uint32> CensusMap;
-                
+            public:
+                /*!
+                 * Represents the number of agents that hold a single
+                 * permutation of behaviors.
+                 */
+                struct CensusEntry
+                {
+                    /*! The index of the permutation. */
+                    types::uint64 m_index;
+
+                    /*! The number of agents that hold it. */
+                    types::uint64 m_count;
+                };
+
+                typedef std::vector<CensusEntry> SparseCensus;
+
+                /*!
+                 * Represents a copy of everything written for a single step,
+                 * so that it may be written later (or on another thread)
+                 * while the census moves on.
+                 */
+                struct Snapshot
+                {
+                    /*! The time step. */
+                    types::uint64              m_time;
+
+                    /*! The total privilege. */
+                    types::uint64              m_privilege;
+
+                    /*! The count of every permutation, if dense. */
+                    std::vector<types::uint64> m_counts;
+
+                    /*! The permutations to write, in order, if sparse. */
+                    SparseCensus               m_entries;
+                };
+
+            public:
+                /*! The widest behavior word mapped through a table. */
+                static const types::uint32 LookupBits       = 16;
+
+                /*! The fewest agents worth counting on another thread. */
+                static const AgentID       MinAgentsPerPart = 65536;
+
+            public:
                 /*! Constructor. */
                 StatisticsWriter();
 
@@ -70,6 +141,74 @@ namespace iris
                  */
                 void clear();
 
+                /*!
+                 * Counts the total amount of privilege possessed by all agents
+                 * in a simulation and their current behavior composition,
+                 * replacing the census.
+                 *
+                 * @param agents
+                 *        The store of agents.
+                 * @param totalAgents
+                 *        The total number of agents in a simulation.
+                 * @throws runtime_error
+                 *         If the store encodes behaviors differently.
+                 */
+                void count(const AgentStore& agents, AgentID totalAgents);
+
+                /*!
+                 * Returns the columns written to a column file, which match
+                 * the CSV header.
+                 *
+                 * @return The list of columns.
+                 */
+                ColumnList getColumns() const;
+
+                /*!
+                 * Returns the number of agents counted with each permutation
+                 * of behaviors, as last counted or updated.
+                 *
+                 * This is empty if the census is sparse.
+                 *
+                 * @return The census, in the order of the permutations.
+                 */
+                const std::vector<types::uint64>& getCensus() const
+                { return m_census; }
+
+                /*!
+                 * Returns the number of agents counted with each occupied
+                 * permutation of behaviors, as last counted or updated.
+                 *
+                 * This is empty unless the census is sparse.  Any changes not
+                 * yet applied are applied first.
+                 *
+                 * @return The sparse census, in the order of the permutations.
+                 */
+                const SparseCensus& getOccupied()
+                {
+                    this->settleOccupied();
+                    return m_occupied;
+                }
+
+                /*!
+                 * Returns the total amount of privilege, as last counted or
+                 * updated.
+                 *
+                 * @return The total privilege.
+                 */
+                types::uint64 getTotalPrivilege() const
+                { return m_totalPrivilege; }
+
+                /*!
+                 * Returns the index of the permutation held by the specified
+                 * packed behavior word.
+                 *
+                 * @param word
+                 *        The packed behaviors to look up.
+                 * @return The position of its permutation, or the number of
+                 * permutations if a behavior is out of range.
+                 */
+                types::uint64 getIndex(types::attribute_word word) const;
+
                 /*!
                  * Discovers all possible permutations of the specified behavior
                  * variable(s) and prepares the census collection for quick
@@ -77,8 +216,126 @@ namespace iris
                  *
                  * @param behavior
                  *        The list of behavior(s) to use.
+                 * @param numThreads
+                 *        The most threads to count the census with.
+                 * @throws runtime_error
+                 *         If the number of threads is zero.
+                 */
+                void initialize(const Uint32List& behavior,
+                                types::uint32 numThreads);
+
+                /*!
+                 * Prepares a sparse census of the specified behavior
+                 * variable(s), without listing their permutations.
+                 *
+                 * @param behavior
+                 *        The list of behavior(s) to use.
+                 * @param numThreads
+                 *        The most threads to count the census with.
+                 * @param limit
+                 *        The most permutations to write per step (the most
+                 *        common ones), or zero to write every occupied one.
+                 * @throws runtime_error
+                 *         If the number of threads is zero.
+                 */
+                void initializeSparse(const Uint32List& behavior,
+                                      types::uint32 numThreads,
+                                      types::uint64 limit);
+
+                /*!
+                 * Returns whether or not only occupied permutations are
+                 * counted.
+                 *
+                 * @return Whether the census is sparse.
+                 */
+                bool isSparse() const
+                { return m_sparse; }
+
+                /*!
+                 * Copies everything that would be written for the current
+                 * census into the specified snapshot, reusing its storage.
+                 *
+                 * @param into
+                 *        The snapshot to fill.
+                 * @param currentTime
+                 *        The current time step.
+                 */
+                void snapshot(Snapshot& into, types::uint64 currentTime);
+
+                /*!
+                 * Adjusts the census by the behavior transitions and privilege
+                 * tallied in the specified buffer during a step.
+                 *
+                 * @param deltas
+                 *        The changes of one thread.
+                 */
+                void update(const DeltaBuffer& deltas);
+
+                /*!
+                 * Counts the census in full and replaces the current one with
+                 * it, reporting whether the two agreed.
+                 *
+                 * @param agents
+                 *        The store of agents.
+                 * @param totalAgents
+                 *        The total number of agents in a simulation.
+                 * @return Whether the census had not drifted.
+                 * @throws runtime_error
+                 *         If the store encodes behaviors differently.
+                 */
+                bool verify(const AgentStore& agents, AgentID totalAgents);
+
+                /*!
+                 * Writes the current census to the specified stream as a
+                 * single row, or as one row per written permutation if the
+                 * census is sparse.
+                 *
+                 * @param out
+                 *        The stream to write to.
+                 * @param currentTime
+                 *        The current time step.
+                 */
+                void write(std::ostream& out, types::uint64 currentTime);
+
+                /*!
+                 * Writes the current census to the specified column file, in
+                 * the same rows as a CSV file (see getColumns).
+                 *
+                 * @param out
+                 *        The column file to write to.
+                 * @param currentTime
+                 *        The current time step.
                  */
-                void initialize(const Uint32List& behavior);
+                void write(ColumnWriter& out, types::uint64 currentTime);
+
+                /*!
+                 * Writes the specified snapshot to the specified stream, just
+                 * as the census it was taken from would have been written.
+                 *
+                 * This only reads what was fixed by initialization, so it may
+                 * be called on another thread while the census is counted.
+                 *
+                 * @param out
+                 *        The stream to write to.
+                 * @param snapshot
+                 *        The snapshot to write.
+                 */
+                void write(std::ostream& out, const Snapshot& snapshot) const;
+
+                /*!
+                 * Writes the specified snapshot to the specified column file,
+                 * just as the census it was taken from would have been
+                 * written.
+                 *
+                 * This only reads what was fixed by initialization, so it may
+                 * be called on another thread while the census is counted.
+                 *
+                 * @param out
+                 *        The column file to write to.
+                 * @param snapshot
+                 *        The snapshot to write.
+                 */
+                void write(ColumnWriter& out, const Snapshot& snapshot) const;
 
                 /*!
                  * Writes a CSV (comma separated value) header concerning the
@@ -99,24 +356,172 @@ namespace iris
                  * @param out
                  *        The stream to write to.
                  * @param agents
-                 *        The list of agents.
+                 *        The store of agents.
                  * @param totalAgents
                  *        The total number of agents in a simulation.
                  * @aram currentTime
                  *       The current time step.
+                 * @throws runtime_error
+                 *         If the store encodes behaviors differently.
                  */
                 void writeStatistics(std::ostream& out,
-                                     Agent* const agents,
+                                     const AgentStore& agents,
                                      AgentID totalAgents,
                                      types::uint64 currentTime);
                 
             private:
                 /*!
-                * Represents the current number of agents that match a particular behavior permutation.
-                *
-                * This map is cleared (reset to zero) before every write (before processing).
-                */
-                CensusMap         m_census;
+                 * Appends the digits of the specified permutation, as they
+                 * appear in a header, to the specified text.
+                 *
+                 * @param text
+                 *        The text to append to.
+                 * @param index
+                 *        The index of the permutation.
+                 */
+                void appendPermutation(std::string& text,
+                                       types::uint64 index) const;
+
+                /*!
+                 * Counts the dense census of every part of the population.
+                 *
+                 * @param agents
+                 *        The store of agents.
+                 * @param totalAgents
+                 *        The total number of agents in a simulation.
+                 * @param parts
+                 *        The number of threads to count with.
+                 */
+                void countDense(const AgentStore& agents, AgentID totalAgents,
+                                types::uint32 parts);
+
+                /*!
+                 * Counts the sparse census of every part of the population.
+                 *
+                 * @param agents
+                 *        The store of agents.
+                 * @param totalAgents
+                 *        The total number of agents in a simulation.
+                 * @param parts
+                 *        The number of threads to count with.
+                 */
+                void countSparse(const AgentStore& agents,
+                                 AgentID totalAgents, types::uint32 parts);
+
+                /*!
+                 * Prepares the encoding, strides, and lookup table shared by
+                 * either kind of census.
+                 *
+                 * @param behavior
+                 *        The list of behavior(s) to use.
+                 * @param numThreads
+                 *        The most threads to count the census with.
+                 * @throws runtime_error
+                 *         If the number of threads is zero.
+                 */
+                void prepare(const Uint32List& behavior,
+                             types::uint32 numThreads);
+
+                /*!
+                 * Applies every change to the sparse census gathered since
+                 * it was last read, sorting them by permutation and merging
+                 * them with the census in a single pass.
+                 */
+                void settleOccupied();
+
+                /*!
+                 * Chooses the occupied permutations to write, which are all
+                 * of them unless limited.
+                 *
+                 * @return The permutations to write, in order.
+                 */
+                Span<const CensusEntry> selectWritten();
+
+                /*!
+                 * Returns the index of the permutation held by the specified
+                 * packed behavior word, through the table if there is one.
+                 *
+                 * @param word
+                 *        The packed behaviors to look up.
+                 * @return The position of its permutation.
+                 */
+                types::uint64 lookUp(types::attribute_word word) const
+                {
+                    return m_lookup.empty() ? this->getIndex(word) :
+                        m_lookup[word];
+                }
+
+            private:
+                /*!
+                 * Represents a change in the number of agents that hold a
+                 * single permutation of behaviors.
+                 */
+                struct CensusChange
+                {
+                    /*! The index of the permutation. */
+                    types::uint64 m_index;
+
+                    /*! The number of agents gained (or lost). */
+                    types::int64  m_change;
+                };
+
+                /*!
+                 * Represents the current number of agents that match each
+                 * behavior permutation, plus a final count of agents whose
+                 * behaviors are out of range (never written).
+                 *
+                 * This is cleared (reset to zero) before every write (before
+                 * processing).
+                 */
+                std::vector<types::uint64>  m_census;
+
+                /*!
+                 * The changes to the sparse census since it was last read,
+                 * in no particular order.
+                 */
+                std::vector<CensusChange>   m_changes;
+
+                /*! The encoding of the behaviors being counted. */
+                AttributeCodec              m_codec;
+
+                /*!
+                 * The number of permutations, which is also the index given to
+                 * behaviors that are out of range.
+                 */
+                types::uint64               m_combinations;
+
+                /*! The census as it was before being verified. */
+                std::vector<types::uint64>  m_expected;
+
+                /*! The sparse census as it was before being verified. */
+                SparseCensus                m_expectedOccupied;
+
+                /*! The permutation index of every agent, sorted per thread. */
+                std::vector<types::uint64>  m_keys;
+
+                /*! The sparse census being merged with its changes. */
+                SparseCensus                m_merged;
+
+                /*! The most permutations to write per step, if sparse. */
+                types::uint64               m_limit;
+
+                /*!
+                 * The index of the permutation held by every possible packed
+                 * behavior word, if words are narrow enough.
+                 */
+                std::vector<types::uint32>  m_lookup;
+
+                /*! The most threads to count the census with. */
+                types::uint32               m_numThreads;
+
+                /*!
+                 * The number of agents that hold each occupied permutation,
+                 * ordered by index, if the census is sparse.
+                 */
+                SparseCensus                m_occupied;
+
+                /*! The census counted by each thread. */
+                std::vector<std::vector<types::uint64>> m_partials;
 
                 /*!
                  * Represents both a collection of permutations for a given set
@@ -124,7 +529,28 @@ namespace iris
                  * statistics will be written out, as it is important to do so
                  * in the exact same way across the lifespan of a simulation.
                  */
-                gen::PermuteList  m_permutes;
+                gen::PermuteList            m_permutes;
+
+                /*! The total privilege counted by each thread. */
+                std::vector<types::uint64>  m_privileges;
+
+                /*! The permutations chosen to be written, if limited. */
+                SparseCensus                m_selected;
+
+                /*! Whether only occupied permutations are counted. */
+                bool                        m_sparse;
+
+                /*! The snapshot of the census being written. */
+                Snapshot                    m_snapshot;
+
+                /*! The sparse census counted by each thread. */
+                std::vector<SparseCensus>   m_sparsePartials;
+
+                /*! The weight of each behavior's digit in an index. */
+                std::vector<types::uint64>  m_strides;
+
+                /*! The total privilege of every agent. */
+                types::uint64               m_totalPrivilege;
         };
     }
 }
@@ -0,0 +1,55 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "iris/Utils.hpp"
+
+#include "iris/io/reader/ColumnReader.hpp"
+
+/*!
+ * Converts a binary column file written by Iris back into a CSV (comma
+ * separated value) file, laid out exactly as Iris would have written it.
+ *
+ * @param argc
+ *        The number of command line arguments, if any.
+ * @param argv
+ *        The list of command line arguments, if any.
+ */
+int main(int argc, char** argv)
+{
+    // Terminal color sequences.
+    iris::util::term::Sequence red(iris::util::term::Color::Red);
+    iris::util::term::Sequence def(iris::util::term::Color::Default);
+
+    // The command line arguments are as follows:
+    //    [input] [output]
+    // where the CSV is written to standard output if there is no output.
+    if(argc < 2 || argc > 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <input.col> [output.csv]"
+                  << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        if(argc == 3)
+        {
+            iris::io::convertToCsv(argv[1], argv[2]);
+        }
+        else
+        {
+            iris::io::ColumnReader reader(argv[1]);
+            iris::io::outputCsv(std::cout, reader);
+        }
+    }
+    catch(std::runtime_error& re)
+    {
+        std::cerr << red << "*" << def << " Conversion Error (aborting)"
+                  << std::endl;
+        std::cerr << "What happened: " << re.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
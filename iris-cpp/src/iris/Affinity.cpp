@@ -0,0 +1,317 @@
+#include "iris/Affinity.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "iris/Utils.hpp"
+
+namespace iris
+{
+    Topology::Topology()
+    {
+        if(this->detect())
+        {
+            return;
+        }
+
+        // Fall back on a single node holding every processor.
+        const auto count = std::max(std::thread::hardware_concurrency(), 1u);
+
+        m_nodes.push_back(Uint32List{});
+        m_nodeIds.push_back(0);
+
+        for(types::uint32 i = 0; i < count; i++)
+        {
+            m_nodes[0].push_back(i);
+        }
+    }
+
+    Topology::Topology(const std::vector<Uint32List>& nodes)
+    {
+        for(types::uint32 i = 0; i < nodes.size(); i++)
+        {
+            if(!nodes[i].empty())
+            {
+                m_nodes.push_back(nodes[i]);
+                m_nodeIds.push_back(i);
+            }
+        }
+
+        if(m_nodes.empty())
+        {
+            throw std::runtime_error("A topology needs at least one"
+                                     " processor.");
+        }
+    }
+
+    Topology::~Topology()
+    {}
+
+    bool Topology::detect()
+    {
+#ifdef __linux__
+        const std::string root = "/sys/devices/system/node/";
+
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+
+        if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        {
+            return false;
+        }
+
+        auto directory = opendir(root.c_str());
+
+        if(directory == nullptr)
+        {
+            return false;
+        }
+
+        // Gather the node identifiers first; readdir makes no promises
+        // about their order.
+        Uint32List ids;
+
+        for(auto entry = readdir(directory); entry != nullptr;
+            entry = readdir(directory))
+        {
+            const std::string name = entry->d_name;
+
+            if(name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+               std::all_of(name.begin() + 4, name.end(), ::isdigit))
+            {
+                ids.push_back(util::parseString<types::uint32>(
+                                  name.substr(4)));
+            }
+        }
+
+        closedir(directory);
+        std::sort(ids.begin(), ids.end());
+
+        for(const auto id : ids)
+        {
+            std::ifstream file(root + "node" + util::toString(id) +
+                               "/cpulist");
+            std::string   list;
+
+            if(!file || !std::getline(file, list))
+            {
+                continue;
+            }
+
+            Uint32List cpus;
+
+            for(const auto cpu : parseCpuList(list))
+            {
+                if(cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+
+            // Memory-only nodes have nothing to run workers on.
+            if(!cpus.empty())
+            {
+                m_nodes.push_back(cpus);
+                m_nodeIds.push_back(id);
+            }
+        }
+
+        return !m_nodes.empty();
+#else
+        return false;
+#endif
+    }
+
+    std::size_t Topology::moveToNode(const void* begin, std::size_t bytes,
+                                     types::int32 node)
+    {
+#ifdef __linux__
+        const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const auto start    = reinterpret_cast<std::size_t>(begin);
+
+        // Only whole pages are moved, so that neighbouring partitions never
+        // fight over the page they share.
+        const auto first = (start + pageSize - 1) / pageSize * pageSize;
+        const auto last  = (start + bytes) / pageSize * pageSize;
+
+        if(node < 0 || first >= last)
+        {
+            return 0;
+        }
+
+        const auto            count = (last - first) / pageSize;
+        std::vector<void*>    pages(count);
+        std::vector<int>      nodes(count, node);
+        std::vector<int>      status(count, -1);
+
+        for(std::size_t i = 0; i < count; i++)
+        {
+            pages[i] = reinterpret_cast<void*>(first + i * pageSize);
+        }
+
+        if(syscall(SYS_move_pages, 0, count, pages.data(), nodes.data(),
+                   status.data(), MPOL_MF_MOVE) < 0)
+        {
+            return 0;
+        }
+
+        return static_cast<std::size_t>(
+            std::count(status.begin(), status.end(), node));
+#else
+        (void)begin;
+        (void)bytes;
+        (void)node;
+
+        return 0;
+#endif
+    }
+
+    Uint32List Topology::parseCpuList(const std::string& list)
+    {
+        Uint32List  cpus;
+        std::size_t position = 0;
+
+        const auto readNumber = [&list, &position]() {
+            const auto start = position;
+
+            while(position < list.size() && ::isdigit(list[position]))
+            {
+                position++;
+            }
+
+            if(start == position)
+            {
+                throw std::runtime_error("Malformed processor list: " + list);
+            }
+
+            return util::parseString<types::uint32>(
+                list.substr(start, position - start));
+        };
+
+        while(position < list.size() && !::isspace(list[position]))
+        {
+            const auto low  = readNumber();
+            auto       high = low;
+
+            if(position < list.size() && list[position] == '-')
+            {
+                position++;
+                high = readNumber();
+            }
+
+            if(high < low)
+            {
+                throw std::runtime_error("Malformed processor list: " + list);
+            }
+
+            for(auto cpu = low; cpu <= high; cpu++)
+            {
+                cpus.push_back(cpu);
+            }
+
+            if(position < list.size() && list[position] == ',')
+            {
+                position++;
+            }
+        }
+
+        return cpus;
+    }
+
+    AffinityPolicy Topology::parsePolicy(const std::string& name)
+    {
+        if(name == "none")
+        {
+            return AffinityPolicy::None;
+        }
+        else if(name == "compact")
+        {
+            return AffinityPolicy::Compact;
+        }
+        else if(name == "scatter")
+        {
+            return AffinityPolicy::Scatter;
+        }
+
+        throw std::runtime_error("Unknown affinity policy: " + name);
+    }
+
+    bool Topology::pinCurrentThread(types::uint32 cpu)
+    {
+#ifdef __linux__
+        if(cpu >= CPU_SETSIZE)
+        {
+            return false;
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+
+        return false;
+#endif
+    }
+
+    std::vector<Placement> Topology::place(types::uint32 numThreads,
+                                           AffinityPolicy policy) const
+    {
+        std::vector<Placement> placements(numThreads, Placement{-1, -1});
+
+        if(policy == AffinityPolicy::None)
+        {
+            return placements;
+        }
+
+        if(policy == AffinityPolicy::Compact)
+        {
+            std::vector<Placement> slots;
+
+            for(types::uint32 node = 0; node < m_nodes.size(); node++)
+            {
+                for(const auto cpu : m_nodes[node])
+                {
+                    slots.push_back(Placement{
+                        static_cast<types::int32>(cpu),
+                        static_cast<types::int32>(m_nodeIds[node])});
+                }
+            }
+
+            for(types::uint32 i = 0; i < numThreads; i++)
+            {
+                placements[i] = slots[i % slots.size()];
+            }
+        }
+        else
+        {
+            const auto numNodes = static_cast<types::uint32>(m_nodes.size());
+
+            for(types::uint32 i = 0; i < numThreads; i++)
+            {
+                const auto& cpus = m_nodes[i % numNodes];
+                const auto  cpu  = cpus[(i / numNodes) % cpus.size()];
+
+                placements[i] = Placement{
+                    static_cast<types::int32>(cpu),
+                    static_cast<types::int32>(m_nodeIds[i % numNodes])};
+            }
+        }
+
+        return placements;
+    }
+}
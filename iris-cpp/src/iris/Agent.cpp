@@ -5,22 +5,16 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "iris/AgentStore.hpp"
+#include "iris/Arena.hpp"
+#include "iris/DeltaBuffer.hpp"
 #include "iris/Model.hpp"
 #include "iris/Utils.hpp"
 
 namespace iris
 {
-    State& State::operator = (const State& state)
-    {
-        m_behavior = state.m_behavior;
-        m_time     = state.m_time;
-
-        return *this;
-    }
-    
-    Agent::Agent()
-        : m_familySize(0), m_powerful(false), m_privilege(0), m_uid(0),
-          m_bMutex(), m_iMutex()
+    Agent::Agent(AgentStore& store, AgentID index)
+        : m_index(index), m_store(&store)
     {}
 
     Agent::~Agent()
@@ -28,28 +22,36 @@ namespace iris
 
     void Agent::addConnection(AgentID to)
     {
-        util::sortedInsert(m_network, to);
+        if(m_store->isFrozen())
+        {
+            throw std::runtime_error("Cannot add a connection to a frozen"
+                                     " network!");
+        }
+
+        util::sortedInsert(m_store->getNetworks()[m_index], to);
     }
 
-    BehaviorList Agent::cacheBehaviorsAsSet(const Agent::Network& powerGroup,
-                                            Agent* const agents,
-                                            types::uint32 index,
-                                            types::uint64 time)
+    Span<types::uint32> Agent::cacheBehaviorsAsSet(NetworkView powerGroup,
+                                                   AgentStore& agents,
+                                                   types::uint32 index,
+                                                   ScratchArena& arena)
     {
-        BehaviorList cached;
+        const auto& codec  = agents.getBehaviorCodec();
+        auto        cached = arena.allocate<types::uint32>(powerGroup.size());
+        auto        end    = cached.begin();
 
         for(auto& pg : powerGroup)
         {
-            const auto behav = agents[pg].getBehaviorAt(index, time);
+            const auto behav = codec.get(agents.getBehaviorWord(pg), index);
             
             // See if it can be found in cached.
-            if(std::find(cached.begin(), cached.end(), behav) == cached.end())
+            if(std::find(cached.begin(), end, behav) == end)
             {
-                cached.push_back(behav);
+                *end++ = behav;
             }
         }
 
-        return cached;
+        return Span<types::uint32>(cached.begin(), end);
     }
 
     Agent::Outcome Agent::computeOutcomeDirectly(
@@ -60,7 +62,7 @@ namespace iris
 
     Agent::Outcome Agent::computeOutcomeSociodynamically(const Sides &sides,
                                                  const iris::Parameters &params,
-                                                 types::mersenne_twister &random)
+                                                 CounterRandom& random)
         const
     {
         typedef std::uniform_real_distribution<types::fnumeric> FDist;
@@ -83,17 +85,16 @@ namespace iris
 
     Agent::Sides Agent::computeSides(types::uint32 index,
                                      types::uint32 behavior,
-                                     Network socialGroup,
-                                     iris::Agent *const agents,
-                                     AgentID totalAgents,
-                                     types::uint64 time) const
+                                     NetworkView socialGroup,
+                                     AgentStore& agents) const
     {
+        const auto& codec = agents.getBehaviorCodec();
+        
         auto against  =
             std::count_if(socialGroup.begin(), socialGroup.end(),
-                          [index, behavior, agents, time](const AgentID& id) {
-                              const auto val =
-                                  agents[id].getBehaviorAt(index, time);
-                              return val != behavior;
+                          [index, behavior, &agents, &codec](AgentID id) {
+                              const auto word = agents.getBehaviorWord(id);
+                              return codec.get(word, index) != behavior;
                           });
         auto infavor = socialGroup.size() - against;
         return Sides(against, infavor);
@@ -122,165 +123,156 @@ namespace iris
 
     void Agent::distributePrivilege(types::uint32 currentIndex,
                                     types::uint32 currentBehavior,
-                                    const Network& socialGroup,
+                                    NetworkView socialGroup,
                                     const Agent::Outcome& outcome,
-                                    Agent* const agents,
-                                    types::uint64 time)
+                                    AgentStore& agents,
+                                    DeltaBuffer& deltas)
     {
         for(auto& soc : socialGroup)
         {
             const auto socBehavior =
-                agents[soc].getBehaviorAt(currentIndex, time);
+                agents[soc].getBehaviorAt(currentIndex);
             const auto commType    =
                 this->determineCommType(currentBehavior,
                                         socBehavior,
                                         outcome);
 
-            agents[soc].updateInfluenceOn(m_uid, commType);
+            deltas.addInfluence(soc, m_index, commType);
 
-            if(m_powerful && (commType != CommType::Neither))
+            if(this->isPowerful() && (commType != CommType::Neither))
             {
-                agents[soc].increasePrivilege();
+                deltas.addPrivilege(soc);
             }
         }
     }
 
     void Agent::distributePrivilegeWithPower(types::uint32 currentIndex,
                                              types::uint32 currentBehavior,
-                                             const Network& socialGroup,
-                                             const Network& powerGroup,
+                                             NetworkView socialGroup,
+                                             NetworkView powerGroup,
                                              const Agent::Outcome& outcome,
-                                             Agent* const agents,
-                                             types::uint64 time)
+                                             AgentStore& agents,
+                                             DeltaBuffer& deltas,
+                                             ScratchArena& arena)
     {
         // First, cache the powerful agents' behaviors.
         const auto powerCache = this->cacheBehaviorsAsSet(powerGroup,
                                                           agents,
                                                           currentIndex,
-                                                          time);
+                                                          arena);
 
         for(auto& soc : socialGroup)
         {
             const auto socBehavior =
-                agents[soc].getBehaviorAt(currentIndex, time);
+                agents[soc].getBehaviorAt(currentIndex);
             const auto commType    =
                 this->determineCommType(currentBehavior, socBehavior, outcome);
 
-            agents[soc].updateInfluenceOn(m_uid, commType);
+            deltas.addInfluence(soc, m_index, commType);
 
             if((std::find(powerCache.begin(), powerCache.end(), socBehavior)
                 != powerCache.end()) && (commType != CommType::Neither))
             {
-                agents[soc].increasePrivilege();
+                deltas.addPrivilege(soc);
             }
         }
     }
 
-    Agent::Network Agent::extractPowerful(const Agent::Network& network,
-                                          iris::Agent *const agents,
-                                          AgentID totalAgents)
+    Agent::Group Agent::extractPowerful(NetworkView network,
+                                        AgentStore& agents,
+                                        ScratchArena& arena)
     {
-        Network powerful;
+        auto powerful = arena.allocate<AgentID>(network.size());
+        auto end      = powerful.begin();
 
-        for(Agent::Network::size_type i = 0; i < network.size(); i++)
+        for(AgentID i = 0; i < network.size(); i++)
         {
             if(agents[i].isPowerful())
             {
-                powerful.push_back(i);
+                *end++ = i;
             }
         }
 
-        return powerful;
+        return Group(powerful.begin(), end);
     }
 
     BehaviorList Agent::getBehavior() const
     {
-        return m_state[0].m_time > m_state[1].m_time ?
-            m_state[0].m_behavior : m_state[1].m_behavior;
+        const auto& codec = m_store->getBehaviorCodec();
+        return codec.decode(m_store->getBehaviorWord(m_index));
     }
 
     types::uint32 Agent::getBehaviorCount() const
     {
-        return m_state[0].m_time > m_state[1].m_time ?
-            m_state[0].m_behavior.size() : m_state[1].m_behavior.size();
+        return m_store->getBehaviorCodec().size();
     }
 
-    types::uint32 Agent::getBehaviorAt(types::uint32 index,
-                                       types::uint64 time)
+    types::uint32 Agent::getBehaviorAt(types::uint32 index) const
     {
-        //        mutex_guard lock(m_bMutex);
-
-        if(m_state[0].m_time == time)
-        {
-            return m_state[0].m_behavior[index];
-        }
-        else if(m_state[1].m_time == time)
-        {
-            //            m_bMutex.unlock();
-            return m_state[1].m_behavior[index];
-        }
-
-        throw std::runtime_error("No behavior at time: " +
-                                 util::toString(time));
+        const auto& codec = m_store->getBehaviorCodec();
+        return codec.get(m_store->getBehaviorWord(m_index), index);
     }
 
-    Agent::InteractionMap::iterator Agent::getInteractionsWith(
-                                                             const AgentID& id)
+    Interaction& Agent::getInteractionsWith(const AgentID& id)
     {
-        auto comm = m_interactions.find(id);
-        if(comm == m_interactions.end())
+        if(m_store->isFrozen())
         {
-            const auto interact = std::pair<AgentID, Interaction>(id, {});
-            auto handle =  m_interactions.insert(interact);
-            comm = handle.first;
+            const auto network = m_store->getNetwork(m_index);
+            const auto edge    =
+                std::lower_bound(network.begin(), network.end(), id);
+
+            if(edge != network.end() && *edge == id)
+            {
+                const auto first = m_store->getNetworkOffsets()[m_index];
+                const auto index = first + (edge - network.begin());
+
+                return m_store->getEdgeInteractions()[index];
+            }
         }
-        return comm;
+
+        return m_store->getOutGroupInteractions(m_index).get(m_index, id);
     }
 
     types::uint32 Agent::getFamilyConnections() const
     {
-        return m_familySize - 1;
+        return m_store->getFamilySizes()[m_index] - 1;
     }
     
     types::uint32 Agent::getFamilySize() const
     {
-        return m_familySize;
+        return m_store->getFamilySizes()[m_index];
     }
 
-    Agent::InteractionMap Agent::getInteractions() const
+    Agent::NetworkView Agent::getNetwork() const
     {
-        return m_interactions;
-    }
-
-    Agent::Network Agent::getNetwork() const
-    {
-        return m_network;
+        return m_store->getNetwork(m_index);
     }
     
     types::unumeric Agent::getPrivilege() const
     {
-        return m_privilege;
+        return m_store->getPrivileges()[m_index];
     }
 
     AgentID Agent::getUId() const
     {
-        return m_uid;
+        return m_store->getUIds()[m_index];
     }
 
     ValueList Agent::getValues() const
     {
-        return m_values;
+        const auto& codec = m_store->getValueCodec();
+        return codec.decode(m_store->getValueWord(m_index));
     }
 
     void Agent::increasePrivilege()
     {
-        m_privilege++;
+        m_store->getPrivileges()[m_index]++;
     }
     
     bool Agent::isConnectedTo(AgentID to)
     {
-        return std::find(m_network.begin(), m_network.end(), to) !=
-            m_network.end();
+        const auto network = m_store->getNetwork(m_index);
+        return std::binary_search(network.begin(), network.end(), to);
     }
 
     bool Agent::isNetworkFull(types::uint32 outConnections,
@@ -290,103 +282,153 @@ namespace iris
         const auto upperBound =
             ((outConnections + familySize) > (totalAgents - 1)) ?
             (totalAgents - 1) : (outConnections + familySize);
-        const auto remainder = (upperBound - m_network.size());
+        const auto remainder =
+            (upperBound - m_store->getNetwork(m_index).size());
 
         return (remainder == 0 || remainder >= upperBound);
     }
 
     bool Agent::isPowerful() const
     {
-        return m_powerful;
+        return m_store->getPowerFlags()[m_index] != 0;
     }
 
-    Agent::Network Agent::obtainRandomInfluentialGroup(types::uint32 qIn,
-                                                       types::uint32 qOut,
-                                                       Agent* const agents,
-                                                       AgentID totalAgents,
-                                                types::mersenne_twister& random)
+    Agent::Group Agent::obtainRandomInfluentialGroup(types::uint32 qIn,
+                                                     types::uint32 qOut,
+                                                     AgentStore& agents,
+                                                     AgentID totalAgents,
+                                                     CounterRandom& random,
+                                                     ScratchArena& arena)
   {
-      const auto inGroup  = this->obtainRandomInGroup(qIn, random);
-      auto       outGroup = this->obtainRandomOutGroup(qOut, totalAgents,
-                                                       random);
+      const auto degree   = m_store->getNetwork(m_index).size();
+      const auto inBound  = std::min(static_cast<std::size_t>(qIn), degree);
+      const auto capacity = std::min(static_cast<AgentID>(qOut), totalAgents);
+
+      // Both groups are drawn straight into place, the out-group behind
+      // the in-group.
+      auto influential = arena.allocate<AgentID>(inBound + capacity);
+
+      const auto inSize = this->sampleInGroup(qIn, random,
+                                              influential.data());
+      const auto drawn  = this->sampleOutGroup(qOut, totalAgents, random,
+                                              influential.data() + inSize);
+      auto       end    = influential.begin() + inSize + drawn;
 
-      if(m_powerful)
+      if(this->isPowerful())
       {
-          this->removeNonPowerful(outGroup, agents, totalAgents);          
+          end = std::remove_if(influential.begin() + inSize, end,
+              [&agents](const AgentID& id){ return !agents[id].isPowerful(); });
       }
-      
-      Network influential;
 
-      influential.reserve(inGroup.size() + outGroup.size());
-      influential.insert(influential.end(), inGroup.begin(), inGroup.end());
-      influential.insert(influential.end(), outGroup.begin(), outGroup.end());
-
-      return influential;
+      return Group(influential.begin(), end);
   }
 
-    Agent::Network Agent::obtainRandomInGroup(types::uint32 qIn,
-                                              types::mersenne_twister& random)
+    types::uint32 Agent::sampleInGroup(types::uint32 qIn,
+                                       CounterRandom& random,
+                                       AgentID* sample) const
     {
-        // This is one of those excellent cases where we abuse the stack.
-        Network network(m_network.begin(), m_network.end());
-        std::shuffle(network.begin(), network.end(), random);
+        typedef std::uniform_int_distribution<std::size_t> IndexDist;
+
+        const auto view   = m_store->getNetwork(m_index);
+        const auto degree = view.size();
+
+        // Everybody is wanted, so there is nothing to choose.
+        if(qIn >= degree)
+        {
+            std::copy(view.begin(), view.end(), sample);
+            return static_cast<types::uint32>(degree);
+        }
+
+        // Floyd's algorithm: the j-th draw picks from the first j positions
+        // and falls back on position j itself if the pick is already taken,
+        // which leaves every subset of qIn positions equally likely.  The
+        // network has no duplicates, so comparing agents compares positions.
+        types::uint32 drawn = 0;
 
-        // Trim to however many are necessary.
-        if(qIn < network.size())
+        for(auto j = degree - qIn; j < degree; j++)
         {
-            network.resize(qIn);
+            const auto picked = view[IndexDist(0, j)(random)];
+
+            sample[drawn] =
+                (std::find(sample, sample + drawn, picked) != sample + drawn) ?
+                view[j] : picked;
+            drawn++;
         }
 
-        return network;
+        return drawn;
     }
 
-    Agent::Network Agent::obtainRandomOutGroup(types::uint32 qOut,
-                                               AgentID totalAgents,
-                                               types::mersenne_twister& random)
+    types::uint32 Agent::sampleOutGroup(types::uint32 qOut,
+                                        AgentID totalAgents,
+                                        CounterRandom& random,
+                                        AgentID* sample) const
     {
         typedef std::uniform_int_distribution<AgentID> UintDist;
-        
-        const auto networkBound = totalAgents - m_network.size() - 1;
-        const auto upperBound   = (qOut > networkBound) ? networkBound : qOut;
 
-        Network  network(m_network.begin(), m_network.end());
-        Network  outGroup;
-        UintDist chooser(0, totalAgents - 1);
+        const auto view     = m_store->getNetwork(m_index);
+        const auto excluded = static_cast<AgentID>(view.size()) + 1;
 
-        // Add current id.
-        util::sortedInsert(network, m_uid);
-        
-        for(AgentID i = 0; i < upperBound; i++)
+        const auto isExcluded = [this, &view](AgentID id) {
+            return id == m_index ||
+                std::binary_search(view.begin(), view.end(), id);
+        };
+
+        types::uint32 drawn = 0;
+
+        // When free candidates are scarce, rejection could take ever more
+        // draws, so walk the population once instead, choosing each free
+        // candidate with the chance that keeps the sample uniform (and
+        // taking all of them if there are no more than requested).
+        if(totalAgents <= excluded || excluded + qOut > totalAgents / 2)
         {
-            try
+            auto remaining = (totalAgents > excluded) ?
+                totalAgents - excluded : 0;
+
+            for(AgentID id = 0; id < totalAgents && drawn < qOut &&
+                    remaining != 0; id++)
             {
-                const auto nextAgent =
-                    util::ensureRandom(chooser(random), network,
-                                       (AgentID)0, totalAgents);
-                util::sortedInsert(network, nextAgent);
-                outGroup.push_back(nextAgent);
+                if(isExcluded(id))
+                {
+                    continue;
+                }
+
+                const auto needed = static_cast<AgentID>(qOut - drawn);
+
+                if(needed >= remaining ||
+                   UintDist(0, remaining - 1)(random) < needed)
+                {
+                    sample[drawn++] = id;
+                }
+
+                remaining--;
             }
-            catch(std::runtime_error& re)
+
+            return drawn;
+        }
+
+        // Otherwise at least half of the population is always free, so on
+        // average fewer than two draws are needed per member.
+        UintDist chooser(0, totalAgents - 1);
+
+        while(drawn < qOut)
+        {
+            const auto id = chooser(random);
+
+            if(isExcluded(id) ||
+               std::find(sample, sample + drawn, id) != sample + drawn)
             {
-                // Nothing to do here, just continue.
+                continue;
             }
-        }
 
-        return outGroup;
-    }
+            sample[drawn++] = id;
+        }
 
-    void Agent::removeNonPowerful(Agent::Network &network,
-                                  iris::Agent *const agents,
-                                  AgentID totalAgents)
-    {
-        auto iter = std::remove_if(network.begin(), network.end(),
-            [agents](const AgentID& id){ return !agents[id].isPowerful(); });
-        network.erase(iter, network.end());
+        return drawn;
     }
 
     types::uint32 Agent::selectNewBehavior(types::uint32 currentBehavior,
                                            types::uint32 behaviorRange,
-                                           types::mersenne_twister& random)
+                                           CounterRandom& random)
     {
         using namespace iris::types;
         using namespace iris::util;
@@ -399,44 +441,51 @@ namespace iris
         typedef std::uniform_int_distribution<types::uint32> UintDist;        
         auto       chooser      = UintDist{0, behaviorRange - 1};
         const auto chosen       = chooser(random);
-        const auto behaviorList = Uint32List{currentBehavior};
 
-        return ensureRandom<uint32>(chosen, behaviorList,
-                                    0, behaviorRange);
+        if(chosen != currentBehavior)
+        {
+            return chosen;
+        }
+
+        // This is what ensureRandom would do when excluding a single value,
+        // without building a list to search: step up if possible, else down.
+        return (chosen + 1 < behaviorRange) ? chosen + 1 : chosen - 1;
     }
 
     void Agent::setFamilySize(types::uint32 familySize)
     {
-        m_familySize = familySize;
+        m_store->getFamilySizes()[m_index] = familySize;
     }
     
     void Agent::setInitialBehavior(BehaviorList behavior)
     {
-        // For this, set *both* to t = 0 to avoid potential problems.
-        m_state[0].m_behavior = behavior;
-        m_state[0].m_time = 0;
-        m_state[1].m_behavior = behavior;
-        m_state[1].m_time = 0;
+        const auto word = m_store->getBehaviorCodec().encode(behavior);
+
+        // For this, set *both* buffers to avoid potential problems.
+        m_store->getBehaviorWord(m_index)     = word;
+        m_store->getNextBehaviorWord(m_index) = word;
     }
 
     void Agent::setInitialValues(ValueList values)
     {
-        m_values = values;
+        m_store->getValueWord(m_index) =
+            m_store->getValueCodec().encode(values);
     }
 
     void Agent::setPowerful(bool isPowerful)
     {
-        m_powerful = isPowerful;
+        m_store->setPowerful(m_index, isPowerful);
     }
 
     void Agent::setUId(AgentID uid)
     {
-        m_uid = uid;
+        m_store->getUIds()[m_index] = uid;
     }
 
-    void Agent::step(const Parameters &params, iris::Agent *const agents,
+    void Agent::step(const Parameters &params, AgentStore& agents,
                      AgentID totalAgents, const BehaviorList& behaviors,
-                     types::uint64 time, types::mersenne_twister& random)
+                     types::uint64 time, DeltaBuffer& deltas,
+                     ScratchArena& arena)
     {
         typedef std::uniform_int_distribution<types::uint32> UintDist;
 #ifdef IRIS_DEBUG
@@ -466,12 +515,20 @@ namespace iris
          *
          * Each of these steps is broken down into sub-functions to make them
          * easy to unit test.
+         *
+         * Every draw comes from this agent's own stream for this step, so the
+         * result does not depend on which thread steps the agent, or when.
+         * Every temporary comes from the arena, so none of this allocates.
          */
+        CounterRandom random(params.m_seed, this->getUId(), time);
+
+        arena.reset();
+
         const auto socialGroup =
           this->obtainRandomInfluentialGroup(params.m_qIn, params.m_qOut, agents,
-                                             totalAgents, random);
+                                             totalAgents, random, arena);
         const auto powerGroup  =
-          this->extractPowerful(socialGroup, agents, totalAgents);
+          this->extractPowerful(socialGroup, agents, arena);
 
 #ifdef IRIS_DEBUG
         std::cout << "Number of members in social group: "
@@ -490,33 +547,33 @@ namespace iris
             static_cast<types::uint32>(behaviors.size());
         auto indexChooser          = UintDist(0, numBehaviors - 1);
         const auto inspectIndex    = indexChooser(random);
-        const auto inspectBehav    = this->getBehaviorAt(inspectIndex, time - 1);
+        const auto inspectBehav    = this->getBehaviorAt(inspectIndex);
 
         // (3) Determine a social outcome.
         Agent::Outcome outcome;
         
-        if(m_powerful || (!m_powerful && powerGroup.size() == 0))
+        const auto powerful = this->isPowerful();
+
+        if(powerful || (!powerful && powerGroup.size() == 0))
         {
             const auto sides = this->computeSides(inspectIndex, inspectBehav,
-                                                  socialGroup, agents,
-                                                  totalAgents, time - 1);
+                                                  socialGroup, agents);
             outcome          =
                 this->computeOutcomeSociodynamically(sides, params, random);
 
             // Assign privilege and update.
             this->distributePrivilege(inspectIndex, inspectBehav,
                                       socialGroup, outcome,
-                                      agents, time - 1);
+                                      agents, deltas);
         }
         else
         {
             const auto sides = this->computeSides(inspectIndex, inspectBehav,
-                                                  powerGroup, agents,
-                                                  totalAgents, time - 1);
+                                                  powerGroup, agents);
             outcome          = this->computeOutcomeDirectly(sides);
             this->distributePrivilegeWithPower(inspectIndex, inspectBehav,
                                                socialGroup, powerGroup,
-                                               outcome, agents, time - 1);
+                                               outcome, agents, deltas, arena);
         }
 
         // Change behaviors if necessary.
@@ -525,64 +582,39 @@ namespace iris
             const auto newBehavior =
                 this->selectNewBehavior(inspectBehav, behaviors[inspectIndex],
                                         random);
-            this->updateState(inspectIndex, newBehavior, time);
+            this->updateState(inspectIndex, newBehavior);
+
+            // Let the census follow along without counting everybody.
+            if(newBehavior != inspectBehav)
+            {
+                deltas.addTransition(m_store->getBehaviorWord(m_index),
+                                     m_store->getNextBehaviorWord(m_index));
+            }
         }
         else
         {
-            this->updateState(inspectIndex, inspectBehav, time);
+            this->updateState(inspectIndex, inspectBehav);
         }
 
         // Update our own privilege.
-        if(outcome == Outcome::Keep && (m_powerful || powerGroup.size() != 0))
-        {
-            this->increasePrivilege();
-        }
-
-        // Finally, update our own map.
-        this->updateCommunicationWith(socialGroup);
-    }
-
-    void Agent::updateCommunicationWith(const Network& network)
-    {
-        //        mutex_guard lock(m_iMutex);        
-        for(auto& otherId : network)
+        if(outcome == Outcome::Keep && (powerful || powerGroup.size() != 0))
         {
-            auto comm = this->getInteractionsWith(otherId);
-            (*comm).second.m_communicated++;
+            deltas.addPrivilege(m_index);
         }
-    }
 
-    void Agent::updateInfluenceOn(const AgentID& targetId,
-                                  const CommType& commType)
-    {
-        //        mutex_guard lock(m_iMutex);
-        auto comm = this->getInteractionsWith(targetId);
-        
-        switch(commType)
+        // Finally, update our own counters.
+        for(auto& otherId : socialGroup)
         {
-            case Censored:
-                (*comm).second.m_censored++;
-                break;
-            case Neither:
-                break;
-            case Reinforced:
-                (*comm).second.m_reinforced++;
-                break;
+            deltas.addCommunication(m_index, otherId);
         }
-
-        (*comm).second.m_communicated++;
     }
 
-    void Agent::updateState(types::uint32 index, types::uint32 behavior,
-                            types::uint64 time)
+    void Agent::updateState(types::uint32 index, types::uint32 behavior)
     {
-        //        mutex_guard lock(m_bMutex);
-
-        // Copy "current" state to previous.
-        m_state[1] = m_state[0];
+        const auto& codec = m_store->getBehaviorCodec();
 
-        // Update "current".
-        m_state[0].m_behavior[index] = behavior;
-        m_state[0].m_time = time;
+        // Carry the "current" state forward, then change the one behavior.
+        m_store->getNextBehaviorWord(m_index) =
+            codec.set(m_store->getBehaviorWord(m_index), index, behavior);
     }
 }
@@ -0,0 +1,494 @@
+#include "iris/AgentStore.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+#include "iris/Affinity.hpp"
+#include "iris/Utils.hpp"
+
+namespace iris
+{
+    const types::uint32 AgentStore::ShardCount;
+
+    AgentStore::AgentStore()
+        : m_epoch(0), m_outGroupInteractions(ShardCount)
+    {}
+
+    AgentStore::AgentStore(AgentID totalAgents, const ValueList& values,
+                           const BehaviorList& behaviors)
+        : m_epoch(0), m_outGroupInteractions(ShardCount)
+    {
+        this->initialize(totalAgents, values, behaviors);
+    }
+
+    AgentStore::~AgentStore()
+    {}
+
+    void AgentStore::clear()
+    {
+        m_behaviorCodec = AttributeCodec();
+        m_valueCodec    = AttributeCodec();
+        m_epoch         = 0;
+
+        m_behaviors[0].clear();
+        m_behaviors[1].clear();
+        m_familySize.clear();
+        m_powerful.clear();
+        m_powerIndex.clear();
+        m_privilege.clear();
+        m_uid.clear();
+        m_values.clear();
+
+        m_edgeInteractions.clear();
+
+        for(auto& table : m_outGroupInteractions)
+        {
+            table.clear();
+        }
+        m_networks.clear();
+        m_offsets.clear();
+        m_targets.clear();
+        m_mapping = MappedFile();
+
+        this->refreshViews();
+    }
+
+    AgentStore::NetworkHeader
+    AgentStore::createNetworkHeader(AgentID agents, types::uint64 edges)
+    {
+        static_assert(sizeof(NetworkHeader) % sizeof(types::uint64) == 0,
+                      "The offsets must follow the header aligned.");
+
+        NetworkHeader header;
+
+        std::memcpy(header.m_magic, "IRISNET1", sizeof(header.m_magic));
+        header.m_agents   = agents;
+        header.m_edges    = edges;
+        header.m_idBytes  = sizeof(AgentID);
+        header.m_reserved = 0;
+
+        return header;
+    }
+
+    void AgentStore::freezeNetworks()
+    {
+        if(this->isFrozen())
+        {
+            throw std::runtime_error("Networks have already been frozen!");
+        }
+
+        const auto n = m_networks.size();
+
+        m_offsets.resize(n + 1);
+        m_offsets[0] = 0;
+
+        for(std::size_t i = 0; i < n; i++)
+        {
+            m_offsets[i + 1] = m_offsets[i] + m_networks[i].size();
+        }
+
+        m_targets.resize(m_offsets[n]);
+
+        for(std::size_t i = 0; i < n; i++)
+        {
+            std::copy(m_networks[i].begin(), m_networks[i].end(),
+                      m_targets.begin() + m_offsets[i]);
+        }
+
+        m_edgeInteractions.assign(m_targets.size(), Interaction{});
+
+        // Release the per-agent lists entirely; clear() alone would keep
+        // their capacity around.
+        std::vector<Agent::Network>().swap(m_networks);
+
+        this->refreshViews();
+    }
+
+    void AgentStore::freezeNetworks(std::vector<types::uint64> offsets,
+                                    std::vector<AgentID> targets)
+    {
+        if(this->isFrozen())
+        {
+            throw std::runtime_error("Networks have already been frozen!");
+        }
+
+        if(offsets.size() != m_uid.size() + 1 || offsets[0] != 0 ||
+           offsets.back() != targets.size())
+        {
+            throw std::runtime_error("The network offsets do not match the"
+                                     " agents and their targets.");
+        }
+
+        m_offsets.swap(offsets);
+        m_targets.swap(targets);
+        m_edgeInteractions.assign(m_targets.size(), Interaction{});
+
+        std::vector<Agent::Network>().swap(m_networks);
+
+        this->refreshViews();
+    }
+
+    void AgentStore::initialize(AgentID totalAgents, const ValueList& values,
+                                const BehaviorList& behaviors)
+    {
+        if(this->isInitialized())
+        {
+            throw std::runtime_error("Agents have already been initialized!");
+        }
+
+        m_behaviorCodec = AttributeCodec(behaviors);
+        m_valueCodec    = AttributeCodec(values);
+
+        const auto n = static_cast<std::size_t>(totalAgents);
+
+        m_behaviors[0].assign(n, 0);
+        m_behaviors[1].assign(n, 0);
+        m_familySize.assign(n, 0);
+        m_powerful.assign(n, 0);
+        m_privilege.assign(n, 0);
+        m_uid.resize(n);
+        m_values.assign(n, 0);
+
+        // Every agent starts out with its position as its identifier.
+        std::iota(m_uid.begin(), m_uid.end(), 0);
+
+        m_networks.resize(n);
+    }
+
+    void AgentStore::mapNetworks(const std::string& filename)
+    {
+        if(this->isFrozen())
+        {
+            throw std::runtime_error("Networks have already been frozen!");
+        }
+
+        MappedFile file(filename);
+        NetworkHeader header;
+
+        if(file.size() < sizeof(header))
+        {
+            throw std::runtime_error(filename + " is not a network file.");
+        }
+
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        const auto expected = createNetworkHeader(this->size(),
+                                                  header.m_edges);
+
+        if(std::memcmp(header.m_magic, expected.m_magic,
+                       sizeof(header.m_magic)) != 0 ||
+           header.m_idBytes != expected.m_idBytes)
+        {
+            throw std::runtime_error(filename + " is not a network file.");
+        }
+
+        const auto notHeld = [this, &filename]() {
+            return std::runtime_error(filename + " does not hold the networks"
+                                      " of " + util::toString(this->size()) +
+                                      " agents.");
+        };
+
+        // Checked in parts so that a corrupt count cannot overflow.
+        const auto offsetBytes = sizeof(header) +
+            (static_cast<std::size_t>(this->size()) + 1) *
+            sizeof(types::uint64);
+
+        if(header.m_agents != expected.m_agents || file.size() < offsetBytes ||
+           (file.size() - offsetBytes) / sizeof(AgentID) != header.m_edges ||
+           (file.size() - offsetBytes) % sizeof(AgentID) != 0)
+        {
+            throw notHeld();
+        }
+
+        // A stale or partly written file must not send a network outside
+        // the mapping, so every offset and target is checked once here.
+        const auto offsets = reinterpret_cast<const types::uint64*>(
+            file.data() + sizeof(header));
+        const auto targets = reinterpret_cast<const AgentID*>(
+            file.data() + offsetBytes);
+
+        if(offsets[0] != 0 || offsets[this->size()] != header.m_edges)
+        {
+            throw notHeld();
+        }
+
+        for(AgentID i = 0; i < this->size(); i++)
+        {
+            if(offsets[i + 1] < offsets[i])
+            {
+                throw notHeld();
+            }
+        }
+
+        for(types::uint64 e = 0; e < header.m_edges; e++)
+        {
+            if(targets[e] >= this->size())
+            {
+                throw notHeld();
+            }
+        }
+
+        m_mapping = std::move(file);
+        m_edgeInteractions.assign(header.m_edges, Interaction{});
+
+        std::vector<Agent::Network>().swap(m_networks);
+
+        this->refreshViews();
+    }
+
+    std::size_t AgentStore::moveToNode(AgentID first, AgentID last,
+                                       types::int32 node)
+    {
+        if(first >= last || last > this->size())
+        {
+            return 0;
+        }
+
+        std::size_t moved = 0;
+        const auto  count = last - first;
+
+        const auto move = [&moved, node](const void* begin, std::size_t bytes) {
+            moved += Topology::moveToNode(begin, bytes, node);
+        };
+
+        // Only the columns read on every step are worth the trouble.
+        move(m_behaviors[0].data() + first, count * sizeof(m_behaviors[0][0]));
+        move(m_behaviors[1].data() + first, count * sizeof(m_behaviors[1][0]));
+        move(m_powerful.data() + first, count * sizeof(m_powerful[0]));
+        move(m_privilege.data() + first, count * sizeof(m_privilege[0]));
+        move(m_uid.data() + first, count * sizeof(m_uid[0]));
+        move(m_values.data() + first, count * sizeof(m_values[0]));
+
+        if(this->isFrozen())
+        {
+            const auto start = m_offsetView[first];
+            const auto edges = m_offsetView[last] - start;
+
+            move(m_offsetView.data() + first, count * sizeof(types::uint64));
+            move(m_targetView.data() + start, edges * sizeof(AgentID));
+            move(m_edgeInteractions.data() + start,
+                 edges * sizeof(m_edgeInteractions[0]));
+        }
+
+        return moved;
+    }
+
+    void AgentStore::renumber(const IDList& order)
+    {
+        const auto n = this->size();
+
+        if(!this->isFrozen())
+        {
+            throw std::runtime_error("Networks must be frozen before agents"
+                                     " are renumbered!");
+        }
+
+        if(order.size() != n)
+        {
+            throw std::runtime_error("A renumbering must cover every agent!");
+        }
+
+        for(const auto& table : m_outGroupInteractions)
+        {
+            if(table.size() != 0)
+            {
+                throw std::runtime_error("Agents cannot be renumbered once"
+                                         " out-group contacts exist!");
+            }
+        }
+
+        // Invert the order, checking that it is a permutation on the way.
+        IDList position(n, n);
+
+        for(AgentID i = 0; i < n; i++)
+        {
+            if(order[i] >= n || position[order[i]] != n)
+            {
+                throw std::runtime_error("A renumbering must move every agent"
+                                         " exactly once!");
+            }
+
+            position[order[i]] = i;
+        }
+
+        permute(m_behaviors[0], order);
+        permute(m_behaviors[1], order);
+        permute(m_familySize, order);
+        permute(m_powerful, order);
+        permute(m_privilege, order);
+        permute(m_uid, order);
+        permute(m_values, order);
+
+        m_powerIndex.clear();
+
+        for(AgentID i = 0; i < n; i++)
+        {
+            if(m_powerful[i] != 0)
+            {
+                m_powerIndex.push_back(i);
+            }
+        }
+
+        // Rebuild the networks in the new order, keeping each edge's
+        // counters with it.
+        std::vector<types::uint64> offsets(n + 1, 0);
+        std::vector<AgentID>       targets(m_targetView.size());
+        std::vector<Interaction>   edges(m_edgeInteractions.size());
+        std::vector<std::pair<AgentID, Interaction>> network;
+
+        for(AgentID i = 0; i < n; i++)
+        {
+            const auto from = m_offsetView[order[i]];
+            const auto to   = m_offsetView[order[i] + 1];
+
+            network.clear();
+
+            for(auto e = from; e < to; e++)
+            {
+                network.emplace_back(position[m_targetView[e]],
+                                     m_edgeInteractions[e]);
+            }
+
+            std::sort(network.begin(), network.end(),
+                      [](const std::pair<AgentID, Interaction>& lhs,
+                         const std::pair<AgentID, Interaction>& rhs) {
+                          return lhs.first < rhs.first;
+                      });
+
+            offsets[i + 1] = offsets[i] + network.size();
+
+            for(std::size_t j = 0; j < network.size(); j++)
+            {
+                targets[offsets[i] + j] = network[j].first;
+                edges[offsets[i] + j]   = network[j].second;
+            }
+        }
+
+        // The rebuilt networks live in memory from now on.
+        m_offsets.swap(offsets);
+        m_targets.swap(targets);
+        m_edgeInteractions.swap(edges);
+        m_mapping = MappedFile();
+
+        this->refreshViews();
+    }
+
+    void AgentStore::refreshViews()
+    {
+        if(m_mapping.isOpen())
+        {
+            NetworkHeader header;
+            std::memcpy(&header, m_mapping.data(), sizeof(header));
+
+            // The header is a multiple of eight bytes long, and mappings
+            // start on a page, so both arrays are suitably aligned.
+            const auto offsets = reinterpret_cast<const types::uint64*>(
+                m_mapping.data() + sizeof(header));
+            const auto targets = reinterpret_cast<const AgentID*>(
+                offsets + header.m_agents + 1);
+
+            m_offsetView = Span<const types::uint64>(offsets,
+                                                     header.m_agents + 1);
+            m_targetView = Span<const AgentID>(targets, header.m_edges);
+        }
+        else
+        {
+            m_offsetView = Span<const types::uint64>(m_offsets);
+            m_targetView = Span<const AgentID>(m_targets);
+        }
+    }
+
+    void AgentStore::setPowerful(AgentID index, bool isPowerful)
+    {
+        if((m_powerful[index] != 0) == isPowerful)
+        {
+            return;
+        }
+
+        m_powerful[index] = isPowerful ? 1 : 0;
+
+        if(isPowerful)
+        {
+            util::sortedInsert(m_powerIndex, index);
+        }
+        else
+        {
+            m_powerIndex.erase(std::lower_bound(m_powerIndex.begin(),
+                                                m_powerIndex.end(), index));
+        }
+    }
+
+    void AgentStore::setPowerfulAgents(IDList positions)
+    {
+        for(std::size_t i = 0; i < positions.size(); i++)
+        {
+            if(positions[i] >= this->size() ||
+               (i != 0 && positions[i] <= positions[i - 1]))
+            {
+                throw std::runtime_error("Powerful agents must be given in"
+                                         " ascending order, once each!");
+            }
+        }
+
+        // Only the flags of the previous powerful agents need resetting.
+        for(const auto index : m_powerIndex)
+        {
+            m_powerful[index] = 0;
+        }
+
+        for(const auto index : positions)
+        {
+            m_powerful[index] = 1;
+        }
+
+        m_powerIndex.swap(positions);
+    }
+
+    void AgentStore::sortOutGroupInteractions()
+    {
+        for(auto& table : m_outGroupInteractions)
+        {
+            table.sort();
+        }
+    }
+
+    void forEachInteraction(const AgentStore& agents, AgentID totalAgents,
+                            const std::function<void(AgentID, AgentID,
+                                                     const Interaction&)>&
+                            visit)
+    {
+        const auto& uids = agents.getUIds();
+
+        // Edge counters exist for every network connection, but only those
+        // that were actually used are visited.
+        if(agents.isFrozen())
+        {
+            const auto& offsets = agents.getNetworkOffsets();
+            const auto& targets = agents.getNetworkTargets();
+            const auto& edges   = agents.getEdgeInteractions();
+
+            for(AgentID i = 0; i < totalAgents; i++)
+            {
+                const auto id = uids[i];
+
+                for(auto e = offsets[i]; e < offsets[i + 1]; e++)
+                {
+                    if(edges[e].m_communicated != 0)
+                    {
+                        visit(id, uids[targets[e]], edges[e]);
+                    }
+                }
+            }
+        }
+
+        for(const auto& table : agents.getOutGroupShards())
+        {
+            for(const auto& comm : table)
+            {
+                visit(uids[comm.m_from], uids[comm.m_to], comm.m_counts);
+            }
+        }
+    }
+}
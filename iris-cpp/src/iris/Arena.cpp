@@ -0,0 +1,80 @@
+#include "iris/Arena.hpp"
+
+#include <algorithm>
+
+namespace iris
+{
+    const std::size_t ScratchArena::DefaultCapacity;
+
+    ScratchArena::ScratchArena(std::size_t capacity)
+        : m_offset(0), m_spilled(0)
+    {
+        capacity = std::max(capacity, static_cast<std::size_t>(64));
+
+        m_blocks.reserve(4);
+        m_blocks.push_back(Block{
+            std::unique_ptr<types::uint8[]>(new types::uint8[capacity]),
+            capacity});
+    }
+
+    ScratchArena::ScratchArena(const ScratchArena& arena)
+        : ScratchArena(arena.getCapacity())
+    {}
+
+    ScratchArena::~ScratchArena()
+    {}
+
+    void* ScratchArena::allocateBytes(std::size_t bytes, std::size_t alignment)
+    {
+        auto block   = &m_blocks.back();
+        auto aligned = (m_offset + alignment - 1) & ~(alignment - 1);
+
+        if(aligned + bytes > block->m_size)
+        {
+            // Blocks come from new[], so they start suitably aligned for
+            // anything.
+            const auto size = std::max(block->m_size * 2, bytes);
+
+            m_spilled += m_offset;
+            m_blocks.push_back(Block{
+                std::unique_ptr<types::uint8[]>(new types::uint8[size]),
+                size});
+
+            block   = &m_blocks.back();
+            aligned = 0;
+        }
+
+        m_offset = aligned + bytes;
+
+        return block->m_data.get() + aligned;
+    }
+
+    std::size_t ScratchArena::getCapacity() const
+    {
+        std::size_t capacity = 0;
+
+        for(const auto& block : m_blocks)
+        {
+            capacity += block.m_size;
+        }
+
+        return capacity;
+    }
+
+    void ScratchArena::reset()
+    {
+        // Replace a chain of blocks with one that would have sufficed.
+        if(m_blocks.size() > 1)
+        {
+            const auto capacity = this->getCapacity();
+
+            m_blocks.clear();
+            m_blocks.push_back(Block{
+                std::unique_ptr<types::uint8[]>(new types::uint8[capacity]),
+                capacity});
+        }
+
+        m_offset  = 0;
+        m_spilled = 0;
+    }
+}
@@ -0,0 +1,91 @@
+#include "iris/AttributeCodec.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+#include "iris/Utils.hpp"
+
+namespace iris
+{
+    AttributeCodec::AttributeCodec()
+        : m_width(0)
+    {}
+
+    AttributeCodec::AttributeCodec(const Uint32List& ranges)
+        : m_ranges(ranges), m_width(0)
+    {
+        const auto wordBits =
+            static_cast<types::uint32>(std::numeric_limits<Word>::digits);
+
+        m_masks.reserve(ranges.size());
+        m_shifts.reserve(ranges.size());
+
+        for(auto& range : ranges)
+        {
+            // The number of bits needed to represent the largest choice.
+            types::uint32 bits = 0;
+
+            for(auto largest = (range > 0) ? range - 1 : 0; largest != 0;
+                largest >>= 1)
+            {
+                bits++;
+            }
+
+            if(m_width + bits > wordBits)
+            {
+                throw std::runtime_error("Attribute ranges need more than " +
+                                         util::toString(wordBits) +
+                                         " bits; rebuild with"
+                                         " IRIS_USE_64BIT_ATTRIBUTES.");
+            }
+
+            m_masks.push_back(bits == wordBits ?
+                              std::numeric_limits<Word>::max() :
+                              (static_cast<Word>(1) << bits) - 1);
+            m_shifts.push_back(m_width);
+            m_width += bits;
+        }
+    }
+
+    AttributeCodec::~AttributeCodec()
+    {}
+
+    Uint32List AttributeCodec::decode(Word word) const
+    {
+        Uint32List list(m_ranges.size());
+
+        for(Uint32List::size_type i = 0; i < list.size(); i++)
+        {
+            list[i] = this->get(word, static_cast<types::uint32>(i));
+        }
+
+        return list;
+    }
+
+    AttributeCodec::Word AttributeCodec::encode(const Uint32List& list) const
+    {
+        if(list.size() != m_ranges.size())
+        {
+            throw std::runtime_error("Attribute list does not match the"
+                                     " number of encoded variables!");
+        }
+
+        Word word = 0;
+
+        for(Uint32List::size_type i = 0; i < list.size(); i++)
+        {
+            const auto outOfRange = (m_ranges[i] > 0) ?
+                (list[i] >= m_ranges[i]) : (list[i] != 0);
+
+            if(outOfRange)
+            {
+                throw std::runtime_error("Attribute is out of range: " +
+                                         util::toString(list[i]));
+            }
+
+            word = this->set(word, static_cast<types::uint32>(i), list[i]);
+        }
+
+        return word;
+    }
+}
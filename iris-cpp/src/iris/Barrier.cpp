@@ -0,0 +1,138 @@
+#include "iris/Barrier.hpp"
+
+#include <chrono>
+#include <climits>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace iris
+{
+    const types::uint32 StepBarrier::DefaultSpins;
+
+    StepBarrier::StepBarrier(types::uint32 parties)
+        : StepBarrier(parties, (std::thread::hardware_concurrency() > 1) ?
+                      DefaultSpins : 0)
+    {}
+
+    StepBarrier::StepBarrier(types::uint32 parties, types::uint32 spins)
+        : m_parties(0), m_spins(spins)
+    {
+        m_arrived    = 0;
+        m_generation = 0;
+        m_sleepers   = 0;
+
+        this->reset(parties);
+    }
+
+    StepBarrier::~StepBarrier()
+    {}
+
+    void StepBarrier::relax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    void StepBarrier::reset(types::uint32 parties)
+    {
+        if(parties == 0)
+        {
+            throw std::runtime_error("A barrier needs at least one party!");
+        }
+
+        m_parties = parties;
+        m_arrived = 0;
+    }
+
+    void StepBarrier::sleep(types::uint32 generation)
+    {
+#ifdef __linux__
+        static_assert(sizeof(m_generation) == sizeof(int),
+                      "The generation counter cannot be used as a futex.");
+
+        while(m_generation == generation)
+        {
+            // Returns immediately if the generation has already moved on.
+            syscall(SYS_futex, reinterpret_cast<int*>(&m_generation),
+                    FUTEX_WAIT_PRIVATE, static_cast<int>(generation),
+                    nullptr, nullptr, 0);
+        }
+#else
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_wake.wait(lock, [this, generation]() {
+            return m_generation != generation;
+        });
+#endif
+    }
+
+    types::uint64 StepBarrier::wait()
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        const auto start      = Clock::now();
+        const auto generation = m_generation.load();
+
+        if(m_arrived.fetch_add(1) + 1 == m_parties)
+        {
+            // The last one in opens the barrier for everybody else.  The
+            // count must be reset before the generation moves on, since
+            // anybody who sees the new generation may arrive again at once.
+            m_arrived = 0;
+            m_generation.fetch_add(1);
+
+            if(m_sleepers != 0)
+            {
+                this->wakeAll();
+            }
+
+            return 0;
+        }
+
+        for(types::uint32 i = 0; i < m_spins; i++)
+        {
+            if(m_generation != generation)
+            {
+                break;
+            }
+
+            StepBarrier::relax();
+        }
+
+        if(m_generation == generation)
+        {
+            // Announce the intent to sleep *before* checking once more, so
+            // that the last thread either sees a sleeper or this thread sees
+            // the new generation.
+            m_sleepers += 1;
+            this->sleep(generation);
+            m_sleepers -= 1;
+        }
+
+        const auto elapsed = Clock::now() - start;
+
+        return static_cast<types::uint64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                .count());
+    }
+
+    void StepBarrier::wakeAll()
+    {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<int*>(&m_generation),
+                FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+        // Taking the lock ensures no sleeper is between its check and its
+        // wait.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_all();
+#endif
+    }
+}
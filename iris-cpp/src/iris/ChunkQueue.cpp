@@ -0,0 +1,94 @@
+#include "iris/ChunkQueue.hpp"
+
+#include <stdexcept>
+
+namespace iris
+{
+    ChunkQueue::ChunkQueue()
+        : m_first(0), m_last(0)
+    {
+        m_range = 0;
+    }
+
+    ChunkQueue::~ChunkQueue()
+    {}
+
+    void ChunkQueue::assign(types::uint32 first, types::uint32 last)
+    {
+        if(first > last)
+        {
+            throw std::runtime_error("Chunk range is ill-formed - the start"
+                                     " is greater than the end.");
+        }
+
+        m_first = first;
+        m_last  = last;
+
+        this->refill();
+    }
+
+    bool ChunkQueue::pop(types::uint32& chunk)
+    {
+        auto range = m_range.load();
+
+        while(true)
+        {
+            const auto front = static_cast<types::uint32>(range >> 32);
+            const auto back  = static_cast<types::uint32>(range);
+
+            if(front >= back)
+            {
+                return false;
+            }
+
+            const auto next = (static_cast<types::uint64>(front + 1) << 32)
+                | back;
+
+            // On failure, range is reloaded and the claim retried.
+            if(m_range.compare_exchange_weak(range, next))
+            {
+                chunk = front;
+                return true;
+            }
+        }
+    }
+
+    void ChunkQueue::refill()
+    {
+        m_range = (static_cast<types::uint64>(m_first) << 32) | m_last;
+    }
+
+    types::uint32 ChunkQueue::size() const
+    {
+        const auto range = m_range.load();
+        const auto front = static_cast<types::uint32>(range >> 32);
+        const auto back  = static_cast<types::uint32>(range);
+
+        return (front < back) ? (back - front) : 0;
+    }
+
+    bool ChunkQueue::steal(types::uint32& chunk)
+    {
+        auto range = m_range.load();
+
+        while(true)
+        {
+            const auto front = static_cast<types::uint32>(range >> 32);
+            const auto back  = static_cast<types::uint32>(range);
+
+            if(front >= back)
+            {
+                return false;
+            }
+
+            const auto next = (static_cast<types::uint64>(front) << 32)
+                | (back - 1);
+
+            if(m_range.compare_exchange_weak(range, next))
+            {
+                chunk = back - 1;
+                return true;
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include "iris/DeltaBuffer.hpp"
+
+namespace iris
+{
+    const types::uint32 DeltaBuffer::Privileged;
+
+    DeltaBuffer::DeltaBuffer()
+        : m_buckets(AgentStore::ShardCount), m_privileged(0)
+    {}
+
+    DeltaBuffer::~DeltaBuffer()
+    {}
+
+    void DeltaBuffer::clearTally()
+    {
+        m_privileged = 0;
+        m_transitions.clear();
+    }
+
+    void DeltaBuffer::merge(AgentStore& agents, types::uint32 firstShard,
+                            types::uint32 lastShard)
+    {
+        auto& privileges = agents.getPrivileges();
+
+        for(auto shard = firstShard; shard < lastShard; shard++)
+        {
+            auto& bucket = m_buckets[shard];
+
+            for(auto& record : bucket)
+            {
+                if(record.m_kind == Privileged)
+                {
+                    privileges[record.m_from]++;
+                    continue;
+                }
+
+                auto& comm = agents[record.m_from]
+                    .getInteractionsWith(record.m_to);
+
+                switch(record.m_kind)
+                {
+                    case Agent::CommType::Censored:
+                        comm.m_censored++;
+                        break;
+                    case Agent::CommType::Reinforced:
+                        comm.m_reinforced++;
+                        break;
+                }
+
+                comm.m_communicated++;
+            }
+
+            bucket.clear();
+        }
+    }
+
+    void DeltaBuffer::reserve(std::size_t records, std::size_t transitions)
+    {
+        m_transitions.reserve(transitions);
+
+        const auto perShard = (records + m_buckets.size() - 1) /
+            m_buckets.size();
+
+        for(auto& bucket : m_buckets)
+        {
+            bucket.reserve(perShard);
+        }
+    }
+
+    std::size_t DeltaBuffer::size() const
+    {
+        std::size_t total = 0;
+
+        for(auto& bucket : m_buckets)
+        {
+            total += bucket.size();
+        }
+
+        return total;
+    }
+}
@@ -0,0 +1,133 @@
+#include "iris/InteractionTable.hpp"
+
+#include <algorithm>
+
+namespace iris
+{
+    InteractionTable::InteractionTable()
+    {}
+
+    InteractionTable::~InteractionTable()
+    {}
+
+    void InteractionTable::clear()
+    {
+        m_entries.clear();
+        m_slots.clear();
+    }
+
+    const Interaction* InteractionTable::find(AgentID from, AgentID to) const
+    {
+        if(m_slots.empty())
+        {
+            return nullptr;
+        }
+
+        const auto mask = m_slots.size() - 1;
+
+        for(auto slot = this->hash(from, to) & mask; m_slots[slot] != 0;
+            slot = (slot + 1) & mask)
+        {
+            const auto& entry = m_entries[m_slots[slot] - 1];
+
+            if(entry.m_from == from && entry.m_to == to)
+            {
+                return &entry.m_counts;
+            }
+        }
+
+        return nullptr;
+    }
+
+    Interaction& InteractionTable::get(AgentID from, AgentID to)
+    {
+        // Keep the load factor at or below one half.
+        if((m_entries.size() + 1) * 2 > m_slots.size())
+        {
+            this->rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+        }
+
+        const auto mask = m_slots.size() - 1;
+        auto       slot = this->hash(from, to) & mask;
+
+        for(; m_slots[slot] != 0; slot = (slot + 1) & mask)
+        {
+            auto& entry = m_entries[m_slots[slot] - 1];
+
+            if(entry.m_from == from && entry.m_to == to)
+            {
+                return entry.m_counts;
+            }
+        }
+
+        m_entries.push_back(Entry{from, to, Interaction{}});
+        m_slots[slot] = m_entries.size();
+
+        return m_entries.back().m_counts;
+    }
+
+    std::size_t InteractionTable::hash(AgentID from, AgentID to) const
+    {
+        // A 64-bit finalizer (from SplitMix64) over both identifiers.
+        auto h = static_cast<types::uint64>(from) * 0x9E3779B97F4A7C15ULL;
+
+        h ^= static_cast<types::uint64>(to) + 0x632BE59BD9B4E019ULL;
+        h  = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h  = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        h ^= (h >> 31);
+
+        return static_cast<std::size_t>(h);
+    }
+
+    void InteractionTable::rehash(std::size_t capacity)
+    {
+        m_slots.assign(capacity, 0);
+
+        const auto mask = capacity - 1;
+
+        for(std::size_t i = 0; i < m_entries.size(); i++)
+        {
+            auto slot = this->hash(m_entries[i].m_from, m_entries[i].m_to)
+                & mask;
+
+            while(m_slots[slot] != 0)
+            {
+                slot = (slot + 1) & mask;
+            }
+
+            m_slots[slot] = i + 1;
+        }
+    }
+
+    void InteractionTable::reserve(std::size_t count)
+    {
+        std::size_t capacity = m_slots.empty() ? 16 : m_slots.size();
+
+        while(count * 2 > capacity)
+        {
+            capacity *= 2;
+        }
+
+        if(capacity != m_slots.size())
+        {
+            this->rehash(capacity);
+        }
+
+        m_entries.reserve(count);
+    }
+
+    void InteractionTable::sort()
+    {
+        std::sort(m_entries.begin(), m_entries.end(),
+                  [](const Entry& lhs, const Entry& rhs) {
+                      return (lhs.m_from != rhs.m_from) ?
+                          (lhs.m_from < rhs.m_from) : (lhs.m_to < rhs.m_to);
+                  });
+
+        // Every entry has moved, so the index must be rebuilt.
+        if(!m_slots.empty())
+        {
+            this->rehash(m_slots.size());
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#include "iris/MappedFile.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace iris
+{
+    MappedFile::MappedFile()
+        : m_data(nullptr), m_size(0)
+    {}
+
+    MappedFile::MappedFile(const std::string& filename)
+        : m_data(nullptr), m_size(0)
+    {
+#ifdef __linux__
+        const auto fd = open(filename.c_str(), O_RDONLY);
+
+        if(fd < 0)
+        {
+            throw std::runtime_error("Could not open " + filename);
+        }
+
+        struct stat info;
+
+        if(fstat(fd, &info) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Could not inspect " + filename);
+        }
+
+        m_size = static_cast<std::size_t>(info.st_size);
+
+        if(m_size != 0)
+        {
+            const auto memory = mmap(nullptr, m_size, PROT_READ, MAP_SHARED,
+                                     fd, 0);
+
+            if(memory == MAP_FAILED)
+            {
+                close(fd);
+                throw std::runtime_error("Could not map " + filename);
+            }
+
+            m_data = static_cast<const types::uint8*>(memory);
+        }
+
+        // The mapping keeps the file alive on its own.
+        close(fd);
+#else
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+
+        if(!file)
+        {
+            throw std::runtime_error("Could not open " + filename);
+        }
+
+        m_size = static_cast<std::size_t>(file.tellg());
+
+        if(m_size != 0)
+        {
+            m_buffer.reset(new types::uint8[m_size]);
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(m_buffer.get()), m_size);
+
+            m_data = m_buffer.get();
+        }
+#endif
+    }
+
+    MappedFile::MappedFile(MappedFile&& file)
+        : m_data(file.m_data), m_buffer(std::move(file.m_buffer)),
+          m_size(file.m_size)
+    {
+        file.m_data = nullptr;
+        file.m_size = 0;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        this->release();
+    }
+
+    MappedFile& MappedFile::operator = (MappedFile&& file)
+    {
+        if(this != &file)
+        {
+            this->release();
+
+            m_data   = file.m_data;
+            m_buffer = std::move(file.m_buffer);
+            m_size   = file.m_size;
+
+            file.m_data = nullptr;
+            file.m_size = 0;
+        }
+
+        return *this;
+    }
+
+    void MappedFile::release()
+    {
+#ifdef __linux__
+        if(m_data != nullptr)
+        {
+            munmap(const_cast<types::uint8*>(m_data), m_size);
+        }
+#endif
+
+        m_buffer.reset();
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
@@ -1,7 +1,6 @@
 #include "iris/Model.hpp"
 
 #include <iostream>
-#include <numeric>
 #include <random>
 #include <stdexcept>
 #include <string>
@@ -11,7 +10,8 @@
 #include "iris/Types.hpp"
 
 #include "iris/gen/AttributeGenerator.hpp"
-#include "iris/gen/GraphGenerator.hpp"
+#include "iris/gen/GraphBuilder.hpp"
+#include "iris/gen/Ordering.hpp"
 
 #include "iris/io/CommandLine.hpp"
 
@@ -19,6 +19,7 @@
 #include "iris/io/reader/ValueReader.hpp"
 
 #include "iris/io/writer/AttributeWriter.hpp"
+#include "iris/io/writer/BarrierWriter.hpp"
 #include "iris/io/writer/CommWriter.hpp"
 #include "iris/io/writer/NetworkWriter.hpp"
 #include "iris/io/writer/PowerWriter.hpp"
@@ -26,8 +27,15 @@
 namespace iris
 {
     Model::Model()
-    : m_agents(NULL)
-    {}
+        : m_format(io::OutputFormat::Csv), m_run(0),
+          m_affinity(AffinityPolicy::None), m_blockSize(0),
+          m_checkInterval(0), m_chunkSize(64), m_incremental(false),
+          m_ordering(gen::Ordering::None), m_queueDepth(8), m_sparse(false),
+          m_sparseLimit(0), m_numThreads(1)
+    {
+        m_params.m_seed = 0;
+        m_time          = 0;
+    }
 
     Model::~Model()
     {}
@@ -45,7 +53,8 @@ namespace iris
                 continue;
             }
 
-            for(Agent::Network::size_type j = 0; j < (network.size() - 1); j++)
+            for(Agent::NetworkView::size_type j = 0; j < (network.size() - 1);
+                j++)
             {                
                 if(network[j] == network[j + 1])
                 {
@@ -72,6 +81,33 @@ namespace iris
     }
 #endif
 
+    io::Metadata Model::createMetadata() const
+    {
+        using namespace iris::util;
+
+        const auto toList = [](const Uint32List& list) {
+            std::string text;
+
+            for(Uint32List::size_type i = 0; i < list.size(); i++)
+            {
+                text += (i == 0 ? "" : ",") + toString(list[i]);
+            }
+
+            return text;
+        };
+
+        return io::Metadata{
+            {"program", "iris"},
+            {"run", toString(m_run)},
+            {"seed", toString(m_params.m_seed)},
+            {"agents", toString(m_params.m_n)},
+            {"steps", toString(m_params.m_steps)},
+            {"threads", toString(m_numThreads)},
+            {"values", toList(m_values)},
+            {"behaviors", toList(m_behaviors)}
+        };
+    }
+
     std::string Model::createPathToData(std::string file) const
     {
         return m_dataDir + "/" + file;
@@ -84,10 +120,22 @@ namespace iris
     
     void Model::generateGraphStructure()
     {
-        gen::wireGraph(m_agents, m_params.m_n, m_census,
-                       m_params.m_outConnections,
-                       m_params.m_prob, m_params.m_recip,
-                       m_random);
+        // The graph is fixed from here on, so it is built directly in the
+        // compact form used by the simulation.
+        gen::GraphBuilder builder(m_params.m_n, m_census,
+                                  m_params.m_outConnections,
+                                  m_params.m_prob, m_params.m_recip,
+                                  m_params.m_seed);
+
+        if(m_blockSize == 0)
+        {
+            builder.build(m_agents, m_numThreads);
+        }
+        else
+        {
+            builder.stream(m_agents, this->createPathToData("network.bin"),
+                           m_blockSize, m_numThreads);
+        }
 
 #ifdef IRIS_DEBUG
         this->checkForDuplicates();
@@ -98,11 +146,29 @@ namespace iris
     void Model::generateAttributes()
     {
         gen::generateAttributes(m_agents, m_params.m_n, m_values, m_behaviors,
-                                m_random);
+                                m_params.m_seed, m_numThreads);
         gen::generatePowerfulAgents(m_agents, m_params.m_n,
-                                    m_params.m_powerPercent, true, m_random);
+                                    m_params.m_powerPercent, true,
+                                    m_params.m_seed);
     }
     
+    void Model::renumberAgents()
+    {
+        if(m_ordering == gen::Ordering::None)
+        {
+            return;
+        }
+
+        // Attributes and power were assigned by unique identifier, so they
+        // simply move along with their agents.
+        m_agents.renumber(gen::computeOrder(m_agents, m_ordering));
+
+#ifdef IRIS_DEBUG
+        this->checkForDuplicates();
+        this->checkForLoops();
+#endif
+    }
+
     void Model::setUpParams(const io::Options& options)
     {
         using namespace iris::io;
@@ -111,6 +177,63 @@ namespace iris
 
         // Which run is this?
         const auto run = options.get<types::uint32>("run");
+
+        m_run = run;
+
+        // Should results be written as CSV or binary column files?
+        m_format = options.has("format") ?
+            parseOutputFormat(options.get<std::string>("format")) :
+            OutputFormat::Csv;
+
+        // How many threads to step agents with (serial by default)?
+        m_numThreads = options.has("threads") ?
+            options.get<types::uint32>("threads") : 1;
+
+        if(m_numThreads == 0)
+        {
+            throw std::runtime_error("The number of threads must be at least"
+                                     " one.");
+        }
+
+        // How many agents should a worker take from a queue at once?
+        m_chunkSize = options.has("chunk") ?
+            options.get<AgentID>("chunk") : 64;
+
+        if(m_chunkSize == 0)
+        {
+            throw std::runtime_error("The chunk size must be at least one.");
+        }
+
+        // Should statistics follow the changes of each step, and how often
+        // should they be checked against a full count?
+        m_incremental   = options.has("incremental");
+        m_checkInterval = m_incremental ?
+            options.get<uint64>("incremental") : 0;
+
+        // Should statistics only count the permutations of behaviors that
+        // somebody holds, and write how many of them?
+        m_sparse      = options.has("sparse");
+        m_sparseLimit = m_sparse ? options.get<uint64>("sparse") : 0;
+
+        // Should statistics be written on a background thread, and through
+        // a queue of how many steps?
+        m_queueDepth = options.has("queue") ?
+            options.get<uint32>("queue") : 8;
+
+        // Should the graph be streamed to disk, and in blocks of how many
+        // agents?
+        m_blockSize = options.has("stream") ?
+            options.get<AgentID>("stream") : 0;
+
+        // Should workers (and their agents) be pinned to the machine?
+        m_affinity = options.has("affinity") ?
+            Topology::parsePolicy(options.get<std::string>("affinity")) :
+            AffinityPolicy::None;
+
+        // Should the population be renumbered for locality?
+        m_ordering = options.has("order") ?
+            gen::parseOrdering(options.get<std::string>("order")) :
+            gen::Ordering::None;
         
         // Set up the directory structure, first.
         m_parentDir = options.get<std::string>("directory");
@@ -150,54 +273,122 @@ namespace iris
 
     void Model::setUpAgents()
     {
-        if(m_agents)
-        {
-            throw std::runtime_error("Agents have already been initialized!");
-        }
-        
-        // Create the array and then assign correct ids.
-        //
-        // Because we are using a single dynamic array for this, there is no
-        // other way to do so.
-        m_agents = new Agent[m_params.m_n];
-
-        for(auto i = (AgentID)0; i < m_params.m_n; i++)
-        {
-            m_agents[i].setUId(i);
-        }
-
-        m_indices.resize(m_params.m_n);
-        std::iota(m_indices.begin(), m_indices.end(), 0);
+        // Allocate every column at once; each agent's unique id is its
+        // initial position in the store.
+        m_agents.initialize(m_params.m_n, m_values, m_behaviors);
     }
     
     void Model::setUpRandom(types::uint64 seed)
     {
-        m_random = types::mersenne_twister(seed);
+        m_params.m_seed = seed;
     }
 
     void Model::setUpIoStreams()
     {
         using namespace iris::io;
         
+        // Every file is described the same way, now that the seed is known.
+        m_metadata = this->createMetadata();
+
+        const auto extension = getExtension(m_format);
+
         // Write the initial graph data (for posterity).
         //
         // We name it something different than normal (e.g. not vertices-0.csv)
         // to make it easy to find.
-        writeAttributes(this->createPathToData("original-attributes.csv"),
-                        m_agents, m_params.m_n);
-        writeNetwork(this->createPathToData("original-network.csv"),
-                     m_agents, m_params.m_n);
+        writeAttributes(this->createPathToData("original-attributes" +
+                                               extension),
+                        m_agents, m_params.m_n, m_format, m_metadata);
+        writeNetwork(this->createPathToData("original-network" + extension),
+                     m_agents, m_params.m_n, m_format, m_metadata);
         
         // Set up the (running) statistics file.
-        m_statsFile = std::ofstream(this->createPathToData("statistics.csv"));
+        m_statsFile = std::ofstream(
+            this->createPathToData("statistics" + extension),
+            (m_format == OutputFormat::Binary) ?
+            std::ios::out | std::ios::binary : std::ios::out);
 
         // Disable the separator.
         m_statsFile.imbue(std::locale(m_statsFile.getloc(),
                                       new disable_thousands_sep()));
         
-        m_statistics.initialize(m_behaviors);
-        m_statistics.writeHeader(m_statsFile);
-        m_statistics.writeStatistics(m_statsFile, m_agents, m_params.m_n, 0);
+        if(m_sparse)
+        {
+            m_statistics.initializeSparse(m_behaviors, m_numThreads,
+                                          m_sparseLimit);
+        }
+        else
+        {
+            m_statistics.initialize(m_behaviors, m_numThreads);
+        }
+
+        if(m_format == OutputFormat::Binary)
+        {
+            m_statsColumns.reset(new ColumnWriter(m_statsFile,
+                                                  m_statistics.getColumns(),
+                                                  m_metadata));
+        }
+        else
+        {
+            m_statistics.writeHeader(m_statsFile);
+        }
+
+        // Hand every step (from the first) to the background writer, if
+        // there is one, so that the simulation never waits on the disk.
+        if(m_queueDepth != 0 && m_statsColumns)
+        {
+            m_statsWriter.reset(new AsyncStatisticsWriter(m_statistics,
+                                                          *m_statsColumns,
+                                                          m_queueDepth));
+        }
+        else if(m_queueDepth != 0)
+        {
+            m_statsWriter.reset(new AsyncStatisticsWriter(m_statistics,
+                                                          m_statsFile,
+                                                          m_queueDepth));
+        }
+
+        m_statistics.count(m_agents, m_params.m_n);
+        this->recordStatistics();
+    }
+
+    void Model::setUpThreading()
+    {
+        // The delta buffers grow to the size of a step during the first
+        // steps and keep their capacity after, so nothing is reserved for
+        // the worst case up front.
+        if(m_numThreads <= 1)
+        {
+            return;
+        }
+
+        if(m_numThreads > m_params.m_n)
+        {
+            throw std::runtime_error("There are more threads than agents: " +
+                                     util::toString(m_numThreads));
+        }
+
+        m_controller.initialize(&m_agents, m_params.m_n, m_params, m_behaviors,
+                                m_numThreads, m_chunkSize, m_affinity,
+                                m_time);
+        m_controller.start();
+
+        // Track how long workers wait on each other, per step.
+        if(m_format == io::OutputFormat::Binary)
+        {
+            m_barrierFile = std::ofstream(
+                this->createPathToData("barrier.col"),
+                std::ios::out | std::ios::binary);
+            m_barrierColumns.reset(new io::ColumnWriter(
+                m_barrierFile, io::getBarrierColumns(m_numThreads),
+                m_metadata));
+        }
+        else
+        {
+            m_barrierFile =
+                std::ofstream(this->createPathToData("barrier.csv"));
+            io::writeBarrierHeader(m_barrierFile, m_numThreads);
+        }
     }
 
     void Model::runSimulation()
@@ -215,26 +406,113 @@ namespace iris
             std::cout << "Starting time: " << m_time << std::endl;
             std::cout << "Signaling workers from main thread." << std::endl;
 #endif
-            std::shuffle(m_indices.begin(), m_indices.end(), m_random);
+            if(m_controller.isInitialized())
+            {
+                // Every agent reads from the previous step only, so each
+                // worker can step its own partition in any order.
+                m_controller.signalAll();
+                m_controller.waitForCompletion();
 
-            for(auto& ind : m_indices)
+                if(m_barrierColumns)
+                {
+                    io::writeBarrierWaits(*m_barrierColumns, m_time,
+                                          m_controller.getWaitTimes());
+                }
+                else
+                {
+                    io::writeBarrierWaits(m_barrierFile, m_time,
+                                          m_controller.getWaitTimes());
+                }
+            }
+            else
             {
-                m_agents[ind].step(m_params, m_agents, m_params.m_n,
-                                   m_behaviors, m_time, m_random);
+                m_deltas.clearTally();
+
+                // Each agent draws from its own stream, so the order in which
+                // they are stepped no longer matters.
+                for(AgentID i = 0; i < m_params.m_n; i++)
+                {
+                    m_agents[i].step(m_params, m_agents, m_params.m_n,
+                                     m_behaviors, m_time, m_deltas,
+                                     m_arena);
+                }
+
+                m_deltas.merge(m_agents, 0, AgentStore::ShardCount);
             }
+
+            // Every agent has written its next state, so publish it.
+            m_agents.swapBehaviors();
             
 #ifdef IRIS_DEBUG
             std::cout << "Done waiting for workers." << std::endl;
 #endif
             // Write out to (cumulative) statistics file.
-            m_statistics.writeStatistics(m_statsFile, m_agents,m_params.m_n,
-                                         m_time);
+            if(m_incremental)
+            {
+                this->updateStatistics();
+            }
+            else
+            {
+                m_statistics.count(m_agents, m_params.m_n);
+            }
+
+            this->recordStatistics();
 #ifdef IRIS_DEBUG
             std::cout << "Finishing time: " << m_time << std::endl;
 #endif
         }
     }
     
+    void Model::recordStatistics()
+    {
+        if(m_statsWriter)
+        {
+            m_statsWriter->push(m_time);
+        }
+        else if(m_statsColumns)
+        {
+            m_statistics.write(*m_statsColumns, m_time);
+        }
+        else
+        {
+            m_statistics.write(m_statsFile, m_time);
+        }
+    }
+
+    void Model::updateStatistics()
+    {
+        if(m_controller.isInitialized())
+        {
+            for(auto& deltas : m_controller.getDeltaBuffers())
+            {
+                m_statistics.update(deltas);
+            }
+        }
+        else
+        {
+            m_statistics.update(m_deltas);
+        }
+
+        if(m_checkInterval == 0 || (m_time % m_checkInterval) != 0)
+        {
+            return;
+        }
+
+        // A full count replaces the census either way, so a drift is only
+        // ever written out until the next check.
+        if(!m_statistics.verify(m_agents, m_params.m_n))
+        {
+            using namespace iris::util::term;
+
+            Sequence yellow(Color::Yellow);
+            Sequence def(Color::Default);
+
+            std::cerr << yellow << "*" << def << " Statistics drifted from a"
+                      << " full count at time " << m_time
+                      << " (corrected)." << std::endl;
+        }
+    }
+
     void Model::tearDown()
     {
         using namespace iris::io;
@@ -242,22 +520,74 @@ namespace iris
 #ifdef IRIS_DEBUG
         std::cout << "Tearing down." << std::endl;
 #endif
-        writeAttributes(this->createPathToData("final-attributes.csv"),
-                        m_agents, m_params.m_n);
-        writeComm(this->createPathToData("comm.csv"), m_agents,
-                  m_params.m_n, m_time);
-        writePower(this->createPathToData("power.csv"), m_agents,
-                   m_params.m_n);
+        // Stop (and join) any workers before touching the agents.
+        m_controller.stopAll();
+        m_controller.tearDown();
+
+        // Out-group counters are recorded in whatever order the workers
+        // reached them; put them in a canonical order for the writers.
+        m_agents.sortOutGroupInteractions();
+
+        const auto extension = getExtension(m_format);
+
+        writeAttributes(this->createPathToData("final-attributes" +
+                                               extension),
+                        m_agents, m_params.m_n, m_format, m_metadata);
+        writeComm(this->createPathToData("comm" + extension), m_agents,
+                  m_params.m_n, m_time, m_format, m_metadata);
+        writePower(this->createPathToData("power" + extension), m_agents,
+                   m_params.m_n, m_format, m_metadata);
       
-        if(m_agents)
+        m_agents.clear();
+
+        // Let the background writer catch up before the files it writes to
+        // are closed.
+        if(m_statsWriter)
         {
-            delete[] m_agents;
-            m_agents = NULL;
+            m_statsWriter->close();
+
+            const auto metrics = m_statsWriter->getMetrics();
+
+            writeQueueMetrics(this->createPathToData("statistics-queue" +
+                                                     extension),
+                              metrics, m_format, m_metadata);
+            m_statsWriter.reset();
+
+            if(metrics.m_stalls != 0)
+            {
+                using namespace iris::util::term;
+
+                Sequence yellow(Color::Yellow);
+                Sequence def(Color::Default);
+
+                std::cerr << yellow << "*" << def << " The simulation waited"
+                          << " on the statistics writer " << metrics.m_stalls
+                          << " time(s), for " << metrics.m_stallTime
+                          << " ns in total." << std::endl;
+            }
+        }
+
+        // Column files keep their last rows until flushed.
+        if(m_statsColumns)
+        {
+            m_statsColumns->flush();
+            m_statsColumns.reset();
+        }
+
+        if(m_barrierColumns)
+        {
+            m_barrierColumns->flush();
+            m_barrierColumns.reset();
         }
 
         if(m_statsFile.is_open())
         {
             m_statsFile.close();
         }
+
+        if(m_barrierFile.is_open())
+        {
+            m_barrierFile.close();
+        }
     }
 }
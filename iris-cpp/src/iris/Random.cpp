@@ -0,0 +1,84 @@
+#include "iris/Random.hpp"
+
+namespace iris
+{
+    const types::uint64 CounterRandom::FamilyStep;
+    const types::uint64 CounterRandom::OutGroupStep;
+    const types::uint64 CounterRandom::AttributeStep;
+    const types::uint64 CounterRandom::PowerStep;
+    const types::uint64 CounterRandom::ShuffleStep;
+
+    CounterRandom::CounterRandom(types::uint64 seed, types::uint64 stream,
+                                 types::uint64 step)
+        : m_used(4)
+    {
+        // The first word counts blocks; the rest identify the stream.
+        m_counter[0] = 0;
+        m_counter[1] = static_cast<types::uint32>(step);
+        m_counter[2] = static_cast<types::uint32>(stream);
+        m_counter[3] = static_cast<types::uint32>(stream >> 32);
+
+        m_key[0] = static_cast<types::uint32>(seed);
+        m_key[1] = static_cast<types::uint32>(seed >> 32);
+    }
+
+    CounterRandom::~CounterRandom()
+    {}
+
+    void CounterRandom::encrypt(types::uint32 counter[4],
+                                const types::uint32 key[2])
+    {
+        using namespace iris::types;
+
+        const uint32 m0 = 0xD2511F53;
+        const uint32 m1 = 0xCD9E8D57;
+        const uint32 w0 = 0x9E3779B9;
+        const uint32 w1 = 0xBB67AE85;
+
+        uint32 k0 = key[0];
+        uint32 k1 = key[1];
+
+        for(auto round = 0; round < 10; round++)
+        {
+            const auto p0 = static_cast<uint64>(m0) * counter[0];
+            const auto p1 = static_cast<uint64>(m1) * counter[2];
+
+            const auto hi0 = static_cast<uint32>(p0 >> 32);
+            const auto lo0 = static_cast<uint32>(p0);
+            const auto hi1 = static_cast<uint32>(p1 >> 32);
+            const auto lo1 = static_cast<uint32>(p1);
+
+            counter[0] = hi1 ^ counter[1] ^ k0;
+            counter[1] = lo1;
+            counter[2] = hi0 ^ counter[3] ^ k1;
+            counter[3] = lo0;
+
+            k0 += w0;
+            k1 += w1;
+        }
+    }
+
+    types::uint64 CounterRandom::getDrawCount() const
+    {
+        // The block counter has already moved past the current block.
+        if(m_counter[0] == 0)
+        {
+            return 0;
+        }
+
+        return static_cast<types::uint64>(m_counter[0] - 1) * 4 + m_used;
+    }
+
+    void CounterRandom::refill()
+    {
+        for(auto i = 0; i < 4; i++)
+        {
+            m_block[i] = m_counter[i];
+        }
+
+        encrypt(m_block, m_key);
+
+        m_counter[0]++;
+        m_used = 0;
+    }
+}
@@ -1,31 +1,35 @@
 #include "iris/Threading.hpp"
 
 #include <algorithm>
-#include <chrono>
-#include <cmath>
 #include <iostream>
-#include <numeric>
 #include <stdexcept>
 
-#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
 #include "iris/Utils.hpp"
 
 namespace iris
 {
-    ThreadWorker::ThreadWorker(std::atomic<types::uint32>& complete,
+    ThreadWorker::ThreadWorker(StepBarrier& step, StepBarrier& merge,
                                std::atomic<types::uint64>& time)
-        : m_complete(complete), m_time(time)
+        : m_agents(nullptr), m_chunkSize(0), m_deltas(nullptr), m_id(0),
+          m_merge(merge), m_placement{-1, -1}, m_queues(nullptr), m_slot(0),
+          m_step(step), m_time(time), m_totalAgents(0), m_waited(0)
     {
         m_running = false;
-        m_signal  = false;
     }
 
     ThreadWorker::ThreadWorker(const ThreadWorker& worker)
-        : m_agents(worker.m_agents), m_complete(worker.m_complete),
-          m_indices(worker.m_indices), m_time(worker.m_time)
+        : m_agents(worker.m_agents), m_arena(worker.m_arena),
+          m_behaviors(worker.m_behaviors),
+          m_chunkSize(worker.m_chunkSize), m_deltas(worker.m_deltas),
+          m_id(worker.m_id), m_merge(worker.m_merge),
+          m_params(worker.m_params), m_placement(worker.m_placement),
+          m_queues(worker.m_queues), m_slot(worker.m_slot),
+          m_step(worker.m_step),
+          m_time(worker.m_time), m_totalAgents(worker.m_totalAgents),
+          m_waited(worker.m_waited)
     {
         m_running = false;
-        m_signal  = false;
     }
 
     ThreadWorker::~ThreadWorker()
@@ -42,9 +46,9 @@ namespace iris
         return m_behaviors;
     }
 
-    std::vector<AgentID> ThreadWorker::getIndices() const
+    AgentID ThreadWorker::getChunkSize() const
     {
-        return m_indices;
+        return m_chunkSize;
     }
 
     Parameters ThreadWorker::getParameters() const
@@ -52,27 +56,36 @@ namespace iris
         return m_params;
     }
 
+    Placement ThreadWorker::getPlacement() const
+    {
+        return m_placement;
+    }
+
     types::uint64 ThreadWorker::getTime() const
     {
         return m_time;
     }
 
-    void ThreadWorker::initialize(Agent* agents, AgentID start,
-                                  AgentID end, Parameters params,
+    types::uint64 ThreadWorker::getWaitTime() const
+    {
+        return m_waited;
+    }
+
+    void ThreadWorker::initialize(AgentStore* agents, AgentID totalAgents,
+                                  AgentID chunkSize, Parameters params,
                                   BehaviorList behaviors)
     {
-        if(start >= end)
+        if(totalAgents == 0 || chunkSize == 0)
         {
-            throw std::runtime_error("Interval is ill-formed - the end"
-                                     " is greater than or equal to the start.");
+            throw std::runtime_error("Workers need at least one agent and a"
+                                     " chunk size of at least one.");
         }
         
-        m_agents    = agents;
-        m_behaviors = behaviors;
-        m_params    = params;
-        
-        m_indices.resize(end - start);
-        std::iota(m_indices.begin(), m_indices.end(), start);
+        m_agents      = agents;
+        m_behaviors   = behaviors;
+        m_chunkSize   = chunkSize;
+        m_params      = params;
+        m_totalAgents = totalAgents;
     }
 
     void ThreadWorker::join()
@@ -83,50 +96,107 @@ namespace iris
         }
     }
 
-    void ThreadWorker::prepareRandom()
+    void ThreadWorker::pin(const Placement& placement)
     {
-        const auto time = std::chrono::high_resolution_clock::now()
-               .time_since_epoch().count();
-        const auto seed =
-            std::abs(((time * 181) * ((m_id * 83) * 359)) % 104729);
-
-        // Re-initialize.
-        m_random = types::mersenne_twister(seed);
+        m_placement = placement;
     }
-    
+
     void ThreadWorker::run()
     {
-        this->prepareRandom();
-        
-        while(m_running)
-        {            
-            // For a signal before doing anything.
-            // *However*, also make the wait dependent on running state.
-            util::spin(m_signal, true, m_running, true,
-                       std::chrono::nanoseconds(1000));
-
-            // Double check that we should be running.
+        if(m_placement.m_cpu >= 0)
+        {
+            Topology::pinCurrentThread(
+                static_cast<types::uint32>(m_placement.m_cpu));
+        }
+
+        // Bring the agents this worker starts each step with onto its own
+        // node, now that they are no longer being written by the main thread.
+        if(m_placement.m_node >= 0)
+        {
+            const auto& queue = (*m_queues)[m_slot];
+            const auto  first = std::min(
+                static_cast<AgentID>(queue.getFirst()) * m_chunkSize,
+                m_totalAgents);
+            const auto  last  = std::min(
+                static_cast<AgentID>(queue.getLast()) * m_chunkSize,
+                m_totalAgents);
+
+            m_agents->moveToNode(first, last, m_placement.m_node);
+        }
+
+        while(true)
+        {
+            // Wait for the controller to start a step (or to stop us).
+            m_step.wait();
+
             if(!m_running) { break; }
 
             // Copy the time for faster access.
             const types::uint64 timeCopy = m_time;
             
-            // Rampage through the agent array and update everything.
-            for(auto& indice : m_indices)
+            auto&      deltas = *m_deltas;
+            auto&      queues = *m_queues;
+            const auto total  = static_cast<types::uint32>(deltas.size());
+
+            types::uint32 chunk;
+
+            // Start a fresh tally for the statistics of this step.
+            deltas[m_slot].clearTally();
+
+            // Rampage through our own chunks first, front to back...
+            while(queues[m_slot].pop(chunk))
             {
-                m_agents[indice].step(m_params, m_agents, m_params.m_n,
-                                      m_behaviors, timeCopy, m_random);
+                this->stepChunk(chunk, timeCopy);
             }
-            
-            // Reset cycle and begin waiting once more.
-            m_complete += 1;
-            m_signal    = false;
-        }
 
-        // Soft cleanup.
-        m_signal = false;
+            // ...then help everybody else, taking from the back of their
+            // queues so as to stay out of the owner's way.
+            for(types::uint32 i = 1; i < total; i++)
+            {
+                auto& victim = queues[(m_slot + i) % total];
+
+                while(victim.steal(chunk))
+                {
+                    this->stepChunk(chunk, timeCopy);
+                }
+            }
+
+            // Once every worker has stepped, merge this worker's share of the
+            // shards from every buffer; no other worker touches them.
+            //
+            // The time spent waiting here is how far this worker was ahead
+            // of the slowest one.
+            m_waited = m_merge.wait();
+
+            const auto firstShard = AgentStore::ShardCount * m_slot / total;
+            const auto lastShard  =
+                AgentStore::ShardCount * (m_slot + 1) / total;
+
+            for(auto& buffer : deltas)
+            {
+                buffer.merge(*m_agents, firstShard, lastShard);
+            }
+
+            // Report completion to the controller.
+            m_step.wait();
+        }
     }
     
+    void ThreadWorker::share(std::vector<DeltaBuffer>* deltas,
+                             std::vector<ChunkQueue>* queues,
+                             types::uint32 slot)
+    {
+        if(slot >= deltas->size() || slot >= queues->size())
+        {
+            throw std::runtime_error("There is no delta buffer or queue for"
+                                     " slot " + util::toString(slot) + "!");
+        }
+
+        m_deltas = deltas;
+        m_queues = queues;
+        m_slot   = slot;
+    }
+
     void ThreadWorker::start(types::uint32 id)
     {
         if(m_running)
@@ -134,37 +204,75 @@ namespace iris
             throw std::runtime_error("Thread has already been started!");
         }
 
+        if(m_deltas == nullptr || m_queues == nullptr)
+        {
+            throw std::runtime_error("Thread has no delta buffers or"
+                                     " queues!");
+        }
+
         // Save the id.
         m_id = id;
 
         // Start me up!
         m_running = true;
-        m_signal = false;
-        
+
+
         m_thread = std::thread([this]() {
             this->run();
         });
     }
 
+    void ThreadWorker::stepChunk(types::uint32 chunk, types::uint64 time)
+    {
+        const auto first = static_cast<AgentID>(chunk) * m_chunkSize;
+        const auto last  = std::min(first + m_chunkSize, m_totalAgents);
+        auto&      delta = (*m_deltas)[m_slot];
+
+        for(auto i = first; i < last; i++)
+        {
+            (*m_agents)[i].step(m_params, *m_agents, m_params.m_n,
+                                m_behaviors, time, delta, m_arena);
+        }
+    }
+
     void ThreadWorker::stop()
     {
         m_running = false;
     }
 
     ThreadController::ThreadController()
+        : m_running(false)
     {}
 
     ThreadController::~ThreadController()
     {
-        // Use the ThreadWorker destructor to force threads to close.
+        // Release the workers, then use the ThreadWorker destructor to join
+        // them.
+        this->stopAll();
         m_pool.clear();
     }
 
-    void ThreadController::initialize(iris::Agent *agents,
+    std::vector<types::uint64> ThreadController::getWaitTimes() const
+    {
+        std::vector<types::uint64> waits;
+
+        waits.reserve(m_pool.size());
+
+        for(auto& worker : m_pool)
+        {
+            waits.push_back(worker.getWaitTime());
+        }
+
+        return waits;
+    }
+
+    void ThreadController::initialize(AgentStore* agents,
                                       AgentID totalAgents,
                                       const Parameters &params,
                                       BehaviorList behaviors,
                                       types::uint32 numThreads,
+                                      AgentID chunkSize,
+                                      AffinityPolicy affinity,
                                       std::atomic<types::uint64>& time)
     {        
         if(m_pool.size() > 0)
@@ -172,34 +280,60 @@ namespace iris
             throw std::runtime_error("Worker pool has already been"
                                      " initialized!");
         }
+
+        if(chunkSize == 0)
+        {
+            throw std::runtime_error("The chunk size must be at least one.");
+        }
+
+        const auto numChunks =
+            static_cast<types::uint32>((totalAgents + chunkSize - 1) /
+                                       chunkSize);
         
-        const auto spread =
-            static_cast<types::uint32>(std::floor(totalAgents / numThreads));
-        
+        // Every buffer and queue must exist before the workers take its
+        // address (queues cannot be moved, so they are swapped in whole).
+        m_deltas.resize(numThreads);
+        std::vector<ChunkQueue>(numThreads).swap(m_queues);
+
+        // The controller meets the workers at the start and end of each
+        // step; the workers meet among themselves before merging.
+        m_step.reset(numThreads + 1);
+        m_merge.reset(numThreads);
+
+        // Only look at the machine if the workers are to be pinned.
+        const auto placements = (affinity == AffinityPolicy::None) ?
+            std::vector<Placement>(numThreads, Placement{-1, -1}) :
+            Topology().place(numThreads, affinity);
+
         for(types::uint32 i = 0; i < numThreads; i++)
         {
-            const auto lowerBound = static_cast<AgentID>(spread * i);
-            auto       upperBound = static_cast<AgentID>(spread * (i + 1));
+            // Each worker starts out with an even share of the chunks.
+            const auto lowerBound = static_cast<types::uint32>(
+                static_cast<types::uint64>(numChunks) * i / numThreads);
+            const auto upperBound = static_cast<types::uint32>(
+                static_cast<types::uint64>(numChunks) * (i + 1) / numThreads);
             
-            if(i >= (numThreads - 1))
-            {
-                upperBound = totalAgents;
-            }
-            
-            auto worker = ThreadWorker(m_completions, time);
+            auto worker = ThreadWorker(m_step, m_merge, time);
 
-            worker.initialize(agents, lowerBound, upperBound,
-                              params, behaviors);
+            worker.initialize(agents, totalAgents, chunkSize, params,
+                              behaviors);
+            worker.share(&m_deltas, &m_queues, i);
+            worker.pin(placements[i]);
+            m_queues[i].assign(lowerBound, upperBound);
             m_pool.push_back(worker);
         }
     }
 
     void ThreadController::signalAll()
     {
-        for(auto& worker : m_pool)
+        // The workers are parked, so every queue may be refilled safely.
+        for(auto& queue : m_queues)
         {
-            worker.signal();
+            queue.refill();
         }
+
+        // Release the workers from the start of the step.
+        m_step.wait();
     }
 
     void ThreadController::start()
@@ -209,40 +343,39 @@ namespace iris
             const auto id = static_cast<types::uint32>(i + 1);
             m_pool[i].start(id);
         }
+
+        m_running = !m_pool.empty();
     }
 
     void ThreadController::stopAll()
     {
+        if(!m_running)
+        {
+            return;
+        }
+
         for(auto& worker : m_pool)
         {
             worker.stop();
         }
+
+        // The workers are waiting for the next step to start; let them
+        // through so they see that they have been stopped.
+        m_step.wait();
+        m_running = false;
     }
     
     void ThreadController::tearDown()
     {
+        this->stopAll();
+
         m_pool.clear();
+        m_deltas.clear();
+        m_queues.clear();
     }
     
     void ThreadController::waitForCompletion()
     {
-        // Ensure that the completion rate is reset *before* waiting,
-        // otherwise for small networks the threads might complete
-        // in the time between the signal and actual wait.
-        //
-        // Obvious, really, but still.
-        m_completions = 0;
-
-        // Do a quick check to ensure the threads in this pool are
-        // waiting correctly.
-        if(m_completions != 0)
-        {
-            throw std::runtime_error("Completion number was reset before a wait"
-                                     " - some of the threads are not waiting"
-                                     " correctly!");
-        }
-
-        util::spin(m_completions, static_cast<types::uint32>(m_pool.size()),
-                   std::chrono::nanoseconds(1000));
+        m_step.wait();
     }
 }
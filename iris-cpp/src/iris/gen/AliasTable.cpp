@@ -0,0 +1,115 @@
+#include "iris/gen/AliasTable.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace iris
+{
+    namespace gen
+    {
+        AliasTable::AliasTable()
+            : m_mean(0.0)
+        {}
+
+        AliasTable::AliasTable(const std::vector<types::fnumeric>& weights)
+            : m_alias(weights.size()), m_mean(0.0),
+              m_probability(weights.size())
+        {
+            using namespace iris::types;
+
+            types::fnumeric total = 0.0;
+
+            for(const auto weight : weights)
+            {
+                if(weight < 0.0)
+                {
+                    throw std::runtime_error("Alias tables cannot hold"
+                                             " negative weights.");
+                }
+
+                total += weight;
+            }
+
+            if(weights.empty() || total <= 0.0)
+            {
+                throw std::runtime_error("Alias tables need a positive"
+                                         " weight.");
+            }
+
+            const auto n = static_cast<uint32>(weights.size());
+
+            // Scale the weights so they average one, and split the columns
+            // into those below the average and those at or above it.
+            std::vector<uint32> small;
+            std::vector<uint32> large;
+
+            for(uint32 i = 0; i < n; i++)
+            {
+                m_probability[i] = weights[i] * n / total;
+                m_mean          += weights[i] * i / total;
+
+                if(m_probability[i] < 1.0)
+                {
+                    small.push_back(i);
+                }
+                else
+                {
+                    large.push_back(i);
+                }
+            }
+
+            // Top up each small column with part of a large one.
+            while(!small.empty() && !large.empty())
+            {
+                const auto less = small.back();
+                const auto more = large.back();
+
+                small.pop_back();
+
+                m_alias[less]        = more;
+                m_probability[more] -= 1.0 - m_probability[less];
+
+                if(m_probability[more] < 1.0)
+                {
+                    large.pop_back();
+                    small.push_back(more);
+                }
+            }
+
+            // Whatever is left over is full, up to rounding.
+            for(const auto i : large)
+            {
+                m_probability[i] = 1.0;
+                m_alias[i]       = i;
+            }
+
+            for(const auto i : small)
+            {
+                m_probability[i] = 1.0;
+                m_alias[i]       = i;
+            }
+        }
+
+        AliasTable::~AliasTable()
+        {}
+
+        types::uint32 AliasTable::choose(types::fnumeric p) const
+        {
+            if(m_alias.empty())
+            {
+                throw std::runtime_error("Cannot choose from an empty alias"
+                                         " table.");
+            }
+
+            // The whole part of the scaled draw picks the column, and the
+            // fraction decides between the column and its alias.
+            const auto n      = static_cast<types::fnumeric>(m_alias.size());
+            const auto scaled = p * n;
+            const auto column = std::min(static_cast<types::uint32>(scaled),
+                                         this->size() - 1);
+            const auto coin   = scaled - column;
+
+            return (coin < m_probability[column]) ? column : m_alias[column];
+        }
+    }
+}
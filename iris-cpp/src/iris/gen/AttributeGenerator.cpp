@@ -1,5 +1,6 @@
 #include "iris/gen/AttributeGenerator.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <random>
 #include <sstream>
@@ -40,7 +41,7 @@ namespace iris
         }
         
         Uint32List createAttributeList(PopDispensers& dispensers,
-                                      types::mersenne_twister& random)
+                                      CounterRandom& random)
         {
             Uint32List result(dispensers.size());
             
@@ -98,36 +99,78 @@ namespace iris
             return {base.begin(), base.begin() + target.size()};
         }
         
-        void generateAttributes(Agent* const agents, AgentID totalAgents,
+        void generateAttributes(AgentStore& agents, AgentID totalAgents,
                                 ValueList values, BehaviorList behaviors,
-                                types::mersenne_twister& random)
-        {         
-            // Use two population vectors, one for the values and one for the
-            // behaviors.
+                                types::uint64 seed, types::uint32 numThreads)
+        {
+            using namespace iris::types;
+            using namespace iris::util;
+
+            const auto& valueCodec    = agents.getValueCodec();
+            const auto& behaviorCodec = agents.getBehaviorCodec();
+
+            if(values.size() < behaviors.size())
+            {
+                // This should be caught by the IO parser.
+                throw std::runtime_error("Base size is smaller than target!");
+            }
+
+            for(uint32 i = 0; i < behaviors.size(); i++)
+            {
+                if(values[i] > behaviorCodec.getRange(i))
+                {
+                    throw std::runtime_error("Behavior " + toString(i) +
+                                             " cannot hold every value.");
+                }
+            }
+
             PopDispensers valueDisp =
                 createPopulationDispensers(values, totalAgents);
+            Uint32List    groups;
 
-            // For each agent, create a new and unique set of values and
-            // behaviors.
-            for(AgentID i = 0; i < totalAgents; i++)
+            // Deal out one variable to the whole population at a time, and
+            // write it straight into the packed words of every agent; the
+            // behaviors are the leading values.
+            for(uint32 v = 0; v < valueDisp.size(); v++)
             {
-                ValueList vList    = createAttributeList(valueDisp, random);
-                BehaviorList bList = createSubAttributeList(vList, behaviors);
-                
-                agents[i].setInitialBehavior(bList);
-                agents[i].setInitialValues(vList);
+                const bool isBehavior = v < behaviors.size();
+
+                valueDisp[v].dispenseAll(groups, seed, v, numThreads);
+
+                runParts(totalAgents, numThreads,
+                         [&agents, &behaviorCodec, &groups, &valueCodec, v,
+                          isBehavior](uint32, uint64 first, uint64 last) {
+                             for(auto i = first; i < last; i++)
+                             {
+                                 auto& value = agents.getValueWord(i);
+
+                                 value = valueCodec.set((v == 0) ? 0 : value,
+                                                        v, groups[i]);
+
+                                 if(isBehavior)
+                                 {
+                                     auto& behavior =
+                                         agents.getBehaviorWord(i);
+
+                                     behavior = behaviorCodec.set(
+                                         (v == 0) ? 0 : behavior, v,
+                                         groups[i]);
+
+                                     agents.getNextBehaviorWord(i) = behavior;
+                                 }
+                             }
+                         });
             }
         }
 
-        void generatePowerfulAgents(Agent* const agents, AgentID totalAgents,
+        void generatePowerfulAgents(AgentStore& agents, AgentID totalAgents,
                                     types::fnumeric powerPercent,
                                     bool requireAtLeastOne,
-                                    types::mersenne_twister& random)
+                                    types::uint64 seed)
         {
             using namespace iris::types;
             using namespace iris::util;
             
-            typedef Agent::Network                         Network;
             typedef std::uniform_int_distribution<AgentID> UintDist;
             
             if(powerPercent == 0.0)
@@ -146,19 +189,32 @@ namespace iris
                 numPowerful = 1;
             }
 
-            // Random selector.
-            UintDist chooser(0, totalAgents - 1);
-            // The already selected agents.
-            Network  selected;
-            
-            for(AgentID i = 0; i < numPowerful; i++)
+            if(numPowerful > totalAgents)
             {
-                const auto chosen =
-                    ensureRandom<AgentID>(chooser(random), selected,
-                                          (AgentID)0, totalAgents);
-                agents[chosen].setPowerful(true);
-                util::sortedInsert(selected, chosen);
+                throw std::runtime_error("There is no sample space left to"
+                                         " use!");
             }
+
+            // Choose with Floyd's algorithm: each of the last numPowerful
+            // positions adds one agent from those before it (or itself, if
+            // that one is taken), so every draw succeeds the first time.
+            CounterRandom     random(seed, 0, CounterRandom::PowerStep);
+            std::vector<bool> taken(totalAgents, false);
+            IDList            selected;
+
+            selected.reserve(numPowerful);
+
+            for(auto j = totalAgents - numPowerful; j < totalAgents; j++)
+            {
+                const auto drawn  = UintDist(0, j)(random);
+                const auto chosen = taken[drawn] ? j : drawn;
+
+                taken[chosen] = true;
+                selected.push_back(chosen);
+            }
+
+            std::sort(selected.begin(), selected.end());
+            agents.setPowerfulAgents(std::move(selected));
         }
 
         PermuteList permuteList(const Uint32List& vars)
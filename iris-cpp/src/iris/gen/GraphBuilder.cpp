@@ -0,0 +1,669 @@
+#include "iris/gen/GraphBuilder.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "iris/Random.hpp"
+#include "iris/Utils.hpp"
+
+namespace iris
+{
+    namespace gen
+    {
+        GraphBuilder::GraphBuilder(AgentID totalAgents,
+                                   const io::CensusData& census,
+                                   types::uint32 outConnections,
+                                   types::fnumeric connectionProb,
+                                   types::fnumeric recipProb,
+                                   types::uint64 seed)
+            : m_connectionProb(connectionProb), m_familyTable(census),
+              m_outConnections(outConnections), m_recipProb(recipProb),
+              m_seed(seed), m_totalAgents(totalAgents), m_first(0), m_last(0),
+              m_familySizes(nullptr)
+        {}
+
+        GraphBuilder::~GraphBuilder()
+        {}
+
+        void GraphBuilder::assemble(AgentID first, AgentID last,
+                                    IDList& targets,
+                                    std::vector<types::uint64>& sizes) const
+        {
+            if(first >= last)
+            {
+                return;
+            }
+
+            // Find the family unit of the first agent.
+            auto unit = std::upper_bound(
+                m_units.begin(), m_units.end(), first,
+                [](AgentID id, const FamilyUnit& u) {
+                    return id < u.first;
+                }) - 1;
+
+            for(auto id = first; id < last; id++)
+            {
+                if(id >= unit->second)
+                {
+                    ++unit;
+                }
+
+                const auto start = targets.size();
+
+                for(auto i = unit->first; i < unit->second; i++)
+                {
+                    if(i != id)
+                    {
+                        targets.push_back(i);
+                    }
+                }
+
+                for(auto c = m_connectionOffsets[id - m_first];
+                    c < m_connectionOffsets[id + 1 - m_first]; c++)
+                {
+                    targets.push_back(m_connections[c]);
+                }
+
+                std::sort(targets.begin() + start, targets.end());
+
+                // Agents wired later reciprocate while there is room, where
+                // an empty network counts as full (see Agent::isNetworkFull).
+                const auto upperBound = this->getUpperBound(id);
+                const auto middle     = targets.size();
+
+                for(auto c = m_candidateOffsets[id - m_first];
+                    c < m_candidateOffsets[id + 1 - m_first]; c++)
+                {
+                    const auto from = m_candidates[c].m_from;
+                    const auto size = targets.size() - start;
+
+                    if(size == 0 || size >= upperBound)
+                    {
+                        break;
+                    }
+
+                    if(!std::binary_search(targets.begin() + start,
+                                           targets.begin() + middle, from))
+                    {
+                        targets.push_back(from);
+                    }
+                }
+
+                std::inplace_merge(targets.begin() + start,
+                                   targets.begin() + middle, targets.end());
+
+                sizes[id + 1 - m_first] = targets.size() - start;
+            }
+        }
+
+        void GraphBuilder::assembleBlock(types::uint32 numThreads,
+                                         std::vector<types::uint64>& offsets,
+                                         IDList& targets) const
+        {
+            using namespace iris::types;
+            using namespace iris::util;
+
+            const auto count = m_last - m_first;
+
+            std::vector<IDList> parts(numThreads);
+            std::vector<uint64> firsts(numThreads, count);
+
+            offsets.assign(count + 1, 0);
+
+            runParts(count, numThreads,
+                     [this, &parts, &firsts, &offsets](uint32 part,
+                                                       uint64 first,
+                                                       uint64 last) {
+                         firsts[part] = first;
+                         this->assemble(m_first + first, m_first + last,
+                                        parts[part], offsets);
+                     });
+
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            targets.resize(offsets[count]);
+
+            runParts(numThreads, numThreads,
+                     [&parts, &firsts, &offsets, &targets](uint32,
+                                                           uint64 first,
+                                                           uint64 last) {
+                         for(auto i = first; i < last; i++)
+                         {
+                             std::copy(parts[i].begin(), parts[i].end(),
+                                       targets.begin() + offsets[firsts[i]]);
+                             IDList().swap(parts[i]);
+                         }
+                     });
+        }
+
+        void GraphBuilder::begin(AgentStore& agents, types::uint32 numThreads)
+        {
+            if(agents.size() != m_totalAgents)
+            {
+                throw std::runtime_error("The store does not hold " +
+                                         util::toString(m_totalAgents) +
+                                         " agents.");
+            }
+
+            if(numThreads == 0)
+            {
+                throw std::runtime_error("The number of threads must be at"
+                                         " least one.");
+            }
+
+            m_familySizes = &agents.getFamilySizes();
+            m_units = layoutFamilies(m_familyTable, m_totalAgents, m_seed,
+                                     numThreads, agents.getFamilySizes());
+        }
+
+        void GraphBuilder::build(AgentStore& agents, types::uint32 numThreads)
+        {
+            std::vector<std::vector<Candidate>> runs;
+            std::vector<types::uint64>          offsets;
+            IDList                              targets;
+
+            this->begin(agents, numThreads);
+
+            // The whole population is a single block.
+            this->drawBlock(0, m_units.size(), numThreads, runs);
+            this->mergeCandidates(runs, numThreads);
+            this->indexCandidates(numThreads);
+            this->assembleBlock(numThreads, offsets, targets);
+            this->end();
+
+            agents.freezeNetworks(std::move(offsets), std::move(targets));
+        }
+
+        void GraphBuilder::drawBlock(types::uint64 firstUnit,
+                                     types::uint64 lastUnit,
+                                     types::uint32 numThreads,
+                                     std::vector<std::vector<Candidate>>& runs)
+        {
+            using namespace iris::types;
+            using namespace iris::util;
+
+            std::vector<IDList> connections(numThreads);
+
+            m_first = (firstUnit < lastUnit) ? m_units[firstUnit].first : 0;
+            m_last  = (firstUnit < lastUnit) ? m_units[lastUnit - 1].second : 0;
+
+            runs.assign(numThreads, std::vector<Candidate>{});
+            m_connectionOffsets.assign(m_last - m_first + 1, 0);
+
+            runParts(lastUnit - firstUnit, numThreads,
+                     [this, firstUnit, &connections, &runs](uint32 part,
+                                                            uint64 first,
+                                                            uint64 last) {
+                         this->drawConnections(firstUnit + first,
+                                               firstUnit + last,
+                                               connections[part], runs[part]);
+                     });
+
+            std::partial_sum(m_connectionOffsets.begin(),
+                             m_connectionOffsets.end(),
+                             m_connectionOffsets.begin());
+
+            // Parts of units hold consecutive agents, so their connections
+            // are simply placed back to back.
+            std::vector<uint64> bases(numThreads + 1, 0);
+
+            for(uint32 i = 0; i < numThreads; i++)
+            {
+                bases[i + 1] = bases[i] + connections[i].size();
+            }
+
+            m_connections.resize(bases[numThreads]);
+
+            runParts(numThreads, numThreads,
+                     [this, &connections, &bases](uint32, uint64 first,
+                                                  uint64 last) {
+                         for(auto i = first; i < last; i++)
+                         {
+                             std::copy(connections[i].begin(),
+                                       connections[i].end(),
+                                       m_connections.begin() + bases[i]);
+                             IDList().swap(connections[i]);
+                         }
+                     });
+        }
+
+        void GraphBuilder::drawConnections(types::uint64 firstUnit,
+                                           types::uint64 lastUnit,
+                                           IDList& connections,
+                                           std::vector<Candidate>& candidates)
+        {
+            using namespace iris::types;
+
+            typedef std::uniform_real_distribution<fnumeric> FDist;
+            typedef std::uniform_int_distribution<AgentID>   UintDist;
+
+            // If the number of out-going connections is zero, then do not
+            // bother.
+            if(m_outConnections == 0)
+            {
+                return;
+            }
+
+            FDist          fdist(0.0, 1.0);
+            UintDist       udist(0, m_totalAgents - 1);
+            Agent::Network network;
+
+            for(auto u = firstUnit; u < lastUnit; u++)
+            {
+                const auto& unit   = m_units[u];
+                const auto  family = unit.second - unit.first - 1;
+
+                for(auto id = unit.first; id < unit.second; id++)
+                {
+                    // The same stream, drawn in the same order, as
+                    // wireOutGroup.
+                    CounterRandom random(m_seed, id,
+                                         CounterRandom::OutGroupStep);
+
+                    const auto start          = connections.size();
+                    const auto maxConnections =
+                        this->getUpperBound(id) - family;
+
+                    // The family and the agent itself.
+                    network.resize(unit.second - unit.first);
+                    std::iota(network.begin(), network.end(), unit.first);
+
+                    for(uint32 i = 0; i < maxConnections; i++)
+                    {
+                        if(fdist(random) > m_connectionProb)
+                        {
+                            continue;
+                        }
+
+                        const auto to =
+                            util::ensureRandom<AgentID>(udist(random),
+                                                        network, (AgentID)0,
+                                                        m_totalAgents);
+
+                        util::sortedInsert(network, to);
+                        connections.push_back(to);
+
+                        // Agents yet to be wired never have room (see the
+                        // top of GraphBuilder.hpp).
+                        if(fdist(random) <= m_recipProb && to < id)
+                        {
+                            candidates.push_back(Candidate{id, to});
+                        }
+                    }
+
+                    m_connectionOffsets[id + 1 - m_first] =
+                        connections.size() - start;
+                }
+            }
+        }
+
+        void GraphBuilder::end()
+        {
+            std::vector<Candidate>().swap(m_candidates);
+            std::vector<types::uint64>().swap(m_candidateOffsets);
+            IDList().swap(m_connections);
+            std::vector<types::uint64>().swap(m_connectionOffsets);
+            std::vector<FamilyUnit>().swap(m_units);
+
+            m_familySizes = nullptr;
+            m_first       = 0;
+            m_last        = 0;
+        }
+
+        types::uint32 GraphBuilder::getUpperBound(AgentID index) const
+        {
+            const auto familySize = (*m_familySizes)[index] - 1;
+
+            return ((m_outConnections + familySize) > (m_totalAgents - 1)) ?
+                (m_totalAgents - 1) : (m_outConnections + familySize);
+        }
+
+        void GraphBuilder::indexCandidates(types::uint32 numThreads)
+        {
+            using namespace iris::types;
+            using namespace iris::util;
+
+            const auto count = m_last - m_first;
+
+            m_candidateOffsets.resize(count + 1);
+
+            runParts(count, numThreads,
+                     [this](uint32, uint64 first, uint64 last) {
+                         auto candidate = m_candidates.begin();
+
+                         for(auto i = first; i < last; i++)
+                         {
+                             candidate = std::lower_bound(
+                                 candidate, m_candidates.end(), m_first + i,
+                                 [](const Candidate& c, uint64 to) {
+                                     return c.m_to < to;
+                                 });
+
+                             m_candidateOffsets[i] =
+                                 candidate - m_candidates.begin();
+                         }
+                     });
+
+            m_candidateOffsets[count] = m_candidates.size();
+        }
+
+        std::vector<FamilyUnit> GraphBuilder::layoutFamilies(
+            const AliasTable& sizes, AgentID totalAgents, types::uint64 seed,
+            types::uint32 numThreads, std::vector<types::uint32>& familySizes)
+        {
+            using namespace iris::types;
+            using namespace iris::util;
+
+            typedef std::uniform_real_distribution<fnumeric> FDist;
+
+            if(numThreads == 0)
+            {
+                throw std::runtime_error("The number of threads must be at"
+                                         " least one.");
+            }
+
+            const auto meanSize = sizes.getMean() + 1.0;
+
+            std::vector<uint32> drawn;
+            std::vector<uint64> starts(1, 0);
+            std::vector<uint64> sums(numThreads + 1);
+
+            // Draw batches of sizes until they cover every agent, each batch
+            // covering the remaining agents on average (plus some slack).
+            while(starts.back() < totalAgents)
+            {
+                const auto done  = drawn.size();
+                const auto left  = totalAgents - starts.back();
+                const auto batch = static_cast<uint64>(left / meanSize * 1.05)
+                    + 64;
+
+                drawn.resize(done + batch);
+                starts.resize(done + batch + 1);
+
+                runParts(batch, numThreads,
+                         [&sizes, &drawn, &sums, done, seed](uint32 part,
+                                                             uint64 first,
+                                                             uint64 last) {
+                             FDist  chooser(0.0, 1.0);
+                             uint64 sum = 0;
+
+                             for(auto k = done + first; k < done + last; k++)
+                             {
+                                 CounterRandom random(
+                                     seed, k, CounterRandom::FamilyStep);
+
+                                 drawn[k] = sizes.choose(chooser(random)) + 1;
+                                 sum     += drawn[k];
+                             }
+
+                             sums[part + 1] = sum;
+                         });
+
+                // Prefix-sum the batch: first the totals of each part, then
+                // every part on its own.
+                sums[0] = starts[done];
+                std::partial_sum(sums.begin(), sums.end(), sums.begin());
+
+                runParts(batch, numThreads,
+                         [&drawn, &starts, &sums, done](uint32 part,
+                                                        uint64 first,
+                                                        uint64 last) {
+                             auto start = sums[part];
+
+                             for(auto k = done + first; k < done + last; k++)
+                             {
+                                 start        += drawn[k];
+                                 starts[k + 1] = start;
+                             }
+                         });
+            }
+
+            // Every family that starts within the population is kept.
+            const auto count = static_cast<uint64>(
+                std::lower_bound(starts.begin(), starts.end(), totalAgents) -
+                starts.begin());
+
+            std::vector<FamilyUnit> units(count);
+
+            runParts(count, numThreads,
+                     [&units, &drawn, &starts, &familySizes,
+                      totalAgents](uint32, uint64 first, uint64 last) {
+                         for(auto k = first; k < last; k++)
+                         {
+                             units[k] = FamilyUnit(
+                                 starts[k],
+                                 std::min<uint64>(starts[k + 1], totalAgents));
+
+                             std::fill(familySizes.begin() + units[k].first,
+                                       familySizes.begin() + units[k].second,
+                                       drawn[k]);
+                         }
+                     });
+
+            return units;
+        }
+
+        void GraphBuilder::mergeCandidates(
+            std::vector<std::vector<Candidate>>& runs,
+            types::uint32 numThreads)
+        {
+            using namespace iris::types;
+            using namespace iris::util;
+
+            runParts(runs.size(), numThreads,
+                     [&runs](uint32, uint64 first, uint64 last) {
+                         for(auto i = first; i < last; i++)
+                         {
+                             std::sort(runs[i].begin(), runs[i].end(),
+                                       orderByTarget);
+                         }
+                     });
+
+            // Merge neighbouring runs in pairs until only one is left.
+            while(runs.size() > 1)
+            {
+                std::vector<std::vector<Candidate>> merged(
+                    (runs.size() + 1) / 2);
+
+                runParts(merged.size(), numThreads,
+                         [&runs, &merged](uint32, uint64 first, uint64 last) {
+                             for(auto i = first; i < last; i++)
+                             {
+                                 if(2 * i + 1 == runs.size())
+                                 {
+                                     merged[i].swap(runs[2 * i]);
+                                     continue;
+                                 }
+
+                                 const auto& a = runs[2 * i];
+                                 const auto& b = runs[2 * i + 1];
+
+                                 merged[i].resize(a.size() + b.size());
+                                 std::merge(a.begin(), a.end(),
+                                            b.begin(), b.end(),
+                                            merged[i].begin(), orderByTarget);
+                             }
+                         });
+
+                runs.swap(merged);
+            }
+
+            m_candidates.clear();
+
+            if(!runs.empty())
+            {
+                m_candidates.swap(runs[0]);
+            }
+        }
+
+        void GraphBuilder::stream(AgentStore& agents,
+                                  const std::string& filename,
+                                  AgentID blockSize, types::uint32 numThreads)
+        {
+            using namespace iris::types;
+
+            typedef AgentStore::NetworkHeader Header;
+            typedef std::pair<Candidate, uint32> Head;
+
+            if(blockSize == 0)
+            {
+                throw std::runtime_error("The block size must be at least"
+                                         " one.");
+            }
+
+            this->begin(agents, numThreads);
+
+            const auto n = m_totalAgents;
+
+            // Cut the family units into blocks of roughly the block size.
+            std::vector<uint64> blocks(1, 0);
+
+            for(uint64 u = 0; u < m_units.size(); u++)
+            {
+                if(m_units[u].second - m_units[blocks.back()].first >=
+                   blockSize || u + 1 == m_units.size())
+                {
+                    blocks.push_back(u + 1);
+                }
+            }
+
+            // The spilled runs are removed however this ends, once the
+            // files reading them (declared later) are closed.
+            struct SpilledRuns
+            {
+                ~SpilledRuns()
+                {
+                    for(const auto& name : m_names)
+                    {
+                        std::remove(name.c_str());
+                    }
+                }
+
+                std::vector<std::string> m_names;
+            } spilled;
+
+            // First, spill the sorted reciprocal candidates of every block.
+            std::vector<std::vector<Candidate>> runs;
+            auto&                               runNames = spilled.m_names;
+
+            for(std::size_t b = 0; b + 1 < blocks.size(); b++)
+            {
+                this->drawBlock(blocks[b], blocks[b + 1], numThreads, runs);
+                this->mergeCandidates(runs, numThreads);
+
+                runNames.push_back(filename + ".run" + util::toString(b));
+
+                std::ofstream run(runNames.back(), std::ios::binary);
+
+                run.write(reinterpret_cast<const char*>(m_candidates.data()),
+                          m_candidates.size() * sizeof(Candidate));
+
+                if(!run)
+                {
+                    throw std::runtime_error("Could not write " +
+                                             runNames.back());
+                }
+            }
+
+            // Then merge the runs, which are read front to back, while the
+            // networks are assembled block by block.  Connections are simply
+            // drawn again rather than spilled as well.
+            std::vector<std::ifstream> files;
+            std::vector<Head>          heads;
+
+            const auto later = [](const Head& a, const Head& b) {
+                return orderByTarget(b.first, a.first);
+            };
+
+            const auto advance = [&files, &heads, &later](uint32 run) {
+                Candidate candidate;
+
+                if(files[run].read(reinterpret_cast<char*>(&candidate),
+                                   sizeof(candidate)))
+                {
+                    heads.push_back(Head(candidate, run));
+                    std::push_heap(heads.begin(), heads.end(), later);
+                }
+            };
+
+            for(uint32 r = 0; r < runNames.size(); r++)
+            {
+                files.emplace_back(runNames[r], std::ios::binary);
+                advance(r);
+            }
+
+            const Header header = AgentStore::createNetworkHeader(n, 0);
+            const uint64 start  = sizeof(Header) + (n + 1) * sizeof(uint64);
+
+            std::ofstream       out(filename, std::ios::binary);
+            std::vector<uint64> offsets;
+            IDList              targets;
+            uint64              edges = 0;
+
+            if(!out.is_open())
+            {
+                throw std::runtime_error("Could not write " + filename);
+            }
+
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            for(std::size_t b = 0; b + 1 < blocks.size(); b++)
+            {
+                this->drawBlock(blocks[b], blocks[b + 1], numThreads, runs);
+
+                m_candidates.clear();
+
+                while(!heads.empty() && heads.front().first.m_to < m_last)
+                {
+                    const auto run = heads.front().second;
+
+                    m_candidates.push_back(heads.front().first);
+                    std::pop_heap(heads.begin(), heads.end(), later);
+                    heads.pop_back();
+                    advance(run);
+                }
+
+                this->indexCandidates(numThreads);
+                this->assembleBlock(numThreads, offsets, targets);
+
+                for(auto& offset : offsets)
+                {
+                    offset += edges;
+                }
+
+                out.seekp(sizeof(Header) + m_first * sizeof(uint64));
+                out.write(reinterpret_cast<const char*>(offsets.data()),
+                          (offsets.size() - 1) * sizeof(uint64));
+
+                out.seekp(start + edges * sizeof(AgentID));
+                out.write(reinterpret_cast<const char*>(targets.data()),
+                          targets.size() * sizeof(AgentID));
+
+                edges = offsets.back();
+            }
+
+            // Finish with the total number of edges, in both places.
+            const Header complete = AgentStore::createNetworkHeader(n, edges);
+
+            out.seekp(sizeof(Header) + n * sizeof(uint64));
+            out.write(reinterpret_cast<const char*>(&edges), sizeof(edges));
+            out.seekp(0);
+            out.write(reinterpret_cast<const char*>(&complete),
+                      sizeof(complete));
+            out.close();
+
+            this->end();
+
+            if(!out)
+            {
+                throw std::runtime_error("Could not write " + filename);
+            }
+
+            agents.mapNetworks(filename);
+        }
+    }
+}
@@ -8,6 +8,9 @@
 
 #include "iris/Utils.hpp"
 
+#include "iris/gen/AliasTable.hpp"
+#include "iris/gen/GraphBuilder.hpp"
+
 namespace iris
 {
     namespace gen
@@ -50,7 +53,7 @@ namespace iris
             return cdf;
         }
       
-        void wireFamilyUnit(Agent& agent, const FamilyUnit& unit)
+        void wireFamilyUnit(Agent agent, const FamilyUnit& unit)
         {
             const auto id = agent.getUId();
             
@@ -65,59 +68,40 @@ namespace iris
             }
         }
         
-        void wireGraph(Agent* const agents, AgentID totalAgents,
+        void wireGraph(AgentStore& agents, AgentID totalAgents,
                        const io::CensusData census,
                        types::uint32 outConnections,
                        types::fnumeric connectionProb,
                        types::fnumeric recipProb,
-                       types::mersenne_twister& random)
+                       types::uint64 seed)
         {
             using namespace iris;
             using namespace iris::types;
-            
-            typedef std::uniform_real_distribution<fnumeric> FDist;
 
-            CDF        cdf = createCDF(census);
-            FDist      chooser(0.0, 1.0);
-            AgentID    counter = 0;
-            FamilyUnit unit;
+            // Families are laid out exactly as by the parallel builder.
+            const auto units =
+                GraphBuilder::layoutFamilies(AliasTable(census), totalAgents,
+                                             seed, 1,
+                                             agents.getFamilySizes());
 
-            while(counter < totalAgents)
+            for(const auto& unit : units)
             {
-                // Choose a new family unit.
-                //
-                // Add 1 to offset base 0.
-                const fnumeric p = chooser(random);
-                const uint32 familySize = chooseFamilySize(p, cdf) + 1;
-
-                // Create a "new" family unit.
-                unit.first  = counter;
-                unit.second = counter + familySize;
-
-                // Check for overflow.
-                if(unit.second > totalAgents)
-                {
-                    unit.second = totalAgents;
-                }
-
                 for(auto i = unit.first; i < unit.second; i++)
                 {
+                    CounterRandom random(seed, i, CounterRandom::OutGroupStep);
+
                     wireFamilyUnit(agents[i], unit);
-                    agents[i].setFamilySize(familySize);
                     wireOutGroup(i, agents, totalAgents, outConnections,
-                                 connectionProb, recipProb, random);              
+                                 connectionProb, recipProb, random);
                 }
-                
-                // Finally, update the counter itself.
-                counter += familySize;
             }
         }
 
-        void wireOutGroup(const AgentID& id, Agent* const agents,
+        void wireOutGroup(const AgentID& id, AgentStore& agents,
                           AgentID totalAgents, types::uint32 outConnections,
                           types::fnumeric connectionProb,
                           types::fnumeric recipProb,
-                          types::mersenne_twister& random)
+                          CounterRandom& random)
         {
             using namespace iris::types;
             using namespace iris::util;
@@ -134,7 +118,8 @@ namespace iris
             typedef uniform_int_distribution<AgentID>   UintDist;      
             
             // Obtain the current network.
-            auto network = agents[id].getNetwork();
+            auto& networks = agents.getNetworks();
+            auto  network  = networks[id];
             
             // The random distributions to use.
             FDist    fdist(0.0, 1.0);
@@ -204,7 +189,7 @@ namespace iris
                 sortedInsert(network, newIndex);
 
                 // Connect to the agent.
-                agents[id].addConnection(newIndex);
+                sortedInsert(networks[id], newIndex);
 
 #ifdef IRIS_VISUAL_DEBUG
                 std::cout << "Added: " << id << " " << newIndex << std::endl;
@@ -220,7 +205,7 @@ namespace iris
                 
                 if(makeRecip && !isFull && !isConnected)
                 {
-                    agents[newIndex].addConnection(id);
+                    sortedInsert(networks[newIndex], id);
 
 #ifdef IRIS_VISUAL_DEBUG
                     std::cout << "Recip: " << newIndex << " " << id << std::endl;
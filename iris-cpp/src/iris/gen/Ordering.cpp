@@ -0,0 +1,140 @@
+#include "iris/gen/Ordering.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace iris
+{
+    namespace gen
+    {
+        IDList computeOrder(const AgentStore& agents, Ordering ordering)
+        {
+            switch(ordering)
+            {
+                case Ordering::BreadthFirst:
+                    return orderBreadthFirst(agents);
+                case Ordering::ReverseCuthillMcKee:
+                    return orderReverseCuthillMcKee(agents);
+                default:
+                    break;
+            }
+
+            IDList order(agents.size());
+            std::iota(order.begin(), order.end(), 0);
+
+            return order;
+        }
+
+        IDList orderBreadthFirst(const AgentStore& agents)
+        {
+            const auto        n = agents.size();
+            IDList            order;
+            std::vector<bool> visited(n, false);
+
+            order.reserve(n);
+
+            for(AgentID start = 0; start < n; start++)
+            {
+                if(visited[start])
+                {
+                    continue;
+                }
+
+                // The order itself doubles as the queue.
+                auto head = order.size();
+
+                visited[start] = true;
+                order.push_back(start);
+
+                for(; head < order.size(); head++)
+                {
+                    for(const auto other : agents.getNetwork(order[head]))
+                    {
+                        if(!visited[other])
+                        {
+                            visited[other] = true;
+                            order.push_back(other);
+                        }
+                    }
+                }
+            }
+
+            return order;
+        }
+
+        IDList orderReverseCuthillMcKee(const AgentStore& agents)
+        {
+            const auto        n = agents.size();
+            IDList            order;
+            IDList            starts(n);
+            IDList            neighbours;
+            std::vector<bool> visited(n, false);
+
+            const auto byDegree = [&agents](AgentID lhs, AgentID rhs) {
+                return agents.getNetwork(lhs).size() <
+                    agents.getNetwork(rhs).size();
+            };
+
+            // Components are started from their agent of lowest degree, so
+            // try the candidates in that order (ties by position).
+            std::iota(starts.begin(), starts.end(), 0);
+            std::stable_sort(starts.begin(), starts.end(), byDegree);
+
+            order.reserve(n);
+
+            for(const auto start : starts)
+            {
+                if(visited[start])
+                {
+                    continue;
+                }
+
+                auto head = order.size();
+
+                visited[start] = true;
+                order.push_back(start);
+
+                for(; head < order.size(); head++)
+                {
+                    neighbours.clear();
+
+                    for(const auto other : agents.getNetwork(order[head]))
+                    {
+                        if(!visited[other])
+                        {
+                            visited[other] = true;
+                            neighbours.push_back(other);
+                        }
+                    }
+
+                    std::stable_sort(neighbours.begin(), neighbours.end(),
+                                     byDegree);
+                    order.insert(order.end(), neighbours.begin(),
+                                 neighbours.end());
+                }
+            }
+
+            std::reverse(order.begin(), order.end());
+            return order;
+        }
+
+        Ordering parseOrdering(const std::string& name)
+        {
+            if(name == "none")
+            {
+                return Ordering::None;
+            }
+            else if(name == "bfs")
+            {
+                return Ordering::BreadthFirst;
+            }
+            else if(name == "rcm")
+            {
+                return Ordering::ReverseCuthillMcKee;
+            }
+
+            throw std::runtime_error("Unknown agent ordering: " + name);
+        }
+    }
+}
@@ -1,13 +1,19 @@
 #include "iris/gen/PopulationDispenser.hpp"
 
+#include <algorithm>
 #include <numeric>
 #include <random>
 #include <stdexcept>
 
+#include "iris/Utils.hpp"
+
 namespace iris
 {
     namespace gen
     {
+        const types::uint64 PopulationDispenser::ShuffleChunk;
+        const types::uint64 PopulationDispenser::ShuffleBuckets;
+
         PopulationDispenser::PopulationDispenser()
         {}
 
@@ -61,6 +67,129 @@ namespace iris
             m_populations.clear();
         }
         
+        void PopulationDispenser::dispenseAll(Uint32List& groups,
+                                              types::uint64 seed,
+                                              types::uint64 stream,
+                                              types::uint32 numThreads)
+        {
+            using namespace iris::types;
+            using namespace iris::util;
+
+            typedef std::uniform_int_distribution<uint64> UintDist;
+
+            if(numThreads == 0)
+            {
+                throw std::runtime_error("The number of threads must be at"
+                                         " least one.");
+            }
+
+            // Were the groups dispensed in order, each would end where the
+            // running total of the populations does.
+            std::vector<uint64> ends(m_populations.size());
+            std::partial_sum(m_populations.begin(), m_populations.end(),
+                             ends.begin());
+
+            const uint64 total   = ends.empty() ? 0 : ends.back();
+            const uint64 chunks  = (total + ShuffleChunk - 1) / ShuffleChunk;
+            const uint64 buckets =
+                std::max<uint64>(1, std::min(chunks, ShuffleBuckets));
+
+            // The places of every chunk in every bucket, bucket by bucket.
+            std::vector<uint64> places(buckets * chunks, 0);
+            std::vector<uint64> bounds(buckets + 1, 0);
+
+            // First, every position of every chunk is dealt to a bucket.
+            runParts(chunks, numThreads,
+                     [&places, buckets, chunks, seed, stream,
+                      total](uint32, uint64 first, uint64 last) {
+                         for(auto c = first; c < last; c++)
+                         {
+                             CounterRandom random(
+                                 seed, (stream << 32) | c,
+                                 CounterRandom::AttributeStep);
+                             UintDist     chooser(0, buckets - 1);
+                             const auto   size =
+                                 std::min(ShuffleChunk,
+                                          total - c * ShuffleChunk);
+
+                             for(uint64 i = 0; i < size; i++)
+                             {
+                                 places[chooser(random) * chunks + c]++;
+                             }
+                         }
+                     });
+
+            uint64 place = 0;
+
+            for(uint64 b = 0; b < buckets; b++)
+            {
+                bounds[b] = place;
+
+                for(uint64 c = 0; c < chunks; c++)
+                {
+                    const auto count = places[b * chunks + c];
+
+                    places[b * chunks + c] = place;
+                    place                 += count;
+                }
+            }
+
+            bounds[buckets] = place;
+            groups.resize(total);
+
+            // Then every chunk deals its groups again, in order, to the same
+            // buckets.
+            runParts(chunks, numThreads,
+                     [this, &ends, &groups, &places, buckets, chunks, seed,
+                      stream, total](uint32, uint64 first, uint64 last) {
+                         for(auto c = first; c < last; c++)
+                         {
+                             CounterRandom random(
+                                 seed, (stream << 32) | c,
+                                 CounterRandom::AttributeStep);
+                             UintDist     chooser(0, buckets - 1);
+                             const auto   start = c * ShuffleChunk;
+                             const auto   end   =
+                                 start + std::min(ShuffleChunk, total - start);
+
+                             auto group = std::upper_bound(ends.begin(),
+                                                           ends.end(), start) -
+                                 ends.begin();
+
+                             for(auto i = start; i < end; i++)
+                             {
+                                 while(ends[group] <= i)
+                                 {
+                                     group++;
+                                 }
+
+                                 const auto bucket = chooser(random);
+
+                                 groups[places[bucket * chunks + c]++] =
+                                     m_groups[group];
+                             }
+                         }
+                     });
+
+            // Finally, each bucket is shuffled on its own.
+            runParts(buckets, numThreads,
+                     [&bounds, &groups, seed, stream](uint32, uint64 first,
+                                                      uint64 last) {
+                         for(auto b = first; b < last; b++)
+                         {
+                             CounterRandom random(
+                                 seed, (stream << 32) | b,
+                                 CounterRandom::ShuffleStep);
+
+                             std::shuffle(groups.begin() + bounds[b],
+                                          groups.begin() + bounds[b + 1],
+                                          random);
+                         }
+                     });
+
+            this->clear();
+        }
+
         bool PopulationDispenser::hasMore()
         {
             return !m_groups.empty();
@@ -105,7 +234,7 @@ namespace iris
         }
         
         types::uint32 PopulationDispenser::nextGroup(
-            types::mersenne_twister &random)
+            CounterRandom& random)
         {
             using namespace iris::types;
             using namespace std;
@@ -0,0 +1,69 @@
+#include "iris/io/Columnar.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "iris/Utils.hpp"
+
+namespace iris
+{
+    namespace io
+    {
+        ColumnFileHeader createColumnFileHeader(types::uint32 columns,
+                                                types::uint32 metadata)
+        {
+            static_assert(sizeof(ColumnFileHeader) % sizeof(types::uint64) ==
+                          0, "The header must keep what follows aligned.");
+            static_assert(sizeof(BlockHeader) % sizeof(types::uint64) == 0,
+                          "A block must keep its columns aligned.");
+
+            ColumnFileHeader header;
+
+            std::memcpy(header.m_magic, "IRISCOL1", sizeof(header.m_magic));
+            header.m_version  = 1;
+            header.m_columns  = columns;
+            header.m_metadata = metadata;
+            header.m_reserved = 0;
+
+            return header;
+        }
+
+        types::uint32 getColumnWidth(ColumnType type)
+        {
+            switch(type)
+            {
+                case ColumnType::UInt8:
+                    return 1;
+                case ColumnType::UInt32:
+                    return 4;
+                case ColumnType::UInt64:
+                case ColumnType::Float64:
+                case ColumnType::Text:
+                    return 8;
+            }
+
+            throw std::runtime_error("Unknown column type: " +
+                                     util::toString(
+                                         static_cast<types::uint32>(type)));
+        }
+
+        std::string getExtension(OutputFormat format)
+        {
+            return (format == OutputFormat::Binary) ? ".col" : ".csv";
+        }
+
+        OutputFormat parseOutputFormat(const std::string& name)
+        {
+            if(name == "csv")
+            {
+                return OutputFormat::Csv;
+            }
+            else if(name == "binary")
+            {
+                return OutputFormat::Binary;
+            }
+
+            throw std::runtime_error("Unknown output format: " + name);
+        }
+    }
+}
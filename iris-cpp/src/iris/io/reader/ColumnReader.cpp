@@ -0,0 +1,299 @@
+#include "iris/io/reader/ColumnReader.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#include "iris/Utils.hpp"
+
+namespace iris
+{
+    namespace io
+    {
+        ColumnReader::ColumnReader(const std::string& filename)
+            : m_data(nullptr), m_file(filename), m_rows(0), m_size(0)
+        {
+            m_data = m_file.data();
+            m_size = m_file.size();
+
+            this->parse(filename);
+        }
+
+        ColumnReader::ColumnReader(const types::uint8* data, std::size_t size)
+            : m_data(data), m_rows(0), m_size(size)
+        {
+            this->parse("The contents");
+        }
+
+        ColumnReader::~ColumnReader()
+        {}
+
+        std::string ColumnReader::getMetadata(const std::string& key) const
+        {
+            for(auto& entry : m_metadata)
+            {
+                if(entry.first == key)
+                {
+                    return entry.second;
+                }
+            }
+
+            throw std::runtime_error("There is no metadata for " + key);
+        }
+
+        std::string ColumnReader::getText(std::size_t block,
+                                          types::uint32 column,
+                                          types::uint64 row) const
+        {
+            if(m_columns.at(column).m_type != ColumnType::Text)
+            {
+                throw std::runtime_error("Column " + m_columns[column].m_name +
+                                         " does not hold text.");
+            }
+
+            const auto& found = m_blocks.at(block);
+
+            if(row >= found.m_rows)
+            {
+                throw std::out_of_range("Row " + util::toString(row) +
+                                        " is past the end of its block.");
+            }
+
+            // The offsets were checked when the file was parsed.
+            const auto  ends  = reinterpret_cast<const types::uint64*>(
+                found.m_columns[column]);
+            const auto  chars = reinterpret_cast<const char*>(
+                ends + found.m_rows);
+
+            const auto first = (row == 0) ? 0 : ends[row - 1];
+
+            return std::string(chars + first, chars + ends[row]);
+        }
+
+        void ColumnReader::parse(const std::string& name)
+        {
+            using namespace iris::types;
+
+            const auto invalid = [&name]() {
+                return std::runtime_error(name + " is not a column file.");
+            };
+
+            // Every read is checked against the end of the contents.
+            uint64 offset = 0;
+
+            const auto read = [&](void* to, uint64 bytes) {
+                if(bytes > m_size - offset)
+                {
+                    throw invalid();
+                }
+
+                std::memcpy(to, m_data + offset, bytes);
+                offset += bytes;
+            };
+
+            const auto readString = [&]() {
+                uint32 length = 0;
+                read(&length, sizeof(length));
+
+                std::string value(length, '\0');
+                read(&value[0], length);
+
+                return value;
+            };
+
+            ColumnFileHeader header;
+
+            if(m_data == nullptr)
+            {
+                throw invalid();
+            }
+
+            read(&header, sizeof(header));
+
+            const auto expected = createColumnFileHeader(0, 0);
+
+            if(std::memcmp(header.m_magic, expected.m_magic,
+                           sizeof(header.m_magic)) != 0 ||
+               header.m_version != expected.m_version)
+            {
+                throw invalid();
+            }
+
+            for(uint32 i = 0; i < header.m_metadata; i++)
+            {
+                auto key   = readString();
+                auto value = readString();
+
+                m_metadata.emplace_back(std::move(key), std::move(value));
+            }
+
+            for(uint32 j = 0; j < header.m_columns; j++)
+            {
+                uint32 type = 0;
+                read(&type, sizeof(type));
+
+                const auto columnType = static_cast<ColumnType>(type);
+
+                if(type > static_cast<uint32>(ColumnType::Text))
+                {
+                    throw invalid();
+                }
+
+                m_columns.push_back(ColumnSpec{readString(), columnType});
+            }
+
+            offset += getPadding(offset);
+
+            while(offset < m_size)
+            {
+                BlockHeader blockHeader;
+                read(&blockHeader, sizeof(blockHeader));
+
+                if(blockHeader.m_bytes > m_size - offset)
+                {
+                    throw invalid();
+                }
+
+                const auto end = offset + blockHeader.m_bytes;
+
+                Block block;
+
+                block.m_rows = blockHeader.m_rows;
+
+                for(auto& column : m_columns)
+                {
+                    const auto width = getColumnWidth(column.m_type);
+
+                    if(blockHeader.m_rows > (end - offset) / width)
+                    {
+                        throw invalid();
+                    }
+
+                    auto bytes = blockHeader.m_rows * width;
+
+                    block.m_columns.push_back(m_data + offset);
+
+                    // The characters of text follow the offsets, and end
+                    // where the last row does; every offset must lie within
+                    // them, in order.
+                    if(column.m_type == ColumnType::Text &&
+                       blockHeader.m_rows != 0)
+                    {
+                        const auto ends = reinterpret_cast<const uint64*>(
+                            m_data + offset);
+                        const auto last = ends[blockHeader.m_rows - 1];
+
+                        if(last > end - offset - bytes)
+                        {
+                            throw invalid();
+                        }
+
+                        for(uint64 row = 1; row < blockHeader.m_rows; row++)
+                        {
+                            if(ends[row] < ends[row - 1])
+                            {
+                                throw invalid();
+                            }
+                        }
+
+                        bytes += last;
+                    }
+
+                    if(getPadding(bytes) > end - offset - bytes)
+                    {
+                        throw invalid();
+                    }
+
+                    bytes += getPadding(bytes);
+
+                    offset += bytes;
+                }
+
+                if(offset != end)
+                {
+                    throw invalid();
+                }
+
+                m_rows += block.m_rows;
+                m_blocks.push_back(std::move(block));
+            }
+        }
+
+        void convertToCsv(const std::string& input, const std::string& output)
+        {
+            ColumnReader  reader(input);
+            std::ofstream outfile(output);
+
+            if(!outfile.is_open())
+            {
+                throw std::runtime_error("Could not write to CSV file: " +
+                                         output);
+            }
+
+            outputCsv(outfile, reader);
+            outfile.close();
+        }
+
+        void outputCsv(std::ostream& out, const ColumnReader& reader)
+        {
+            using namespace iris::types;
+
+            const auto& columns = reader.getColumns();
+
+            for(std::size_t j = 0; j < columns.size(); j++)
+            {
+                out << columns[j].m_name;
+
+                if(j < (columns.size() - 1))
+                {
+                    out << ",";
+                }
+            }
+
+            out << "\n";
+
+            for(std::size_t block = 0; block < reader.getBlockCount();
+                block++)
+            {
+                const auto rows = reader.getBlockRows(block);
+
+                for(uint64 row = 0; row < rows; row++)
+                {
+                    for(uint32 j = 0; j < columns.size(); j++)
+                    {
+                        // Values are formatted just as the CSV writers
+                        // format them.
+                        switch(columns[j].m_type)
+                        {
+                            case ColumnType::UInt8:
+                                out << static_cast<uint32>(
+                                    reader.getValues<uint8>(block, j)[row]);
+                                break;
+                            case ColumnType::UInt32:
+                                out << reader.getValues<uint32>(block, j)[row];
+                                break;
+                            case ColumnType::UInt64:
+                                out << reader.getValues<uint64>(block, j)[row];
+                                break;
+                            case ColumnType::Float64:
+                                out << reader.getValues<fnumeric>(block,
+                                                                  j)[row];
+                                break;
+                            case ColumnType::Text:
+                                out << reader.getText(block, j, row);
+                                break;
+                        }
+
+                        if(j < (columns.size() - 1))
+                        {
+                            out << ",";
+                        }
+                    }
+
+                    out << "\n";
+                }
+            }
+
+            out.flush();
+        }
+    }
+}
@@ -0,0 +1,304 @@
+#include "iris/io/writer/AsyncStatisticsWriter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+
+#include "iris/io/writer/ColumnWriter.hpp"
+
+namespace iris
+{
+    namespace io
+    {
+        const std::size_t AsyncStatisticsWriter::BlockBytes;
+
+        AsyncStatisticsWriter::AsyncStatisticsWriter(
+            StatisticsWriter& statistics, std::ostream& out,
+            types::uint32 capacity)
+            : m_closing(false), m_columns(nullptr), m_count(0), m_head(0),
+              m_metrics(), m_out(&out), m_slots(capacity),
+              m_statistics(statistics)
+        {
+            if(capacity == 0)
+            {
+                throw std::runtime_error("A statistics queue needs at least"
+                                         " one slot.");
+            }
+
+            // Format exactly as the stream would have.
+            m_block.imbue(out.getloc());
+            m_thread = std::thread(&AsyncStatisticsWriter::run, this);
+        }
+
+        AsyncStatisticsWriter::AsyncStatisticsWriter(
+            StatisticsWriter& statistics, ColumnWriter& out,
+            types::uint32 capacity)
+            : m_closing(false), m_columns(&out), m_count(0), m_head(0),
+              m_metrics(), m_out(nullptr), m_slots(capacity),
+              m_statistics(statistics)
+        {
+            if(capacity == 0)
+            {
+                throw std::runtime_error("A statistics queue needs at least"
+                                         " one slot.");
+            }
+
+            m_thread = std::thread(&AsyncStatisticsWriter::run, this);
+        }
+
+        AsyncStatisticsWriter::~AsyncStatisticsWriter()
+        {
+            if(m_thread.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_closing = true;
+                }
+
+                m_produced.notify_one();
+                m_thread.join();
+            }
+        }
+
+        void AsyncStatisticsWriter::close()
+        {
+            if(m_thread.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_closing = true;
+                }
+
+                m_produced.notify_one();
+                m_thread.join();
+            }
+
+            if(m_error)
+            {
+                std::rethrow_exception(m_error);
+            }
+        }
+
+        QueueMetrics AsyncStatisticsWriter::getMetrics() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_metrics;
+        }
+
+        void AsyncStatisticsWriter::push(types::uint64 currentTime)
+        {
+            using namespace std::chrono;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            if(m_closing)
+            {
+                throw std::runtime_error("The statistics writer is closed.");
+            }
+
+            if(m_count == m_slots.size() && !m_error)
+            {
+                // The file system has fallen behind; this is the only time
+                // the simulation waits on it.
+                const auto start = steady_clock::now();
+
+                m_consumed.wait(lock, [this]() {
+                    return m_count < m_slots.size() || m_error;
+                });
+
+                m_metrics.m_stalls++;
+                m_metrics.m_stallTime += static_cast<types::uint64>(
+                    duration_cast<nanoseconds>(steady_clock::now() -
+                                               start).count());
+            }
+
+            if(m_error)
+            {
+                std::rethrow_exception(m_error);
+            }
+
+            // The writer thread never touches a free slot, so the snapshot is
+            // taken without holding the lock.
+            const auto tail = (m_head + m_count) % m_slots.size();
+
+            lock.unlock();
+            m_statistics.snapshot(m_slots[tail], currentTime);
+            lock.lock();
+
+            m_count++;
+            m_metrics.m_pushes++;
+            m_metrics.m_peakDepth = std::max<types::uint64>(
+                m_metrics.m_peakDepth, m_count);
+
+            lock.unlock();
+            m_produced.notify_one();
+        }
+
+        void AsyncStatisticsWriter::run()
+        {
+            using namespace std::chrono;
+
+            try
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                while(true)
+                {
+                    m_produced.wait(lock, [this]() {
+                        return m_count != 0 || m_closing;
+                    });
+
+                    // Everything handed over is written before stopping.
+                    if(m_count == 0)
+                    {
+                        break;
+                    }
+
+                    const auto& slot = m_slots[m_head];
+
+                    lock.unlock();
+
+                    const auto start = steady_clock::now();
+
+                    if(m_columns)
+                    {
+                        m_statistics.write(*m_columns, slot);
+                    }
+                    else
+                    {
+                        m_statistics.write(m_block, slot);
+
+                        if(static_cast<std::size_t>(m_block.tellp()) >=
+                           BlockBytes)
+                        {
+                            this->writeBlock();
+                        }
+                    }
+
+                    const auto busy = static_cast<types::uint64>(
+                        duration_cast<nanoseconds>(steady_clock::now() -
+                                                   start).count());
+
+                    lock.lock();
+
+                    m_head = (m_head + 1) % m_slots.size();
+                    m_count--;
+                    m_metrics.m_busyTime += busy;
+
+                    lock.unlock();
+                    m_consumed.notify_one();
+                    lock.lock();
+                }
+
+                lock.unlock();
+
+                if(m_columns)
+                {
+                    m_columns->flush();
+                }
+                else
+                {
+                    this->writeBlock();
+                    m_out->flush();
+                }
+            }
+            catch(...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_error = std::current_exception();
+                }
+
+                // Release the simulation if it is waiting for room.
+                m_consumed.notify_one();
+            }
+        }
+
+        void AsyncStatisticsWriter::writeBlock()
+        {
+            const auto text = m_block.str();
+
+            if(text.empty())
+            {
+                return;
+            }
+
+            m_out->write(text.data(), text.size());
+            m_block.str(std::string());
+
+            if(!*m_out)
+            {
+                throw std::runtime_error("Could not write statistics.");
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_metrics.m_blocks++;
+        }
+
+        void writeQueueMetrics(const std::string& filename,
+                               const QueueMetrics& metrics,
+                               OutputFormat format, const Metadata& metadata)
+        {
+            if(format == OutputFormat::Binary)
+            {
+                std::ofstream outfile(filename, std::ios::binary);
+
+                if(!outfile.is_open())
+                {
+                    throw std::runtime_error("Could not write to column"
+                                             " file: " + filename);
+                }
+
+                ColumnWriter columns(outfile, getQueueColumns(), metadata);
+
+                outputQueueMetrics(columns, metrics);
+                columns.flush();
+                return;
+            }
+
+            std::ofstream outfile(filename);
+
+            if(!outfile.is_open())
+            {
+                throw std::runtime_error("Could not write to CSV file: " +
+                                         filename);
+            }
+
+            outputQueueMetrics(outfile, metrics);
+            outfile.close();
+        }
+
+        ColumnList getQueueColumns()
+        {
+            return ColumnList{
+                ColumnSpec{"Pushes", ColumnType::UInt64},
+                ColumnSpec{"Stalls", ColumnType::UInt64},
+                ColumnSpec{"StallTime", ColumnType::UInt64},
+                ColumnSpec{"PeakDepth", ColumnType::UInt64},
+                ColumnSpec{"Blocks", ColumnType::UInt64},
+                ColumnSpec{"BusyTime", ColumnType::UInt64}
+            };
+        }
+
+        void outputQueueMetrics(std::ostream& out,
+                                const QueueMetrics& metrics)
+        {
+            out << "Pushes,Stalls,StallTime,PeakDepth,Blocks,BusyTime\n"
+                << metrics.m_pushes << "," << metrics.m_stalls << ","
+                << metrics.m_stallTime << "," << metrics.m_peakDepth << ","
+                << metrics.m_blocks << "," << metrics.m_busyTime << "\n";
+        }
+
+        void outputQueueMetrics(ColumnWriter& out,
+                                const QueueMetrics& metrics)
+        {
+            out.putUnsigned(metrics.m_pushes).putUnsigned(metrics.m_stalls)
+               .putUnsigned(metrics.m_stallTime)
+               .putUnsigned(metrics.m_peakDepth)
+               .putUnsigned(metrics.m_blocks)
+               .putUnsigned(metrics.m_busyTime);
+            out.endRow();
+        }
+    }
+}
@@ -1,19 +1,97 @@
 #include "iris/io/writer/AttributeWriter.hpp"
 
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
 
-#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
 
 #include "iris/gen/AttributeGenerator.hpp"
 
+#include "iris/io/writer/ColumnWriter.hpp"
+
 namespace iris
 {
     namespace io
     {
+        /*!
+         * Visits the attributes of every agent in order.
+         *
+         * Values and behaviors are given as a single string of digits (see
+         * gen::convertListToString).
+         *
+         * @param agents
+         *        The store of agents.
+         * @param totalAgents
+         *        The total number of agents present.
+         * @param visit
+         *        What to do with each agent's unique identifier, family size,
+         *        power, privilege, values, and behaviors.
+         */
+        template<class Visitor>
+        void forEachAttribute(const AgentStore& agents, AgentID totalAgents,
+                              const Visitor& visit)
+        {
+            using namespace iris::types;
+
+            // The columns to write.
+            const auto& uids        = agents.getUIds();
+            const auto& familySizes = agents.getFamilySizes();
+            const auto& powerFlags  = agents.getPowerFlags();
+            const auto& privileges  = agents.getPrivileges();
+
+            const auto& valueCodec  = agents.getValueCodec();
+            const auto& behavCodec  = agents.getBehaviorCodec();
+
+            std::string valueText;
+            std::string behavText;
+
+            for(AgentID i = 0; i < totalAgents; i++)
+            {
+                const auto values   = agents.getValueWord(i);
+                const auto behavior = agents.getBehaviorWord(i);
+                const auto power    = powerFlags[i] != 0;
+
+                valueText.clear();
+                behavText.clear();
+
+                for(uint32 j = 0; j < valueCodec.size(); j++)
+                {
+                    valueText += std::to_string(valueCodec.get(values, j));
+                }
+
+                for(uint32 j = 0; j < behavCodec.size(); j++)
+                {
+                    behavText += std::to_string(behavCodec.get(behavior, j));
+                }
+
+                visit(uids[i], familySizes[i], power, privileges[i],
+                      valueText, behavText);
+            }
+        }
+
         void writeAttributes(const std::string& filename,
-                             Agent* const agents,
-                             AgentID totalAgents)
+                             const AgentStore& agents,
+                             AgentID totalAgents, OutputFormat format,
+                             const Metadata& metadata)
         {
+            if(format == OutputFormat::Binary)
+            {
+                std::ofstream outfile(filename, std::ios::binary);
+
+                if(!outfile.is_open())
+                {
+                    throw std::runtime_error("Could not write to column"
+                                             " file: " + filename);
+                }
+
+                ColumnWriter columns(outfile, getAttributeColumns(), metadata);
+
+                outputAttributes(columns, agents, totalAgents);
+                columns.flush();
+                return;
+            }
+
             std::ofstream outfile(filename);
 
             if(!outfile.is_open())
@@ -25,31 +103,55 @@ namespace iris
             outputAttributes(outfile, agents, totalAgents);
             outfile.close();
         }
-        
-        void outputAttributes(std::ostream& out, Agent* const agents,
-                              AgentID totalAgents)
+
+        ColumnList getAttributeColumns()
         {
-            using namespace iris;
-            using namespace gen;
+            using namespace iris::types;
 
+            return ColumnList{
+                ColumnSpec{"AgentID", getColumnType<AgentID>()},
+                ColumnSpec{"FamilySize", getColumnType<uint32>()},
+                ColumnSpec{"Power", getColumnType<uint8>()},
+                ColumnSpec{"Privilege", getColumnType<unumeric>()},
+                ColumnSpec{"Values", ColumnType::Text},
+                ColumnSpec{"Behavior", ColumnType::Text}
+            };
+        }
+
+        void outputAttributes(std::ostream& out, const AgentStore& agents,
+                              AgentID totalAgents)
+        {
             // Write header.
             out << "AgentID,FamilySize,Power,Privilege,"
-                << "Values,Behavior" << std::endl;
-            
-            for(AgentID i = 0; i < totalAgents; i++)
-            {
-                // Grab relevant information as locals for simplicity.
-                const auto id         = agents[i].getUId();
-                const auto familySize = agents[i].getFamilySize();
-                const auto values     = agents[i].getValues();
-                const auto behavior   = agents[i].getBehavior();
-                const auto privilege  = agents[i].getPrivilege();
-                const auto power      = agents[i].isPowerful();
-
-                out << id << "," << familySize << "," << power << ","
-                    << privilege << "," << convertListToString(values)
-                    << "," << convertListToString(behavior) << std::endl;
-            }
+                << "Values,Behavior\n";
+
+            forEachAttribute(agents, totalAgents,
+                             [&out](AgentID uid, types::uint32 familySize,
+                                    bool power, types::unumeric privilege,
+                                    const std::string& values,
+                                    const std::string& behavior) {
+                                 out << uid << "," << familySize << ","
+                                     << power << "," << privilege << ","
+                                     << values << "," << behavior << "\n";
+                             });
+        }
+
+        void outputAttributes(ColumnWriter& out, const AgentStore& agents,
+                              AgentID totalAgents)
+        {
+            forEachAttribute(agents, totalAgents,
+                             [&out](AgentID uid, types::uint32 familySize,
+                                    bool power, types::unumeric privilege,
+                                    const std::string& values,
+                                    const std::string& behavior) {
+                                 out.putUnsigned(uid)
+                                    .putUnsigned(familySize)
+                                    .putUnsigned(power)
+                                    .putUnsigned(privilege)
+                                    .putText(values)
+                                    .putText(behavior);
+                                 out.endRow();
+                             });
         }
     }
 }
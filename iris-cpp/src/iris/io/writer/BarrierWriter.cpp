@@ -0,0 +1,62 @@
+#include "iris/io/writer/BarrierWriter.hpp"
+
+#include <string>
+
+#include "iris/io/writer/ColumnWriter.hpp"
+
+namespace iris
+{
+    namespace io
+    {
+        ColumnList getBarrierColumns(types::uint32 numThreads)
+        {
+            ColumnList columns{ColumnSpec{"Time", ColumnType::UInt64}};
+
+            for(types::uint32 i = 0; i < numThreads; i++)
+            {
+                columns.push_back(ColumnSpec{"Thread" + std::to_string(i + 1),
+                                             ColumnType::UInt64});
+            }
+
+            return columns;
+        }
+
+        void writeBarrierHeader(std::ostream& out, types::uint32 numThreads)
+        {
+            out << "Time";
+
+            for(types::uint32 i = 0; i < numThreads; i++)
+            {
+                out << ",Thread" << (i + 1);
+            }
+
+            out << "\n";
+        }
+
+        void writeBarrierWaits(std::ostream& out, types::uint64 time,
+                               const std::vector<types::uint64>& waits)
+        {
+            out << time;
+
+            for(auto& wait : waits)
+            {
+                out << "," << wait;
+            }
+
+            out << "\n";
+        }
+
+        void writeBarrierWaits(ColumnWriter& out, types::uint64 time,
+                               const std::vector<types::uint64>& waits)
+        {
+            out.putUnsigned(time);
+
+            for(auto& wait : waits)
+            {
+                out.putUnsigned(wait);
+            }
+
+            out.endRow();
+        }
+    }
+}
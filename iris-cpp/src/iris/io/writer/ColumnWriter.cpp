@@ -0,0 +1,240 @@
+#include "iris/io/writer/ColumnWriter.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "iris/Utils.hpp"
+
+namespace iris
+{
+    namespace io
+    {
+        const std::size_t ColumnWriter::BlockBytes;
+
+        ColumnWriter::ColumnWriter(std::ostream& out,
+                                   const ColumnList& columns,
+                                   const Metadata& metadata)
+            : m_buffered(0), m_columns(columns), m_next(0), m_out(out),
+              m_pending(0), m_rows(0), m_textEnds(columns.size()),
+              m_values(columns.size())
+        {
+            using namespace iris::types;
+
+            const auto header = createColumnFileHeader(
+                static_cast<uint32>(columns.size()),
+                static_cast<uint32>(metadata.size()));
+
+            m_out.write(reinterpret_cast<const char*>(&header),
+                        sizeof(header));
+
+            uint64 written = sizeof(header);
+
+            for(auto& entry : metadata)
+            {
+                this->writeString(entry.first);
+                this->writeString(entry.second);
+
+                written += 2 * sizeof(uint32) + entry.first.size() +
+                    entry.second.size();
+            }
+
+            for(auto& column : columns)
+            {
+                // Fail here rather than on the first value.
+                getColumnWidth(column.m_type);
+
+                const auto type = static_cast<uint32>(column.m_type);
+
+                m_out.write(reinterpret_cast<const char*>(&type),
+                            sizeof(type));
+                this->writeString(column.m_name);
+
+                written += 2 * sizeof(uint32) + column.m_name.size();
+            }
+
+            const char zeros[8] = {};
+            m_out.write(zeros, getPadding(written));
+        }
+
+        ColumnWriter::~ColumnWriter()
+        {}
+
+        void ColumnWriter::append(ColumnType type, const void* bytes,
+                                  std::size_t size)
+        {
+            if(m_next >= m_columns.size())
+            {
+                throw std::runtime_error("There are only " +
+                                         util::toString(m_columns.size()) +
+                                         " columns in a row.");
+            }
+
+            const auto& column = m_columns[m_next];
+
+            // Integers may go in any integer column.
+            const auto isInteger = [](ColumnType kind) {
+                return kind == ColumnType::UInt8 ||
+                    kind == ColumnType::UInt32 || kind == ColumnType::UInt64;
+            };
+
+            if(type != column.m_type &&
+               !(isInteger(type) && isInteger(column.m_type)))
+            {
+                throw std::runtime_error("Column " + column.m_name +
+                                         " cannot hold that kind of value.");
+            }
+
+            auto& values = m_values[m_next];
+
+            values.insert(values.end(), static_cast<const char*>(bytes),
+                          static_cast<const char*>(bytes) + size);
+            m_buffered += size;
+
+            if(column.m_type == ColumnType::Text)
+            {
+                m_textEnds[m_next].push_back(values.size());
+                m_buffered += sizeof(types::uint64);
+            }
+
+            m_next++;
+        }
+
+        void ColumnWriter::endRow()
+        {
+            if(m_next != m_columns.size())
+            {
+                throw std::runtime_error("A row needs a value for every one"
+                                         " of its " +
+                                         util::toString(m_columns.size()) +
+                                         " columns.");
+            }
+
+            m_next = 0;
+            m_pending++;
+            m_rows++;
+
+            if(m_buffered >= BlockBytes)
+            {
+                this->flush();
+            }
+        }
+
+        void ColumnWriter::flush()
+        {
+            using namespace iris::types;
+
+            if(m_pending != 0)
+            {
+                const char zeros[8] = {};
+
+                BlockHeader header;
+
+                header.m_rows  = m_pending;
+                header.m_bytes = 0;
+
+                for(std::size_t j = 0; j < m_columns.size(); j++)
+                {
+                    const auto bytes = m_values[j].size() +
+                        m_textEnds[j].size() * sizeof(uint64);
+                    header.m_bytes += bytes + getPadding(bytes);
+                }
+
+                m_out.write(reinterpret_cast<const char*>(&header),
+                            sizeof(header));
+
+                for(std::size_t j = 0; j < m_columns.size(); j++)
+                {
+                    auto& ends   = m_textEnds[j];
+                    auto& values = m_values[j];
+
+                    m_out.write(reinterpret_cast<const char*>(ends.data()),
+                                ends.size() * sizeof(uint64));
+                    m_out.write(values.data(), values.size());
+                    m_out.write(zeros, getPadding(ends.size() *
+                                                  sizeof(uint64) +
+                                                  values.size()));
+
+                    // Keep the capacity for the next block.
+                    ends.clear();
+                    values.clear();
+                }
+
+                m_buffered = 0;
+                m_pending  = 0;
+            }
+
+            m_out.flush();
+
+            if(!m_out)
+            {
+                throw std::runtime_error("Could not write a column file.");
+            }
+        }
+
+        ColumnWriter& ColumnWriter::putReal(types::fnumeric value)
+        {
+            this->append(ColumnType::Float64, &value, sizeof(value));
+            return *this;
+        }
+
+        ColumnWriter& ColumnWriter::putText(const std::string& value)
+        {
+            this->append(ColumnType::Text, value.data(), value.size());
+            return *this;
+        }
+
+        ColumnWriter& ColumnWriter::putUnsigned(types::uint64 value)
+        {
+            using namespace iris::types;
+
+            const auto type = (m_next < m_columns.size()) ?
+                m_columns[m_next].m_type : ColumnType::UInt64;
+
+            // Store the value at the width of its column, which must hold
+            // it exactly, just as the CSV would.
+            const auto checkFits = [this, value](uint64 most) {
+                if(value > most)
+                {
+                    throw std::runtime_error(
+                        "Column " + m_columns[m_next].m_name + " cannot hold" +
+                        " the value " + util::toString(value) + ".");
+                }
+            };
+
+            switch(type)
+            {
+                case ColumnType::UInt8:
+                {
+                    checkFits(std::numeric_limits<uint8>::max());
+
+                    const auto narrow = static_cast<uint8>(value);
+                    this->append(type, &narrow, sizeof(narrow));
+                    break;
+                }
+                case ColumnType::UInt32:
+                {
+                    checkFits(std::numeric_limits<uint32>::max());
+
+                    const auto narrow = static_cast<uint32>(value);
+                    this->append(type, &narrow, sizeof(narrow));
+                    break;
+                }
+                default:
+                    this->append(ColumnType::UInt64, &value, sizeof(value));
+                    break;
+            }
+
+            return *this;
+        }
+
+        void ColumnWriter::writeString(const std::string& value)
+        {
+            const auto length = static_cast<types::uint32>(value.size());
+
+            m_out.write(reinterpret_cast<const char*>(&length),
+                        sizeof(length));
+            m_out.write(value.data(), value.size());
+        }
+    }
+}
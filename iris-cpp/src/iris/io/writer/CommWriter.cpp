@@ -3,15 +3,35 @@
 #include <fstream>
 #include <stdexcept>
 
-#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+
+#include "iris/io/writer/ColumnWriter.hpp"
 
 namespace iris
 {
     namespace io
     {
-        void writeComm(const std::string& filename, Agent* const agents,
-                       AgentID totalAgents, types::uint64 time)
+        void writeComm(const std::string& filename, const AgentStore& agents,
+                       AgentID totalAgents, types::uint64 time,
+                       OutputFormat format, const Metadata& metadata)
         {
+            if(format == OutputFormat::Binary)
+            {
+                std::ofstream outfile(filename, std::ios::binary);
+
+                if(!outfile.is_open())
+                {
+                    throw std::runtime_error("Could not write to column"
+                                             " file: " + filename);
+                }
+
+                ColumnWriter columns(outfile, getCommColumns(), metadata);
+
+                outputComm(columns, agents, totalAgents, time);
+                columns.flush();
+                return;
+            }
+
             std::ofstream outfile(filename);
 
             if(!outfile.is_open())
@@ -23,26 +43,45 @@ namespace iris
             outputComm(outfile, agents, totalAgents, time);
             outfile.close();
         }
-        
-        void outputComm(std::ostream& out, Agent* const agents,
+
+        ColumnList getCommColumns()
+        {
+            return ColumnList{
+                ColumnSpec{"From", getColumnType<AgentID>()},
+                ColumnSpec{"To", getColumnType<AgentID>()},
+                ColumnSpec{"Power", getColumnType<types::fnumeric>()}
+            };
+        }
+
+        void outputComm(std::ostream& out, const AgentStore& agents,
                          AgentID totalAgents, types::uint64 time)
         {
-            using namespace iris::types;
-            out << "From,To,Power" << std::endl;
+            const auto realTime = static_cast<types::fnumeric>(2 * time);
 
-            const auto realTime = static_cast<fnumeric>(2 * time);
-            for(AgentID i = 0; i < totalAgents; i++)
-            {
-                const auto id       = agents[i].getUId();                
-                for(const auto comm : agents[i].getInteractions())
-                {
-                    const auto     otherId = comm.first;
-                    const auto     prob    =
-                        comm.second.m_communicated / realTime;
-                    
-                    out << id << "," << otherId << "," << prob << std::endl;
-                }
-            }
+            out << "From,To,Power\n";
+
+            forEachInteraction(agents, totalAgents,
+                               [&out, realTime](AgentID from, AgentID to,
+                                                const Interaction& comm) {
+                                   out << from << "," << to << ","
+                                       << comm.m_communicated / realTime
+                                       << "\n";
+                               });
+        }
+
+        void outputComm(ColumnWriter& out, const AgentStore& agents,
+                        AgentID totalAgents, types::uint64 time)
+        {
+            const auto realTime = static_cast<types::fnumeric>(2 * time);
+
+            forEachInteraction(agents, totalAgents,
+                               [&out, realTime](AgentID from, AgentID to,
+                                                const Interaction& comm) {
+                                   out.putUnsigned(from).putUnsigned(to)
+                                      .putReal(comm.m_communicated /
+                                               realTime);
+                                   out.endRow();
+                               });
         }
     }
 }
@@ -3,16 +3,74 @@
 #include <fstream>
 #include <stdexcept>
 
-#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+
+#include "iris/io/writer/ColumnWriter.hpp"
 
 namespace iris
 {
     namespace io
     {
+        /*!
+         * Visits every edge of the social network in order.
+         *
+         * @param agents
+         *        The store of agents.
+         * @param totalAgents
+         *        The total number of agents present.
+         * @param visit
+         *        What to do with the unique identifiers at either end.
+         */
+        template<class Visitor>
+        void forEachEdge(const AgentStore& agents, AgentID totalAgents,
+                         const Visitor& visit)
+        {
+            const auto& uids = agents.getUIds();
+
+            for(AgentID i = 0; i < totalAgents; i++)
+            {
+                const auto uid     = uids[i];
+                const auto network = agents.getNetwork(i);
+
+                for(auto j = (Agent::NetworkView::size_type)0;
+                    j < network.size(); j++)
+                {
+                    // This is an input-oriented graph, so the edges from all
+                    // the agents in the network point *towards* the current
+                    // agent, not away.
+                    //
+                    // Positions beyond the store only appear in hand-built
+                    // networks, so they are written as they are.
+                    const auto from = (network[j] < uids.size()) ?
+                        uids[network[j]] : network[j];
+
+                    visit(from, uid);
+                }
+            }
+        }
+
         void writeNetwork(const std::string& filename,
-                          iris::Agent* const agents,
-                          AgentID totalAgents)
+                          const AgentStore& agents,
+                          AgentID totalAgents, OutputFormat format,
+                          const Metadata& metadata)
         {
+            if(format == OutputFormat::Binary)
+            {
+                std::ofstream outfile(filename, std::ios::binary);
+
+                if(!outfile.is_open())
+                {
+                    throw std::runtime_error("Could not write to column"
+                                             " file: " + filename);
+                }
+
+                ColumnWriter columns(outfile, getNetworkColumns(), metadata);
+
+                outputNetwork(columns, agents, totalAgents);
+                columns.flush();
+                return;
+            }
+
             std::ofstream outfile(filename);
 
             if(!outfile.is_open())
@@ -25,26 +83,33 @@ namespace iris
             outfile.close();
         }
 
+        ColumnList getNetworkColumns()
+        {
+            return ColumnList{
+                ColumnSpec{"From", getColumnType<AgentID>()},
+                ColumnSpec{"To", getColumnType<AgentID>()}
+            };
+        }
+
         void outputNetwork(std::ostream& out,
-                           iris::Agent* const agents,
+                           const AgentStore& agents,
                            AgentID totalAgents)
         {
             // Write a header.
-            out << "From,To" << std:: endl;
-            
-            for(AgentID i = 0; i < totalAgents; i++)
-            {
-                const auto uid     = agents[i].getUId();
-                const auto network = agents[i].getNetwork();
+            out << "From,To\n";
 
-                for(Agent::Network::size_type j = 0; j < network.size(); j++)
-                {
-                    // This is an input-oriented graph, so the edges from all
-                    // the agents in the network point *towards* the current
-                    // agent, not away.
-                    out << network[j] << "," << uid << std::endl;
-                }
-            }
+            forEachEdge(agents, totalAgents, [&out](AgentID from, AgentID to) {
+                out << from << "," << to << "\n";
+            });
+        }
+
+        void outputNetwork(ColumnWriter& out, const AgentStore& agents,
+                           AgentID totalAgents)
+        {
+            forEachEdge(agents, totalAgents, [&out](AgentID from, AgentID to) {
+                out.putUnsigned(from).putUnsigned(to);
+                out.endRow();
+            });
         }
     }
 }
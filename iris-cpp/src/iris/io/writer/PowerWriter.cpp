@@ -3,15 +3,46 @@
 #include <fstream>
 #include <stdexcept>
 
-#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+
+#include "iris/io/writer/ColumnWriter.hpp"
 
 namespace iris
 {
     namespace io
     {
-        void writePower(const std::string& filename, Agent* const agents,
-                        AgentID totalAgents)
+        types::fnumeric computePower(const Interaction& comm)
+        {
+            using namespace iris::types;
+
+            const auto     communicated =
+                static_cast<fnumeric>(comm.m_communicated);
+            const fnumeric power        = comm.m_censored + comm.m_reinforced;
+
+            return power / communicated;
+        }
+
+        void writePower(const std::string& filename, const AgentStore& agents,
+                        AgentID totalAgents, OutputFormat format,
+                        const Metadata& metadata)
         {
+            if(format == OutputFormat::Binary)
+            {
+                std::ofstream outfile(filename, std::ios::binary);
+
+                if(!outfile.is_open())
+                {
+                    throw std::runtime_error("Could not write to column"
+                                             " file: " + filename);
+                }
+
+                ColumnWriter columns(outfile, getPowerColumns(), metadata);
+
+                outputPower(columns, agents, totalAgents);
+                columns.flush();
+                return;
+            }
+
             std::ofstream outfile(filename);
 
             if(!outfile.is_open())
@@ -23,29 +54,39 @@ namespace iris
             outputPower(outfile, agents, totalAgents);
             outfile.close();
         }
-        
-        void outputPower(std::ostream& out, Agent* const agents,
+
+        ColumnList getPowerColumns()
+        {
+            return ColumnList{
+                ColumnSpec{"From", getColumnType<AgentID>()},
+                ColumnSpec{"To", getColumnType<AgentID>()},
+                ColumnSpec{"Power", getColumnType<types::fnumeric>()}
+            };
+        }
+
+        void outputPower(std::ostream& out, const AgentStore& agents,
                          AgentID totalAgents)
         {
-            using namespace iris::types;
-            out << "From,To,Power" << std::endl;
-            
-            for(AgentID i = 0; i < totalAgents; i++)
-            {
-                const auto id       = agents[i].getUId();              
-                for(const auto comm : agents[i].getInteractions())
-                {
-                    const auto     otherId      = comm.first;
-                    const auto     communicated =
-                        static_cast<fnumeric>(comm.second.m_communicated);
-                    
-                    const fnumeric power   =
-                        comm.second.m_censored + comm.second.m_reinforced;
-                    const fnumeric prob    = power / communicated;
-
-                    out << id << "," << otherId << "," << prob << std::endl;
-                }
-            }
+            out << "From,To,Power\n";
+
+            forEachInteraction(agents, totalAgents,
+                               [&out](AgentID from, AgentID to,
+                                      const Interaction& comm) {
+                                   out << from << "," << to << ","
+                                       << computePower(comm) << "\n";
+                               });
+        }
+
+        void outputPower(ColumnWriter& out, const AgentStore& agents,
+                         AgentID totalAgents)
+        {
+            forEachInteraction(agents, totalAgents,
+                               [&out](AgentID from, AgentID to,
+                                      const Interaction& comm) {
+                                   out.putUnsigned(from).putUnsigned(to)
+                                      .putReal(computePower(comm));
+                                   out.endRow();
+                               });
         }
     }
 }
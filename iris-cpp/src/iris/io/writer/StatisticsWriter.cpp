@@ -1,5 +1,6 @@
 #include "iris/io/writer/StatisticsWriter.hpp"
 
+#include <algorithm>
 #include <ctime>
 #include <locale>
 #include <stdexcept>
@@ -7,9 +8,12 @@
 
 #include <sys/stat.h>
 
-#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/DeltaBuffer.hpp"
 #include "iris/Utils.hpp"
 
+#include "iris/io/writer/ColumnWriter.hpp"
+
 namespace iris
 {
     namespace io
@@ -43,89 +47,613 @@ namespace iris
             return dirPath;
         }
 
+        const types::uint32 StatisticsWriter::LookupBits;
+        const AgentID       StatisticsWriter::MinAgentsPerPart;
+
         StatisticsWriter::StatisticsWriter()
+            : m_combinations(0), m_limit(0), m_numThreads(1), m_sparse(false),
+              m_totalPrivilege(0)
         {}
 
         StatisticsWriter::~StatisticsWriter()
         {}
 
+        void StatisticsWriter::appendPermutation(std::string& text,
+                                                 types::uint64 index) const
+        {
+            for(types::uint32 j = 0; j < m_codec.size(); j++)
+            {
+                text += std::to_string((index / m_strides[j]) %
+                                       m_codec.getRange(j));
+            }
+        }
+
         void StatisticsWriter::clear()
+        {
+            std::fill(m_census.begin(), m_census.end(), 0);
+            m_changes.clear();
+            m_occupied.clear();
+            m_totalPrivilege = 0;
+        }
+
+        void StatisticsWriter::count(const AgentStore& agents,
+                                     AgentID totalAgents)
         {
             using namespace iris::types;
-            
-            for(auto& pe : m_permutes)
+
+            const auto& codec = agents.getBehaviorCodec();
+
+            if(codec.size() != m_codec.size() ||
+               codec.getWidth() != m_codec.getWidth())
+            {
+                throw std::runtime_error("The agents' behaviors do not match"
+                                         " those of the census.");
+            }
+
+            // A full count replaces any changes not yet applied.
+            m_changes.clear();
+
+            // Only populations large enough to repay a thread get one.
+            const auto parts = static_cast<uint32>(std::max<uint64>(
+                1, std::min<uint64>(m_numThreads,
+                                    totalAgents / MinAgentsPerPart)));
+
+            m_privileges.assign(parts, 0);
+
+            if(m_sparse)
+            {
+                this->countSparse(agents, totalAgents, parts);
+            }
+            else
+            {
+                this->countDense(agents, totalAgents, parts);
+            }
+
+            for(uint32 part = 0; part < parts; part++)
             {
-                m_census[pe] = static_cast<uint32>(0);
+                m_totalPrivilege += m_privileges[part];
             }
         }
 
-        void StatisticsWriter::initialize(const Uint32List &behavior)
+        void StatisticsWriter::countDense(const AgentStore& agents,
+                                          AgentID totalAgents,
+                                          types::uint32 parts)
         {
-            using namespace iris::gen;
             using namespace iris::types;
+            using namespace iris::util;
 
-            m_permutes = permuteList(behavior);
+            m_partials.resize(parts);
+
+            runParts(totalAgents, parts,
+                     [this, &agents](uint32 part, uint64 first, uint64 last) {
+                         const auto& privileges = agents.getPrivileges();
+
+                         auto& counts = m_partials[part];
+                         auto  total  = static_cast<uint64>(0);
+
+                         counts.assign(m_census.size(), 0);
+
+                         if(!m_lookup.empty())
+                         {
+                             for(auto i = first; i < last; i++)
+                             {
+                                 counts[m_lookup[agents.getBehaviorWord(i)]]++;
+                                 total += privileges[i];
+                             }
+                         }
+                         else
+                         {
+                             for(auto i = first; i < last; i++)
+                             {
+                                 counts[this->getIndex(
+                                     agents.getBehaviorWord(i))]++;
+                                 total += privileges[i];
+                             }
+                         }
+
+                         m_privileges[part] = total;
+                     });
 
-            for(auto& perm : m_permutes)
+            this->clear();
+
+            for(uint32 part = 0; part < parts; part++)
             {
-                const auto defValue = static_cast<uint32>(0);
-                const auto cenValue =
-                    std::pair<std::string, uint32>(perm, defValue);
-                
-                m_census.insert(cenValue);
+                for(std::size_t j = 0; j < m_census.size(); j++)
+                {
+                    m_census[j] += m_partials[part][j];
+                }
             }
         }
 
-        void StatisticsWriter::writeHeader(std::ostream &out)
+        void StatisticsWriter::countSparse(const AgentStore& agents,
+                                           AgentID totalAgents,
+                                           types::uint32 parts)
         {
-            using namespace iris::gen;            
-            out << "Time,Privilege,";
+            using namespace iris::types;
+            using namespace iris::util;
 
-            for(PermuteList::size_type i = 0; i < m_permutes.size(); i++)
+            m_keys.resize(totalAgents);
+            m_sparsePartials.resize(parts);
+
+            runParts(totalAgents, parts,
+                     [this, &agents](uint32 part, uint64 first, uint64 last) {
+                         const auto& privileges = agents.getPrivileges();
+
+                         auto& entries = m_sparsePartials[part];
+                         auto  total   = static_cast<uint64>(0);
+
+                         for(auto i = first; i < last; i++)
+                         {
+                             m_keys[i] = this->lookUp(
+                                 agents.getBehaviorWord(i));
+                             total += privileges[i];
+                         }
+
+                         // Equal permutations end up next to each other, so
+                         // each run is one occupied permutation.
+                         std::sort(m_keys.begin() + first,
+                                   m_keys.begin() + last);
+
+                         entries.clear();
+
+                         for(auto i = first; i < last; i++)
+                         {
+                             if(entries.empty() ||
+                                entries.back().m_index != m_keys[i])
+                             {
+                                 entries.push_back(CensusEntry{m_keys[i], 0});
+                             }
+
+                             entries.back().m_count++;
+                         }
+
+                         m_privileges[part] = total;
+                     });
+
+            this->clear();
+
+            for(uint32 part = 0; part < parts; part++)
             {
-                out << m_permutes[i];
-                
-                if(i < (m_permutes.size() - 1))
+                m_occupied.insert(m_occupied.end(),
+                                  m_sparsePartials[part].begin(),
+                                  m_sparsePartials[part].end());
+            }
+
+            if(parts == 1)
+            {
+                return;
+            }
+
+            // Every part holds each permutation at most once, so combining
+            // them only has to add up a handful of neighbours.
+            std::sort(m_occupied.begin(), m_occupied.end(),
+                      [](const CensusEntry& lhs, const CensusEntry& rhs) {
+                          return lhs.m_index < rhs.m_index;
+                      });
+
+            std::size_t kept = 0;
+
+            for(std::size_t j = 0; j < m_occupied.size(); j++)
+            {
+                if(kept != 0 &&
+                   m_occupied[kept - 1].m_index == m_occupied[j].m_index)
                 {
-                    out << ",";
+                    m_occupied[kept - 1].m_count += m_occupied[j].m_count;
+                }
+                else
+                {
+                    m_occupied[kept++] = m_occupied[j];
                 }
             }
 
-            out << std::endl;
+            m_occupied.resize(kept);
         }
-        
-        void StatisticsWriter::writeStatistics(std::ostream &out,
-                                               Agent *const agents,
-                                               AgentID totalAgents,
-                                               types::uint64 currentTime)
+
+        ColumnList StatisticsWriter::getColumns() const
+        {
+            ColumnList columns{
+                ColumnSpec{"Time", ColumnType::UInt64},
+                ColumnSpec{"Privilege", ColumnType::UInt64}
+            };
+
+            if(m_sparse)
+            {
+                columns.push_back(ColumnSpec{"Behavior", ColumnType::Text});
+                columns.push_back(ColumnSpec{"Count", ColumnType::UInt64});
+                return columns;
+            }
+
+            for(auto& permute : m_permutes)
+            {
+                columns.push_back(ColumnSpec{permute, ColumnType::UInt64});
+            }
+
+            return columns;
+        }
+
+        types::uint64 StatisticsWriter::getIndex(
+            types::attribute_word word) const
+        {
+            types::uint64 index = 0;
+
+            for(types::uint32 j = 0; j < m_codec.size(); j++)
+            {
+                const auto digit = m_codec.get(word, j);
+
+                if(digit >= m_codec.getRange(j))
+                {
+                    return m_combinations;
+                }
+
+                index += digit * m_strides[j];
+            }
+
+            return index;
+        }
+
+        void StatisticsWriter::initialize(const Uint32List &behavior,
+                                          types::uint32 numThreads)
         {
             using namespace iris::gen;
+
+            this->prepare(behavior, numThreads);
+
+            m_limit    = 0;
+            m_permutes = permuteList(behavior);
+            m_sparse   = false;
+
+            m_census.assign(m_permutes.size() + 1, 0);
+            m_changes.clear();
+            m_occupied.clear();
+        }
+
+        void StatisticsWriter::initializeSparse(const Uint32List& behavior,
+                                                types::uint32 numThreads,
+                                                types::uint64 limit)
+        {
+            this->prepare(behavior, numThreads);
+
+            m_limit  = limit;
+            m_sparse = true;
+
+            // Nothing is ever indexed by permutation, so none are listed.
+            m_census.clear();
+            m_permutes.clear();
+            m_changes.clear();
+            m_occupied.clear();
+        }
+
+        void StatisticsWriter::prepare(const Uint32List& behavior,
+                                       types::uint32 numThreads)
+        {
             using namespace iris::types;
-            
-            this->clear();
-            uint64 totalPrivilege = 0;
-            
-            for(AgentID i = 0; i < totalAgents; i++)
+
+            if(numThreads == 0)
+            {
+                throw std::runtime_error("The number of threads must be at"
+                                         " least one.");
+            }
+
+            m_codec          = AttributeCodec(behavior);
+            m_numThreads     = numThreads;
+            m_totalPrivilege = 0;
+
+            // The last behavior is the least significant digit, just as it
+            // is the last to vary in the permutations.
+            m_strides.assign(behavior.size(), 1);
+
+            for(auto j = behavior.size(); j > 1; j--)
+            {
+                m_strides[j - 2] = m_strides[j - 1] * behavior[j - 1];
+            }
+
+            m_combinations = behavior.empty() ? 0 :
+                m_strides[0] * behavior[0];
+
+            m_lookup.clear();
+
+            if(m_codec.getWidth() <= LookupBits)
+            {
+                m_lookup.resize(static_cast<std::size_t>(1) <<
+                                m_codec.getWidth());
+
+                for(std::size_t word = 0; word < m_lookup.size(); word++)
+                {
+                    m_lookup[word] = static_cast<uint32>(this->getIndex(
+                        static_cast<attribute_word>(word)));
+                }
+            }
+        }
+
+        Span<const StatisticsWriter::CensusEntry>
+        StatisticsWriter::selectWritten()
+        {
+            this->settleOccupied();
+
+            // Agents whose behaviors are out of range sort last, and are
+            // never written.
+            auto end = m_occupied.end();
+
+            if(!m_occupied.empty() &&
+               m_occupied.back().m_index == m_combinations)
+            {
+                --end;
+            }
+
+            const auto* first = m_occupied.data();
+            const auto* last  = first + (end - m_occupied.begin());
+
+            if(m_limit != 0 && static_cast<types::uint64>(last - first) >
+               m_limit)
+            {
+                // Keep the most common permutations (the first on a tie), but
+                // still write them in order.
+                m_selected.assign(first, last);
+
+                std::nth_element(m_selected.begin(),
+                                 m_selected.begin() + m_limit - 1,
+                                 m_selected.end(),
+                                 [](const CensusEntry& lhs,
+                                    const CensusEntry& rhs) {
+                                     return lhs.m_count != rhs.m_count ?
+                                         lhs.m_count > rhs.m_count :
+                                         lhs.m_index < rhs.m_index;
+                                 });
+
+                m_selected.resize(m_limit);
+                std::sort(m_selected.begin(), m_selected.end(),
+                          [](const CensusEntry& lhs, const CensusEntry& rhs) {
+                              return lhs.m_index < rhs.m_index;
+                          });
+
+                first = m_selected.data();
+                last  = first + m_selected.size();
+            }
+
+            return Span<const CensusEntry>(first, last);
+        }
+
+        void StatisticsWriter::settleOccupied()
+        {
+            using namespace iris::types;
+
+            if(m_changes.empty())
+            {
+                return;
+            }
+
+            std::sort(m_changes.begin(), m_changes.end(),
+                      [](const CensusChange& lhs, const CensusChange& rhs) {
+                          return lhs.m_index < rhs.m_index;
+                      });
+
+            // Merge the net change of every permutation with the census, in
+            // a single pass over both.
+            auto occupied = m_occupied.cbegin();
+
+            m_merged.clear();
+
+            for(std::size_t j = 0; j < m_changes.size(); )
+            {
+                const auto index = m_changes[j].m_index;
+                int64      count = 0;
+
+                for(; j < m_changes.size() && m_changes[j].m_index == index;
+                    j++)
+                {
+                    count += m_changes[j].m_change;
+                }
+
+                while(occupied != m_occupied.cend() &&
+                      occupied->m_index < index)
+                {
+                    m_merged.push_back(*occupied++);
+                }
+
+                if(occupied != m_occupied.cend() &&
+                   occupied->m_index == index)
+                {
+                    count += static_cast<int64>(occupied->m_count);
+                    ++occupied;
+                }
+
+                // Nobody can leave a permutation that nobody holds.
+                if(count > 0)
+                {
+                    m_merged.push_back(
+                        CensusEntry{index, static_cast<uint64>(count)});
+                }
+            }
+
+            m_merged.insert(m_merged.end(), occupied, m_occupied.cend());
+            m_occupied.swap(m_merged);
+            m_changes.clear();
+        }
+
+        void StatisticsWriter::update(const DeltaBuffer& deltas)
+        {
+            // An agent changes at most once per step, so its old behaviors
+            // are still counted where it left them.
+            if(m_sparse)
+            {
+                // Changes are only sorted into the census once it is read.
+                for(auto& transition : deltas.getTransitions())
+                {
+                    m_changes.push_back(
+                        CensusChange{this->lookUp(transition.m_from), -1});
+                    m_changes.push_back(
+                        CensusChange{this->lookUp(transition.m_to), 1});
+                }
+            }
+            else
+            {
+                for(auto& transition : deltas.getTransitions())
+                {
+                    m_census[this->lookUp(transition.m_from)]--;
+                    m_census[this->lookUp(transition.m_to)]++;
+                }
+            }
+
+            m_totalPrivilege += deltas.getPrivilegeTally();
+        }
+
+        bool StatisticsWriter::verify(const AgentStore& agents,
+                                      AgentID totalAgents)
+        {
+            const auto expectedPrivilege = m_totalPrivilege;
+
+            this->settleOccupied();
+
+            m_expected         = m_census;
+            m_expectedOccupied = m_occupied;
+            this->count(agents, totalAgents);
+
+            const auto sameEntry = [](const CensusEntry& lhs,
+                                      const CensusEntry& rhs) {
+                return lhs.m_index == rhs.m_index &&
+                    lhs.m_count == rhs.m_count;
+            };
+
+            return m_expected == m_census &&
+                m_expectedOccupied.size() == m_occupied.size() &&
+                std::equal(m_occupied.begin(), m_occupied.end(),
+                           m_expectedOccupied.begin(), sameEntry) &&
+                expectedPrivilege == m_totalPrivilege;
+        }
+
+        void StatisticsWriter::snapshot(Snapshot& into,
+                                        types::uint64 currentTime)
+        {
+            into.m_time      = currentTime;
+            into.m_privilege = m_totalPrivilege;
+
+            if(!m_sparse)
+            {
+                // The final count (out of range) is never written.
+                into.m_counts.assign(m_census.begin(),
+                                     m_census.begin() + m_permutes.size());
+                into.m_entries.clear();
+                return;
+            }
+
+            const auto written = this->selectWritten();
+
+            into.m_counts.clear();
+            into.m_entries.assign(written.begin(), written.end());
+        }
+
+        void StatisticsWriter::write(std::ostream& out,
+                                     types::uint64 currentTime)
+        {
+            this->snapshot(m_snapshot, currentTime);
+            this->write(out, m_snapshot);
+        }
+
+        void StatisticsWriter::write(ColumnWriter& out,
+                                     types::uint64 currentTime)
+        {
+            this->snapshot(m_snapshot, currentTime);
+            this->write(out, m_snapshot);
+        }
+
+        void StatisticsWriter::write(std::ostream& out,
+                                     const Snapshot& snapshot) const
+        {
+            // Rows end without flushing; the stream is flushed by whoever
+            // owns it, in blocks.
+            if(!m_sparse)
             {
-                const auto key = convertListToString(agents[i].getBehavior());
-                m_census[key] += 1;
+                out << snapshot.m_time << "," << snapshot.m_privilege << ",";
+
+                for(std::size_t j = 0; j < snapshot.m_counts.size(); j++)
+                {
+                    out << snapshot.m_counts[j];
+
+                    if(j < (snapshot.m_counts.size() - 1))
+                    {
+                        out << ",";
+                    }
+                }
 
-                totalPrivilege += agents[i].getPrivilege();                
+                out << "\n";
+                return;
             }
 
-            out << currentTime << "," << totalPrivilege << ",";
+            std::string text;
 
-            for(PermuteList::size_type j = 0; j < m_permutes.size(); j++)
+            for(auto& entry : snapshot.m_entries)
             {
-                out << m_census[m_permutes[j]];
+                text.clear();
+                this->appendPermutation(text, entry.m_index);
 
-                if(j < (m_permutes.size() - 1))
+                out << snapshot.m_time << "," << snapshot.m_privilege << ","
+                    << text << "," << entry.m_count << "\n";
+            }
+        }
+
+        void StatisticsWriter::write(ColumnWriter& out,
+                                     const Snapshot& snapshot) const
+        {
+            if(!m_sparse)
+            {
+                out.putUnsigned(snapshot.m_time)
+                   .putUnsigned(snapshot.m_privilege);
+
+                for(auto& count : snapshot.m_counts)
+                {
+                    out.putUnsigned(count);
+                }
+
+                out.endRow();
+                return;
+            }
+
+            std::string text;
+
+            for(auto& entry : snapshot.m_entries)
+            {
+                text.clear();
+                this->appendPermutation(text, entry.m_index);
+
+                out.putUnsigned(snapshot.m_time)
+                   .putUnsigned(snapshot.m_privilege)
+                   .putText(text).putUnsigned(entry.m_count);
+                out.endRow();
+            }
+        }
+
+        void StatisticsWriter::writeHeader(std::ostream &out)
+        {
+            using namespace iris::gen;
+
+            if(m_sparse)
+            {
+                out << "Time,Privilege,Behavior,Count\n";
+                return;
+            }
+
+            out << "Time,Privilege,";
+
+            for(PermuteList::size_type i = 0; i < m_permutes.size(); i++)
+            {
+                out << m_permutes[i];
+                
+                if(i < (m_permutes.size() - 1))
                 {
                     out << ",";
                 }
             }
 
-            out << std::endl;
+            out << "\n";
+        }
+
+        void StatisticsWriter::writeStatistics(std::ostream &out,
+                                               const AgentStore& agents,
+                                               AgentID totalAgents,
+                                               types::uint64 currentTime)
+        {
+            this->count(agents, totalAgents);
+            this->write(out, currentTime);
         }
     }
 }
@@ -35,9 +35,11 @@ int main(int argc, char** argv)
     iris::util::term::Sequence def(iris::util::term::Color::Default);
     
     // The command line arguments are as follows:
-    //    [directory] [threads]
+    //    [directory] [run] [threads] [chunk] [affinity] [order] [stream]
+    //    [seed] [incremental] [sparse] [format] [queue]
     // of the form:
-    //    [path] [uint]
+    //    [path] [uint] [uint] [uint] [none|compact|scatter] [none|bfs|rcm]
+    //    [uint] [uint] [uint] [uint] [csv|binary] [uint]
     iris::io::CommandParser parser;
     iris::io::Options       options;
 
@@ -54,9 +56,13 @@ int main(int argc, char** argv)
         return 0;
     }
 
-    // Generate the seed for the (core) random number generator.
+    // Use the requested seed, if any, so that a run may be reproduced
+    // exactly; otherwise generate one from the clock.
     const auto currentTime = std::chrono::high_resolution_clock::now();
-    const auto currentSeed = currentTime.time_since_epoch().count();
+    const auto currentSeed = options.has("seed") ?
+        options.get<iris::types::uint64>("seed") :
+        static_cast<iris::types::uint64>(
+            currentTime.time_since_epoch().count());
     
     // The model itself.
     iris::Model model;
@@ -71,6 +77,7 @@ int main(int argc, char** argv)
         // Generate the graph (wire up family units => friends outside).
         model.generateGraphStructure();
         model.generateAttributes();
+        model.renumberAgents();
 
         // Set up streaming.
         model.setUpIoStreams();
@@ -86,7 +93,7 @@ int main(int argc, char** argv)
     try
     {      
         // Set up the threading model.
-        //        model.setUpThreading();
+        model.setUpThreading();
       
         // Run the simulation.
         model.runSimulation();
@@ -111,6 +118,38 @@ iris::io::CommandParser createCommandParser()
     parser.addOption("directory", 1, "The directory containing simulation"
                                      " data files.");
     parser.addOption("run", 1, "The current simulation run.");
+    parser.addOption("threads", 1, "The number of threads to step agents"
+                                   " with (default: 1).");
+    parser.addOption("chunk", 1, "The number of agents a worker thread takes"
+                                 " at once (default: 64).");
+    parser.addOption("affinity", 1, "How worker threads are pinned to"
+                                    " processors and NUMA nodes: none,"
+                                    " compact, or scatter (default: none).");
+    parser.addOption("order", 1, "How agents are renumbered for locality"
+                                 " after generation: none, bfs, or rcm"
+                                 " (default: none).");
+    parser.addOption("stream", 1, "Generate the social network on disk in"
+                                  " blocks of this many agents, and map it"
+                                  " into memory (default: in memory).");
+    parser.addOption("seed", 1, "The seed for every random stream (default:"
+                                " taken from the clock).");
+    parser.addOption("incremental", 1, "Keep statistics up to date from the"
+                                       " changes of each step, checking them"
+                                       " against a full count every this many"
+                                       " steps, or never if zero (default:"
+                                       " count every step).");
+    parser.addOption("sparse", 1, "Count only the combinations of behaviors"
+                                  " that somebody holds, writing one row per"
+                                  " combination and step for at most this"
+                                  " many of the most common, or all if zero"
+                                  " (default: one column per combination).");
+    parser.addOption("format", 1, "Write results as csv or binary column"
+                                  " files, which iris_convert turns back into"
+                                  " CSV (default: csv).");
+    parser.addOption("queue", 1, "Write statistics on a background thread,"
+                                 " letting this many steps wait to be"
+                                 " written, or on the simulation thread if"
+                                 " zero (default: 8).");
 
     return parser;
 }
@@ -0,0 +1,99 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include "iris/Affinity.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/Types.hpp"
+
+TEST_CASE("Verify that processor lists are parsed correctly.")
+{
+    using namespace iris;
+
+    CHECK(Topology::parseCpuList("0") == (Uint32List{0}));
+    CHECK(Topology::parseCpuList("0-3,8,10-11\n") ==
+          (Uint32List{0, 1, 2, 3, 8, 10, 11}));
+    CHECK(Topology::parseCpuList("").empty());
+
+    CHECK_THROWS(Topology::parseCpuList("3-1"));
+    CHECK_THROWS(Topology::parseCpuList("0-"));
+    CHECK_THROWS(Topology::parseCpuList("a"));
+
+    CHECK(Topology::parsePolicy("none") == AffinityPolicy::None);
+    CHECK(Topology::parsePolicy("compact") == AffinityPolicy::Compact);
+    CHECK(Topology::parsePolicy("scatter") == AffinityPolicy::Scatter);
+    CHECK_THROWS(Topology::parsePolicy("random"));
+}
+
+TEST_CASE("Verify that workers are laid out across NUMA nodes.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    // Two sockets, with an empty (memory-only) node in between.
+    const Topology topology(std::vector<Uint32List>{{0, 1, 2},
+                                                    {},
+                                                    {4, 5}});
+
+    REQUIRE(topology.getNodeCount() == 2);
+    CHECK(topology.getCpus(1) == (Uint32List{4, 5}));
+    CHECK_THROWS(Topology(std::vector<Uint32List>{{}}));
+
+    const auto cpusOf = [](const std::vector<Placement>& placements) {
+        Uint32List cpus;
+
+        for(const auto& placement : placements)
+        {
+            cpus.push_back(static_cast<uint32>(placement.m_cpu));
+        }
+
+        return cpus;
+    };
+
+    SECTION("Verify that no policy leaves every worker unpinned.")
+    {
+        for(const auto& placement : topology.place(3, AffinityPolicy::None))
+        {
+            CHECK(placement.m_cpu == -1);
+            CHECK(placement.m_node == -1);
+        }
+    }
+
+    SECTION("Verify that a compact layout fills one node first.")
+    {
+        const auto placements = topology.place(6, AffinityPolicy::Compact);
+
+        CHECK(cpusOf(placements) == (Uint32List{0, 1, 2, 4, 5, 0}));
+        CHECK(placements[2].m_node == 0);
+        CHECK(placements[3].m_node == 2);
+    }
+
+    SECTION("Verify that a scattered layout alternates between nodes.")
+    {
+        const auto placements = topology.place(5, AffinityPolicy::Scatter);
+
+        CHECK(cpusOf(placements) == (Uint32List{0, 4, 1, 5, 2}));
+        CHECK(placements[0].m_node == 0);
+        CHECK(placements[1].m_node == 2);
+    }
+}
+
+TEST_CASE("Verify that this machine's topology can be used.")
+{
+    using namespace iris;
+
+    const Topology topology;
+
+    REQUIRE(topology.getNodeCount() > 0);
+    CHECK_FALSE(topology.getCpus(0).empty());
+
+    // Moving memory is best effort, but it must never move what it was not
+    // given.
+    AgentStore agents(5000, ValueList{2}, BehaviorList{2});
+    const auto placement = topology.place(1, AffinityPolicy::Compact)[0];
+
+    CHECK(agents.moveToNode(0, 1, placement.m_node) == 0);
+    CHECK(agents.moveToNode(10, 5, placement.m_node) == 0);
+    CHECK(agents.moveToNode(0, 5000, -1) == 0);
+    CHECK_NOTHROW(agents.moveToNode(0, 5000, placement.m_node));
+}
@@ -0,0 +1,371 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/Types.hpp"
+
+TEST_CASE("Verify that an agent store allocates its columns correctly.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    AgentStore agents(10, ValueList{2, 3, 4}, BehaviorList{2, 3});
+
+    SECTION("Verify sizes and strides.")
+    {
+        CHECK(agents.isInitialized() == true);
+        CHECK(agents.size() == 10);
+        CHECK(agents.getValueCodec().size() == 3);
+        CHECK(agents.getBehaviorCodec().size() == 2);
+        CHECK(agents.getFamilySizes().size() == 10);
+        CHECK(agents.getPowerFlags().size() == 10);
+        CHECK(agents.getPrivileges().size() == 10);
+    }
+
+    SECTION("Verify that unique ids default to each agent's position.")
+    {
+        for(auto i = (AgentID)0; i < 10; i++)
+        {
+            CHECK(agents.getUIds()[i] == i);
+            CHECK(agents[i].getUId() == i);
+        }
+    }
+
+    SECTION("Verify that initializing twice throws.")
+    {
+        CHECK_THROWS(agents.initialize(5, ValueList{2}, BehaviorList{2}));
+    }
+
+    SECTION("Verify that clearing allows re-initialization.")
+    {
+        agents.clear();
+        CHECK(agents.isInitialized() == false);
+
+        agents.initialize(5, ValueList{2}, BehaviorList{2});
+        CHECK(agents.size() == 5);
+        CHECK(agents.getBehaviorCodec().size() == 1);
+    }
+}
+
+TEST_CASE("Verify that agent handles read and write the store's columns.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    AgentStore agents(3, ValueList{4, 4}, BehaviorList{4, 4});
+
+    SECTION("Verify scalar columns.")
+    {
+        agents[1].setFamilySize(3);
+        agents[1].setPowerful(true);
+        agents[1].increasePrivilege();
+        agents[1].increasePrivilege();
+
+        CHECK(agents.getFamilySizes()[1] == 3);
+        CHECK(agents.getPowerFlags()[1] == 1);
+        CHECK(agents.getPrivileges()[1] == 2);
+
+        // Neighbors are left untouched.
+        CHECK(agents.getFamilySizes()[0] == 0);
+        CHECK(agents.getPowerFlags()[2] == 0);
+        CHECK(agents.getPrivileges()[0] == 0);
+    }
+
+    SECTION("Verify that the powerful agents are indexed.")
+    {
+        agents[2].setPowerful(true);
+        agents[0].setPowerful(true);
+        agents[0].setPowerful(true);
+
+        CHECK(agents.getPowerfulAgents() == (IDList{0, 2}));
+
+        agents[0].setPowerful(false);
+
+        CHECK(agents.getPowerfulAgents() == (IDList{2}));
+
+        agents.setPowerfulAgents(IDList{0, 1});
+
+        CHECK(agents.getPowerfulAgents() == (IDList{0, 1}));
+        CHECK(agents.getPowerFlags() == (std::vector<uint8>{1, 1, 0}));
+        CHECK_THROWS(agents.setPowerfulAgents(IDList{1, 0}));
+        CHECK_THROWS(agents.setPowerfulAgents(IDList{3}));
+    }
+
+    SECTION("Verify row columns.")
+    {
+        agents[2].setInitialValues(ValueList{3, 1});
+        agents[2].setInitialBehavior(BehaviorList{2, 0});
+
+        const auto& values = agents.getValueCodec();
+        const auto& behavs = agents.getBehaviorCodec();
+
+        CHECK(values.get(agents.getValueWord(2), 0) == 3);
+        CHECK(values.get(agents.getValueWord(2), 1) == 1);
+        CHECK(behavs.get(agents.getBehaviorWord(2), 0) == 2);
+        CHECK(behavs.get(agents.getNextBehaviorWord(2), 0) == 2);
+
+        CHECK(agents[2].getValues() == (ValueList{3, 1}));
+        CHECK(agents[2].getBehavior() == (BehaviorList{2, 0}));
+        CHECK(agents[1].getBehavior() == (BehaviorList{0, 0}));
+    }
+
+    SECTION("Verify that swapping publishes the next behaviors.")
+    {
+        agents[0].setInitialBehavior(BehaviorList{1, 1});
+        agents[0].updateState(1, 3);
+
+        CHECK(agents[0].getBehavior() == (BehaviorList{1, 1}));
+        CHECK(agents.getBehaviorCodec().get(agents.getNextBehaviorWord(0), 1)
+              == 3);
+
+        agents.swapBehaviors();
+        CHECK(agents[0].getBehavior() == (BehaviorList{1, 3}));
+    }
+
+    SECTION("Verify that mismatched rows are rejected.")
+    {
+        CHECK_THROWS(agents[0].setInitialValues(ValueList{1}));
+        CHECK_THROWS(agents[0].setInitialBehavior(BehaviorList{1, 2, 3}));
+        CHECK_THROWS(agents[0].setInitialBehavior(BehaviorList{1, 4}));
+    }
+}
+
+TEST_CASE("Verify that freezing compacts networks into a single array.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    AgentStore agents(4, ValueList{}, BehaviorList{});
+
+    agents[0].addConnection(2);
+    agents[0].addConnection(1);
+    agents[2].addConnection(3);
+    agents[3].addConnection(0);
+    agents[3].addConnection(2);
+    agents[3].addConnection(1);
+
+    CHECK(agents.isFrozen() == false);
+    agents.freezeNetworks();
+
+    SECTION("Verify offsets and targets.")
+    {
+        const auto offsets = std::vector<uint64>{0, 2, 2, 3, 6};
+        const auto targets = std::vector<AgentID>{1, 2, 3, 0, 1, 2};
+
+        CHECK(agents.isFrozen() == true);
+        const auto resultOffsets = agents.getNetworkOffsets();
+        const auto resultTargets = agents.getNetworkTargets();
+
+        CHECK(std::vector<uint64>(resultOffsets.begin(),
+                                  resultOffsets.end()) == offsets);
+        CHECK(std::vector<AgentID>(resultTargets.begin(),
+                                   resultTargets.end()) == targets);
+        CHECK(agents.getNetworks().empty() == true);
+    }
+
+    SECTION("Verify that views cover each agent's network.")
+    {
+        CHECK(agents.getNetwork(0).size() == 2);
+        CHECK(agents.getNetwork(1).empty() == true);
+        CHECK(agents.getNetwork(2)[0] == 3);
+        CHECK(agents.getNetwork(3)[2] == 2);
+    }
+
+    SECTION("Verify that freezing twice throws.")
+    {
+        CHECK_THROWS(agents.freezeNetworks());
+    }
+}
+
+TEST_CASE("Verify that networks may be mapped from a network file.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    const std::string filename = "agent-store-test.bin";
+
+    auto offsets = std::vector<uint64>{0, 2, 2, 3, 6};
+    auto targets = std::vector<AgentID>{1, 2, 3, 0, 1, 2};
+
+    const auto write = [&filename, &offsets, &targets](uint64 agents) {
+        const auto header =
+            AgentStore::createNetworkHeader(agents, targets.size());
+
+        std::ofstream file(filename, std::ios::binary);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(offsets.data()),
+                   offsets.size() * sizeof(offsets[0]));
+        file.write(reinterpret_cast<const char*>(targets.data()),
+                   targets.size() * sizeof(targets[0]));
+    };
+
+    AgentStore agents(4, ValueList{}, BehaviorList{});
+
+    SECTION("Verify the mapped networks match the file.")
+    {
+        write(4);
+        agents.mapNetworks(filename);
+
+        const auto resultOffsets = agents.getNetworkOffsets();
+        const auto resultTargets = agents.getNetworkTargets();
+
+        CHECK(agents.isFrozen() == true);
+        CHECK(std::vector<uint64>(resultOffsets.begin(),
+                                  resultOffsets.end()) == offsets);
+        CHECK(std::vector<AgentID>(resultTargets.begin(),
+                                   resultTargets.end()) == targets);
+        CHECK(agents.getNetwork(3).size() == 3);
+        CHECK(agents.getEdgeInteractions().size() == 6);
+
+        SECTION("Verify that mapping or freezing again throws.")
+        {
+            CHECK_THROWS(agents.mapNetworks(filename));
+            CHECK_THROWS(agents.freezeNetworks());
+        }
+
+        SECTION("Verify that renumbering brings the networks into memory.")
+        {
+            agents.renumber(IDList{3, 2, 1, 0});
+
+            const auto renumbered = agents.getNetworkTargets();
+
+            CHECK(std::vector<AgentID>(renumbered.begin(),
+                                       renumbered.end()) == targets);
+            CHECK(agents.getNetworkOffsets()[1] == 3);
+        }
+    }
+
+    SECTION("Verify that a file for another population throws.")
+    {
+        write(5);
+        CHECK_THROWS(agents.mapNetworks(filename));
+        CHECK(agents.isFrozen() == false);
+    }
+
+    SECTION("Verify that a corrupted file throws.")
+    {
+        SECTION("Offsets that do not start at zero.")
+        {
+            offsets[0] = 1;
+        }
+
+        SECTION("Offsets that decrease.")
+        {
+            offsets[2] = 1;
+        }
+
+        SECTION("Offsets that do not end at the last edge.")
+        {
+            offsets[4] = 5;
+        }
+
+        SECTION("A target outside of the population.")
+        {
+            targets[3] = 4;
+        }
+
+        write(4);
+        CHECK_THROWS(agents.mapNetworks(filename));
+        CHECK(agents.isFrozen() == false);
+    }
+
+    SECTION("Verify that a truncated file throws.")
+    {
+        write(4);
+
+        std::vector<char> contents;
+
+        {
+            std::ifstream file(filename, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(file),
+                            std::istreambuf_iterator<char>());
+        }
+
+        std::ofstream(filename, std::ios::binary).write(
+            contents.data(), contents.size() - sizeof(AgentID));
+
+        CHECK_THROWS(agents.mapNetworks(filename));
+        CHECK(agents.isFrozen() == false);
+    }
+
+    SECTION("Verify that a missing or foreign file throws.")
+    {
+        std::ofstream(filename) << "not a network file";
+
+        CHECK_THROWS(agents.mapNetworks(filename));
+        CHECK_THROWS(agents.mapNetworks("no-such-network-file.bin"));
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("Verify that renumbering moves agents along with their networks.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    AgentStore agents(4, ValueList{}, BehaviorList{});
+
+    agents[0].addConnection(2);
+    agents[0].addConnection(1);
+    agents[2].addConnection(3);
+    agents[3].addConnection(0);
+    agents[3].addConnection(2);
+    agents[3].addConnection(1);
+
+    SECTION("Verify that renumbering requires frozen networks.")
+    {
+        CHECK_THROWS(agents.renumber(IDList{3, 2, 1, 0}));
+    }
+
+    agents.freezeNetworks();
+    agents[0].increasePrivilege();
+
+    // The edge from agent zero to agent one.
+    agents.getEdgeInteractions()[0].m_communicated = 7;
+
+    SECTION("Verify that an order must be a complete permutation.")
+    {
+        CHECK_THROWS(agents.renumber(IDList{0, 1, 2}));
+        CHECK_THROWS(agents.renumber(IDList{0, 1, 1, 3}));
+        CHECK_THROWS(agents.renumber(IDList{0, 1, 2, 4}));
+    }
+
+    SECTION("Verify that out-group contacts prevent renumbering.")
+    {
+        agents.getOutGroupInteractions(0).get(0, 3).m_communicated++;
+        CHECK_THROWS(agents.renumber(IDList{3, 2, 1, 0}));
+    }
+
+    SECTION("Verify that columns and networks follow their agents.")
+    {
+        agents[0].setPowerful(true);
+        agents[1].setPowerful(true);
+        agents.renumber(IDList{3, 2, 1, 0});
+
+        const auto uids    = std::vector<AgentID>{3, 2, 1, 0};
+        const auto offsets = std::vector<uint64>{0, 3, 4, 4, 6};
+        const auto targets = std::vector<AgentID>{1, 2, 3, 0, 1, 2};
+
+        CHECK(agents.getUIds() == uids);
+        const auto resultOffsets = agents.getNetworkOffsets();
+        const auto resultTargets = agents.getNetworkTargets();
+
+        CHECK(std::vector<uint64>(resultOffsets.begin(),
+                                  resultOffsets.end()) == offsets);
+        CHECK(std::vector<AgentID>(resultTargets.begin(),
+                                   resultTargets.end()) == targets);
+        CHECK(agents[3].getPrivilege() == 1);
+        CHECK(agents[0].getPrivilege() == 0);
+        CHECK(agents.getEdgeInteractions()[5].m_communicated == 7);
+        CHECK(agents.getEdgeInteractions()[4].m_communicated == 0);
+        CHECK(agents.getPowerfulAgents() == (IDList{2, 3}));
+    }
+}
@@ -1,13 +1,17 @@
 #include <catch.hpp>
 
 #include "iris/Agent.hpp"
+#include "iris/Arena.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/DeltaBuffer.hpp"
 #include "iris/Types.hpp"
 
 TEST_CASE("Verify initialization properties.")
 {
     SECTION("Verify default values.")
     {
-        iris::Agent agent;
+        iris::AgentStore store(1, iris::ValueList{}, iris::BehaviorList{});
+        iris::Agent      agent = store[0];
 
         CHECK(agent.getFamilySize() == 0);
         CHECK(agent.getPrivilege() == 0);
@@ -21,7 +25,8 @@ TEST_CASE("Verify network management methods work correctly.")
     using namespace iris;
     using namespace iris::types;
 
-    Agent agent;
+    AgentStore store(1, ValueList{}, BehaviorList{});
+    Agent      agent = store[0];
 
     // Sample attributes.
     agent.setFamilySize(2);
@@ -83,14 +88,29 @@ TEST_CASE("Verify network management methods work correctly.")
         const auto expected1 = Agent::Network{0, 3, 4, 5, 6};
         const auto expected2 = Agent::Network{0, 3, 4, 5, 6, 7};
         
+        const auto toNetwork = [&agent]() {
+            const auto view = agent.getNetwork();
+            return Agent::Network(view.begin(), view.end());
+        };
+        
         agent.addConnection(4);
-        CHECK(agent.getNetwork() == expected0);
+        CHECK(toNetwork() == expected0);
 
         agent.addConnection(0);
-        CHECK(agent.getNetwork() == expected1);
+        CHECK(toNetwork() == expected1);
 
         agent.addConnection(7);
-        CHECK(agent.getNetwork() == expected2);
+        CHECK(toNetwork() == expected2);
+    }
+
+    SECTION("Verify that a frozen network is read-only but unchanged.")
+    {
+        store.freezeNetworks();
+
+        CHECK(agent.getNetwork().size() == 3);
+        CHECK(agent.isConnectedTo(5) == true);
+        CHECK(agent.isConnectedTo(4) == false);
+        CHECK_THROWS(agent.addConnection(4));
     }
 }
 
@@ -99,7 +119,7 @@ TEST_CASE("Ensure removal of powerful agents works correctly.")
     using namespace iris;
     using namespace iris::types;
     
-    Agent*           agents = new Agent[20];
+    AgentStore       agents(20, ValueList{}, BehaviorList{});
 
     for(auto i = 0; i < 10; i++)
     {
@@ -110,45 +130,72 @@ TEST_CASE("Ensure removal of powerful agents works correctly.")
     agents[3].setPowerful(true);
     agents[7].setPowerful(true);
 
+    // Agent 0 knows agents 1 and 2, so asking for seven outsiders takes
+    // every one of them (3 through 9) before any are filtered.
+    agents[0].addConnection(1);
+    agents[0].addConnection(2);
+
+    ScratchArena     arena;
+    CounterRandom    random(7, 0, 0);
+
+    const auto influential = [&]() {
+        const auto group = agents[0].obtainRandomInfluentialGroup(
+            2, 7, agents, 10, random, arena);
+        auto       result = Agent::Network(group.begin(), group.end());
+
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
     SECTION("Simple case where powerful agents are present (to be preserved).")
     {
-        auto       network  = Agent::Network{2, 3, 4, 7, 9};
-        const auto expected = Agent::Network{3, 7};
+        const auto expected = Agent::Network{1, 2, 3, 7};
 
-        agents[0].removeNonPowerful(network, agents, 10);
-        CHECK(network == expected);
+        agents[0].setPowerful(true);
+        CHECK(influential() == expected);
     }
 
     SECTION("Correctly handles the case where there are no powerful agents"
             " to preserve.")
     {
-        auto       network  = Agent::Network{2, 4, 6, 9, 10};
-        const auto expected = Agent::Network{};
+        const auto expected = Agent::Network{1, 2};
 
-        agents[0].removeNonPowerful(network, agents, 10);
-        CHECK(network == expected);
+        agents[0].setPowerful(true);
+        agents[3].setPowerful(false);
+        agents[7].setPowerful(false);
+        CHECK(influential() == expected);
     }
 
     SECTION("Correctly handles the case where there are only powerful agents"
             " to preserve.")
     { 
-        auto       network  = Agent::Network{3, 7};
-        const auto expected = Agent::Network{3, 7};
+        const auto expected = Agent::Network{1, 2, 3, 4, 5, 6, 7, 8, 9};
 
-        agents[0].removeNonPowerful(network, agents, 10);
-        CHECK(network == expected);       
+        for(auto i = 0; i < 10; i++)
+        {
+            agents[i].setPowerful(true);
+        }
+
+        CHECK(influential() == expected);       
+    }
+
+    SECTION("Verify that nobody is removed for an agent that is not"
+            " powerful.")
+    {
+        const auto expected = Agent::Network{1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+        CHECK(influential() == expected);
     }
 
     SECTION("Correctly extracts the powerful agents.")
     {
         const auto network  = Agent::Network{1, 2, 3, 4};
         const auto expected = Agent::Network{3};
-
-        const auto result   = agents[0].extractPowerful(network, agents, 10);
-        CHECK(result == expected);
+        const auto result   = agents[0].extractPowerful(network, agents,
+                                                        arena);
+        CHECK(Agent::Network(result.begin(), result.end()) == expected);
     }
 
-    delete[] agents;
 }
 
 TEST_CASE("Verify that random selection of in-group works correctly.")
@@ -158,9 +205,9 @@ TEST_CASE("Verify that random selection of in-group works correctly.")
     using namespace std;
 
     random_device    seed;
-    mersenne_twister random(seed());
+    CounterRandom    random(seed(), 0, 0);
 
-    Agent*           agents = new Agent[20];
+    AgentStore       agents(20, ValueList{}, BehaviorList{});
 
     for(auto i = 0; i < 10; i++)
     {
@@ -176,7 +223,10 @@ TEST_CASE("Verify that random selection of in-group works correctly.")
     SECTION("Selection of in-group works as expected.")
     {
         const auto expected = Agent::Network{3, 4, 6, 8};
-        auto       result   = agents[0].obtainRandomInGroup(3, random);
+        Agent::Network result(4);
+
+        result.resize(agents[0].sampleInGroup(3, random, result.data()));
+
         auto       count    = 0;
         
         for(Agent::Network::size_type i = 0; i < result.size(); i++)
@@ -195,7 +245,9 @@ TEST_CASE("Verify that random selection of in-group works correctly.")
     SECTION("Selection of in-group works as expected when search at capacity.")
     {
         const auto expected = Agent::Network{3, 4, 6, 8};
-        auto       result   = agents[0].obtainRandomInGroup(4, random);
+        Agent::Network result(4);
+
+        result.resize(agents[0].sampleInGroup(4, random, result.data()));
 
         std::sort(result.begin(), result.end());
         CHECK(result == expected);
@@ -206,7 +258,9 @@ TEST_CASE("Verify that random selection of in-group works correctly.")
             " network.")
     { 
         const auto expected = Agent::Network{3, 4, 6, 8};
-        auto       result   = agents[0].obtainRandomInGroup(40, random);
+        Agent::Network result(4);
+
+        result.resize(agents[0].sampleInGroup(40, random, result.data()));
 
         std::sort(result.begin(), result.end());
         CHECK(result == expected);       
@@ -215,12 +269,52 @@ TEST_CASE("Verify that random selection of in-group works correctly.")
     SECTION("Selection of in-group returns nothing when qIn is zero.")
     {
         const auto expected = Agent::Network{};
-        auto       result   = agents[0].obtainRandomInGroup(0, random);
+        Agent::Network result(4);
+
+        result.resize(agents[0].sampleInGroup(0, random, result.data()));
 
         CHECK(result == expected);
     }
-    
-    delete[] agents;
+
+    SECTION("Verify that sampling fills a buffer with distinct members.")
+    {
+        AgentID sample[4] = {0, 0, 0, 99};
+
+        for(auto trial = 0; trial < 100; trial++)
+        {
+            REQUIRE(agents[0].sampleInGroup(3, random, sample) == 3);
+            CHECK(sample[3] == 99);
+
+            for(uint32 i = 0; i < 3; i++)
+            {
+                CHECK(agents[0].isConnectedTo(sample[i]));
+                CHECK(std::count(sample, sample + 3, sample[i]) == 1);
+            }
+        }
+
+        CHECK(agents[1].sampleInGroup(3, random, sample) == 0);
+    }
+
+    SECTION("Verify that every member is equally likely to be drawn.")
+    {
+        CounterRandom fixed(5, 0, 0);
+        AgentID       sample[2];
+        uint32        counts[10] = {0};
+
+        for(auto trial = 0; trial < 4000; trial++)
+        {
+            agents[0].sampleInGroup(2, fixed, sample);
+            counts[sample[0]]++;
+            counts[sample[1]]++;
+        }
+
+        // Each of the four members is expected 2000 times.
+        for(const auto member : {3, 4, 6, 8})
+        {
+            CHECK(counts[member] > 1800);
+            CHECK(counts[member] < 2200);
+        }
+    }
 }
 
 TEST_CASE("Verify that random selection of out-group works correctly.")
@@ -230,9 +324,9 @@ TEST_CASE("Verify that random selection of out-group works correctly.")
     using namespace std;
 
     random_device    seed;
-    mersenne_twister random(seed());
+    CounterRandom    random(seed(), 0, 0);
 
-    Agent*           agents = new Agent[20];
+    AgentStore       agents(20, ValueList{}, BehaviorList{});
 
     for(auto i = 0; i < 10; i++)
     {
@@ -252,7 +346,11 @@ TEST_CASE("Verify that random selection of out-group works correctly.")
         const auto expected = Agent::Network{
             1, 3, 4, 6, 7, 8, 10, 11, 12, 13, 15, 16, 17
         };
-        auto       result   = agents[0].obtainRandomOutGroup(5, 20, random);
+        Agent::Network result(20);
+
+        result.resize(agents[0].sampleOutGroup(5, 20, random,
+                                               result.data()));
+
         auto       count    = 0;
         
         for(Agent::Network::size_type i = 0; i < result.size(); i++)
@@ -273,7 +371,10 @@ TEST_CASE("Verify that random selection of out-group works correctly.")
         const auto expected = Agent::Network{
             1, 3, 4, 6, 7, 8, 10, 11, 12, 13, 15, 16, 17
         };
-        auto       result   = agents[0].obtainRandomOutGroup(13, 20, random);
+        Agent::Network result(20);
+
+        result.resize(agents[0].sampleOutGroup(13, 20, random,
+                                               result.data()));
 
         std::sort(result.begin(), result.end());
         CHECK(result == expected);
@@ -285,7 +386,10 @@ TEST_CASE("Verify that random selection of out-group works correctly.")
         const auto expected = Agent::Network{
             1, 3, 4, 6, 7, 8, 10, 11, 12, 13, 15, 16, 17
         };
-        auto       result   = agents[0].obtainRandomOutGroup(14, 20, random);
+        Agent::Network result(20);
+
+        result.resize(agents[0].sampleOutGroup(14, 20, random,
+                                               result.data()));
 
         std::sort(result.begin(), result.end());
         CHECK(result == expected);        
@@ -297,7 +401,10 @@ TEST_CASE("Verify that random selection of out-group works correctly.")
         const auto expected = Agent::Network{
             1, 3, 4, 6, 7, 8, 10, 11, 12, 13, 15, 16, 17
         };
-        auto       result   = agents[0].obtainRandomOutGroup(133, 20, random);
+        Agent::Network result(20);
+
+        result.resize(agents[0].sampleOutGroup(133, 20, random,
+                                               result.data()));
 
         std::sort(result.begin(), result.end());
         CHECK(result == expected);        
@@ -306,12 +413,89 @@ TEST_CASE("Verify that random selection of out-group works correctly.")
     SECTION("Out-group selection returns zero when qOut is also zero.")
     {
         const auto expected = Agent::Network{};
-        const auto result   = agents[0].obtainRandomOutGroup(0, 20, random);
+        Agent::Network result(20);
+
+        result.resize(agents[0].sampleOutGroup(0, 20, random,
+                                               result.data()));
 
         CHECK(result == expected);
     }
-    
-    delete[] agents;
+
+    SECTION("Verify that sampling fills a buffer with distinct outsiders.")
+    {
+        AgentID sample[8] = {0, 0, 0, 0, 0, 0, 0, 99};
+
+        for(auto trial = 0; trial < 100; trial++)
+        {
+            const auto drawn = agents[0].sampleOutGroup(7, 20, random,
+                                                        sample);
+
+            REQUIRE(drawn == 7);
+            CHECK(sample[7] == 99);
+
+            for(uint32 i = 0; i < drawn; i++)
+            {
+                CHECK(sample[i] != 0);
+                CHECK_FALSE(agents[0].isConnectedTo(sample[i]));
+                CHECK(std::count(sample, sample + drawn, sample[i]) == 1);
+            }
+        }
+    }
+
+    SECTION("Verify that sampling scarce outsiders stays uniform.")
+    {
+        // Only 13 of 20 agents are free, so every one is walked over, and
+        // each should be chosen about 7 times in 13.
+        AgentID sample[7];
+        uint32  chosen[20] = {};
+
+        for(auto trial = 0; trial < 2600; trial++)
+        {
+            const auto drawn = agents[0].sampleOutGroup(7, 20, random,
+                                                        sample);
+
+            REQUIRE(drawn == 7);
+
+            for(uint32 i = 0; i < drawn; i++)
+            {
+                chosen[sample[i]]++;
+            }
+        }
+
+        for(AgentID id = 0; id < 20; id++)
+        {
+            if(id == 0 || agents[0].isConnectedTo(id))
+            {
+                CHECK(chosen[id] == 0);
+            }
+            else
+            {
+                CHECK(chosen[id] > 1200);
+                CHECK(chosen[id] < 1600);
+            }
+        }
+    }
+
+    SECTION("Verify that sampling reports exhaustion by its result.")
+    {
+        AgentID sample[20];
+
+        CHECK(agents[0].sampleOutGroup(133, 20, random, sample) == 13);
+        CHECK(agents[0].sampleOutGroup(0, 20, random, sample) == 0);
+        CHECK(agents[0].sampleOutGroup(5, 1, random, sample) == 0);
+    }
+
+    SECTION("Verify that sampling depends only on the random stream.")
+    {
+        CounterRandom first(11, 3, 5);
+        CounterRandom second(11, 3, 5);
+        AgentID       sample0[6];
+        AgentID       sample1[6];
+
+        REQUIRE(agents[0].sampleOutGroup(6, 20, first, sample0) == 6);
+        REQUIRE(agents[0].sampleOutGroup(6, 20, second, sample1) == 6);
+        CHECK(std::equal(sample0, sample0 + 6, sample1));
+    }
 }
 
 TEST_CASE("Verify that side computations work correctly.")
@@ -323,7 +507,7 @@ TEST_CASE("Verify that side computations work correctly.")
     random_device    seed;
     mersenne_twister random(seed());
 
-    Agent*           agents = new Agent[20];
+    AgentStore       agents(20, ValueList{10}, BehaviorList{10});
 
     for(auto i = 0; i < 10; i++)
     {        
@@ -338,8 +522,7 @@ TEST_CASE("Verify that side computations work correctly.")
         const auto network  = Agent::Network{3};
         const auto expected = Agent::Sides{1, 0};
 
-        const auto result  = agents[0].computeSides(0, 0, network, agents,
-                                                    10, 0);
+        const auto result  = agents[0].computeSides(0, 0, network, agents);
         CHECK(result.first  == expected.first);
         CHECK(result.second == expected.second);
     }
@@ -350,8 +533,7 @@ TEST_CASE("Verify that side computations work correctly.")
         const auto network  = Agent::Network{3};
         const auto expected = Agent::Sides{0, 1};
 
-        const auto result  = agents[0].computeSides(0, 3, network, agents,
-                                                    10, 0);
+        const auto result  = agents[0].computeSides(0, 3, network, agents);
         CHECK(result.first  == expected.first);
         CHECK(result.second == expected.second);
     }
@@ -362,8 +544,7 @@ TEST_CASE("Verify that side computations work correctly.")
         const auto network  = Agent::Network{1, 2, 3};
         const auto expected = Agent::Sides{3, 0};
 
-        const auto result  = agents[0].computeSides(0, 6, network, agents,
-                                                    10, 0);
+        const auto result  = agents[0].computeSides(0, 6, network, agents);
         CHECK(result.first  == expected.first);
         CHECK(result.second == expected.second);
     }
@@ -376,13 +557,11 @@ TEST_CASE("Verify that side computations work correctly.")
 
         agents[1].setInitialBehavior(Uint32List{static_cast<uint32>(2)});
         
-        const auto result  = agents[0].computeSides(0, 2, network, agents,
-                                                    10, 0);
+        const auto result  = agents[0].computeSides(0, 2, network, agents);
         CHECK(result.first  == expected.first);
         CHECK(result.second == expected.second);
     }
     
-    delete[] agents;
 }
 
 TEST_CASE("Verify that updating an agent's state works correctly.")
@@ -390,26 +569,34 @@ TEST_CASE("Verify that updating an agent's state works correctly.")
     using namespace iris;
     using namespace iris::types;
 
-    Agent agent;
+    AgentStore store(1, ValueList{100}, BehaviorList{100});
+    Agent      agent = store[0];
 
     agent.setInitialBehavior(Uint32List{static_cast<uint32>(0)});
     
     SECTION("Updating across two different time steps works.")
     {
-        agent.updateState(0, 4, 0);
-        agent.updateState(0, 54, 1);
+        agent.updateState(0, 4);
+        CHECK(agent.getBehaviorAt(0) == 0);
+
+        store.swapBehaviors();
+        CHECK(agent.getBehaviorAt(0) == 4);
 
-        const auto expected0 = 4;
-        const auto expected1 = 54;
-        const auto expected2 = Uint32List{static_cast<uint32>(54)};
+        agent.updateState(0, 54);
+        store.swapBehaviors();
 
-        CHECK(agent.getBehaviorAt(0, 0) == expected0);
-        CHECK(agent.getBehaviorAt(0, 1) == expected1);
-        CHECK(agent.getBehavior() == expected2);
+        const auto expected = Uint32List{static_cast<uint32>(54)};
+
+        CHECK(agent.getBehaviorAt(0) == 54);
+        CHECK(agent.getBehavior() == expected);
     }
 
     SECTION("Test multi-variate update.")
     {
+        AgentStore multiStore(1, ValueList{100, 100, 100},
+                              BehaviorList{100, 100, 100});
+        Agent      agent = multiStore[0];
+
         const auto initialBehav = Uint32List{
             static_cast<uint32>(3),
             static_cast<uint32>(4),
@@ -417,34 +604,31 @@ TEST_CASE("Verify that updating an agent's state works correctly.")
         };
         agent.setInitialBehavior(initialBehav);
         
-        agent.updateState(0,  4, 0);
-        agent.updateState(2, 54, 1);
-        agent.updateState(1, 23, 2);
+        agent.updateState(0,  4);
+        multiStore.swapBehaviors();
+        agent.updateState(2, 54);
+        multiStore.swapBehaviors();
 
-        const auto expected00 = 4;
-        const auto expected01 = 4;
-        const auto expected02 = 54;
+        CHECK(agent.getBehaviorAt(0) == 4);
+        CHECK(agent.getBehaviorAt(1) == 4);
+        CHECK(agent.getBehaviorAt(2) == 54);
 
-        const auto expected10 = 4;
-        const auto expected11 = 23;
-        const auto expected12 = 54;
-        
-        const auto expected2 = Uint32List{
+        agent.updateState(1, 23);
+
+        // Nothing changes until the buffers are swapped.
+        CHECK(agent.getBehaviorAt(1) == 4);
+        multiStore.swapBehaviors();
+
+        const auto expected = Uint32List{
             static_cast<uint32>(4),
             static_cast<uint32>(23),
             static_cast<uint32>(54)
         };
 
-        CHECK(agent.getBehaviorAt(0, 1) == expected00);
-        CHECK(agent.getBehaviorAt(1, 1) == expected01);
-        CHECK(agent.getBehaviorAt(2, 1) == expected02);
-
-        CHECK(agent.getBehaviorAt(0, 2) == expected10);
-        CHECK(agent.getBehaviorAt(1, 2) == expected11);
-        CHECK(agent.getBehaviorAt(2, 2) == expected12);
-
-        CHECK(agent.getBehavior() == expected2);
-        CHECK_THROWS(agent.getBehaviorAt(0, 0));
+        CHECK(agent.getBehaviorAt(0) == 4);
+        CHECK(agent.getBehaviorAt(1) == 23);
+        CHECK(agent.getBehaviorAt(2) == 54);
+        CHECK(agent.getBehavior() == expected);
     }
 }
 
@@ -453,7 +637,8 @@ TEST_CASE("Verify that computing the outcome directly (via sides) is correct.")
     using namespace iris;
     using namespace iris::types;
 
-    Agent agent;
+    AgentStore store(1, ValueList{}, BehaviorList{});
+    Agent      agent = store[0];
 
     SECTION("Simple case.")
     {
@@ -499,7 +684,8 @@ TEST_CASE("Ensure utility function is roughly accurate.")
     using namespace iris;
     using namespace iris::types;
 
-    Agent agent;
+    AgentStore store(1, ValueList{}, BehaviorList{});
+    Agent      agent = store[0];
 
     SECTION("Use base lambda.")
     {
@@ -516,7 +702,9 @@ TEST_CASE("Ensure that the communication type is determined correctly based upon
           " the outcome of a social encounter.")
 {
     using namespace iris;
-    Agent agent;
+
+    AgentStore store(1, ValueList{}, BehaviorList{});
+    Agent      agent = store[0];
     
     SECTION("Verify the two possible communication outcomes that are"
             " not \"neither\".")
@@ -547,3 +735,44 @@ TEST_CASE("Ensure that the communication type is determined correctly based upon
         CHECK(result1 == expected);
     }
 }
+
+TEST_CASE("Verify that interactions are counted along edges and elsewhere.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    AgentStore agents(4, ValueList{}, BehaviorList{});
+
+    agents[0].addConnection(1);
+    agents[0].addConnection(2);
+    agents.freezeNetworks();
+
+    DeltaBuffer deltas;
+
+    deltas.addCommunication(0, 2);
+    deltas.addCommunication(0, 3);
+    deltas.addInfluence(0, 2, Agent::CommType::Censored);
+    deltas.addInfluence(1, 0, Agent::CommType::Reinforced);
+    deltas.merge(agents, 0, AgentStore::ShardCount);
+
+    SECTION("Verify that network members use edge counters.")
+    {
+        const auto& edges = agents.getEdgeInteractions();
+
+        CHECK(edges.size() == 2);
+        CHECK(edges[0].m_communicated == 0);
+        CHECK(edges[1].m_communicated == 2);
+        CHECK(edges[1].m_censored == 1);
+    }
+
+    SECTION("Verify that everybody else uses the out-group table.")
+    {
+        const auto& outGroup0 = agents.getOutGroupInteractions(0);
+        const auto& outGroup1 = agents.getOutGroupInteractions(1);
+
+        CHECK(outGroup0.size() == 1);
+        CHECK(outGroup0.find(0, 3)->m_communicated == 1);
+        CHECK(outGroup0.find(0, 2) == nullptr);
+        CHECK(outGroup1.find(1, 0)->m_reinforced == 1);
+    }
+}
@@ -0,0 +1,173 @@
+#include <catch.hpp>
+
+#include <cstdlib>
+#include <new>
+
+#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/Arena.hpp"
+#include "iris/DeltaBuffer.hpp"
+#include "iris/Parameters.hpp"
+#include "iris/Types.hpp"
+
+// Every heap allocation in the test program goes through here, so that a
+// test may count those made on its own thread.
+static thread_local bool        countingAllocations = false;
+static thread_local std::size_t allocationCount     = 0;
+
+void* operator new(std::size_t size)
+{
+    if(countingAllocations)
+    {
+        allocationCount++;
+    }
+
+    if(auto memory = std::malloc(size ? size : 1))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+TEST_CASE("Verify that scratch arenas hand out and reclaim memory.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    ScratchArena arena(256);
+
+    SECTION("Verify that allocations are aligned and do not overlap.")
+    {
+        auto bytes = arena.allocate<uint8>(3);
+        auto words = arena.allocate<uint64>(4);
+
+        CHECK(reinterpret_cast<std::size_t>(words.data()) % alignof(uint64)
+              == 0);
+        CHECK(static_cast<void*>(words.data()) >=
+              static_cast<void*>(bytes.data() + bytes.size()));
+        CHECK(words.size() == 4);
+        CHECK(arena.getUsed() == 8 + 4 * sizeof(uint64));
+    }
+
+    SECTION("Verify that resetting reuses the same memory.")
+    {
+        const auto first = arena.allocate<uint32>(10).data();
+
+        arena.reset();
+
+        CHECK(arena.getUsed() == 0);
+        CHECK(arena.allocate<uint32>(10).data() == first);
+    }
+
+    SECTION("Verify that an overflowing arena grows into a single block.")
+    {
+        auto small = arena.allocate<uint32>(16);
+        auto large = arena.allocate<uint32>(1000);
+
+        small[0] = 1;
+        large[999] = 2;
+
+        CHECK(arena.getCapacity() >= 256 + 4000);
+        CHECK(arena.getUsed() == 4 * 1016);
+
+        const auto capacity = arena.getCapacity();
+
+        arena.reset();
+
+        // The merged block fits the whole of the previous step.
+        countingAllocations = true;
+        allocationCount     = 0;
+
+        arena.allocate<uint32>(16);
+        arena.allocate<uint32>(1000);
+
+        countingAllocations = false;
+
+        CHECK(allocationCount == 0);
+        CHECK(arena.getCapacity() == capacity);
+    }
+
+    SECTION("Verify that copies share nothing but their capacity.")
+    {
+        ScratchArena copy(arena);
+
+        CHECK(copy.getCapacity() == arena.getCapacity());
+        CHECK(copy.allocate<uint8>(1).data() !=
+              arena.allocate<uint8>(1).data());
+    }
+}
+
+TEST_CASE("Verify that a warmed-up agent step never allocates.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    const AgentID      totalAgents = 200;
+    const BehaviorList behaviors   = {3, 2};
+
+    AgentStore   agents(totalAgents, ValueList{3}, behaviors);
+    DeltaBuffer  deltas;
+    ScratchArena arena;
+    Parameters   params;
+
+    params.m_lambda    = 0.12;
+    params.m_n         = totalAgents;
+    params.m_qIn       = 4;
+    params.m_qOut      = 6;
+    params.m_resist    = 0.5;
+    params.m_resistMax = 0.95;
+    params.m_resistMin = 0.05;
+    params.m_seed      = 99;
+
+    for(AgentID i = 0; i < totalAgents; i++)
+    {
+        agents[i].setInitialBehavior(Uint32List{i % 3, i % 2});
+        agents[i].setPowerful(i % 7 == 0);
+
+        for(AgentID j = 1; j <= 5; j++)
+        {
+            agents[i].addConnection((i + j) % totalAgents);
+        }
+    }
+
+    agents.freezeNetworks();
+
+    // Leave plenty of room for uneven shards: a step records at most three
+    // changes per member of a social group, plus a privilege.
+    deltas.reserve(4 * totalAgents * (3 * (params.m_qIn + params.m_qOut) + 1),
+                   totalAgents);
+
+    const auto stepAll = [&](uint64 time) {
+        deltas.clearTally();
+
+        for(AgentID i = 0; i < totalAgents; i++)
+        {
+            agents[i].step(params, agents, totalAgents, behaviors, time,
+                           deltas, arena);
+        }
+    };
+
+    // Let the arena and the delta buffer grow to their working sizes.
+    for(uint64 t = 1; t <= 5; t++)
+    {
+        stepAll(t);
+        deltas.merge(agents, 0, AgentStore::ShardCount);
+        agents.swapBehaviors();
+    }
+
+    countingAllocations = true;
+    allocationCount     = 0;
+
+    stepAll(6);
+
+    countingAllocations = false;
+
+    CHECK(allocationCount == 0);
+    CHECK_FALSE(deltas.empty());
+}
@@ -0,0 +1,65 @@
+#include <catch.hpp>
+
+#include <limits>
+
+#include "iris/AttributeCodec.hpp"
+#include "iris/Types.hpp"
+
+TEST_CASE("Verify that attribute codecs size their fields from ranges.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    SECTION("Verify field widths.")
+    {
+        CHECK(AttributeCodec(Uint32List{2, 2}).getWidth() == 2);
+        CHECK(AttributeCodec(Uint32List{3, 4, 5}).getWidth() == 7);
+        CHECK(AttributeCodec(Uint32List{1, 100}).getWidth() == 7);
+        CHECK(AttributeCodec(Uint32List{}).getWidth() == 0);
+    }
+
+    SECTION("Verify that oversized ranges are rejected.")
+    {
+        const auto bits = std::numeric_limits<attribute_word>::digits;
+        const auto list = Uint32List(bits / 16 + 1, 65536);
+
+        CHECK_THROWS(AttributeCodec(list));
+    }
+}
+
+TEST_CASE("Verify that attribute codecs round-trip every variable.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    const auto codec = AttributeCodec(Uint32List{2, 10, 3, 100});
+
+    SECTION("Verify encoding and decoding.")
+    {
+        const auto list = Uint32List{1, 9, 2, 57};
+        const auto word = codec.encode(list);
+
+        CHECK(codec.decode(word) == list);
+        CHECK(codec.get(word, 0) == 1);
+        CHECK(codec.get(word, 1) == 9);
+        CHECK(codec.get(word, 2) == 2);
+        CHECK(codec.get(word, 3) == 57);
+    }
+
+    SECTION("Verify that setting a variable leaves its neighbors alone.")
+    {
+        auto word = codec.encode(Uint32List{1, 9, 2, 57});
+
+        word = codec.set(word, 1, 0);
+        word = codec.set(word, 3, 99);
+
+        CHECK(codec.decode(word) == (Uint32List{1, 0, 2, 99}));
+    }
+
+    SECTION("Verify that malformed lists are rejected.")
+    {
+        CHECK_THROWS(codec.encode(Uint32List{1, 2, 3}));
+        CHECK_THROWS(codec.encode(Uint32List{2, 0, 0, 0}));
+        CHECK_THROWS(codec.encode(Uint32List{0, 0, 0, 100}));
+    }
+}
@@ -0,0 +1,82 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "iris/Barrier.hpp"
+#include "iris/Types.hpp"
+
+TEST_CASE("Verify that step barriers keep threads in lockstep.")
+{
+    using namespace iris;
+    using namespace iris::types;
+    using namespace std;
+
+    const auto numThreads = static_cast<uint32>(4);
+    const auto numRounds  = static_cast<uint32>(500);
+
+    // Every thread bumps a shared counter each round; after the barrier,
+    // each must see that everybody finished the round.
+    auto race = [=](StepBarrier& barrier) {
+        atomic<uint32> counter    = {0};
+        atomic<uint32> mismatches = {0};
+        vector<thread> threads;
+
+        for(uint32 i = 0; i < numThreads; i++)
+        {
+            threads.emplace_back([&]() {
+                for(uint32 round = 1; round <= numRounds; round++)
+                {
+                    counter += 1;
+                    barrier.wait();
+
+                    if(counter < round * numThreads)
+                    {
+                        mismatches += 1;
+                    }
+
+                    barrier.wait();
+                }
+            });
+        }
+
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        CHECK(counter == numThreads * numRounds);
+        CHECK(mismatches == 0);
+    };
+
+    SECTION("Verify a barrier that sleeps straight away.")
+    {
+        StepBarrier barrier(numThreads, 0);
+        race(barrier);
+    }
+
+    SECTION("Verify a barrier that spins first.")
+    {
+        StepBarrier barrier(numThreads, StepBarrier::DefaultSpins);
+        race(barrier);
+    }
+
+    SECTION("Verify that a single party never waits.")
+    {
+        StepBarrier barrier(1);
+
+        CHECK(barrier.wait() == 0);
+        CHECK(barrier.wait() == 0);
+    }
+
+    SECTION("Verify that a barrier needs at least one party.")
+    {
+        StepBarrier barrier(2);
+
+        CHECK(barrier.getParties() == 2);
+        CHECK_THROWS_AS(barrier.reset(0), std::runtime_error);
+        CHECK_THROWS_AS(StepBarrier(0), std::runtime_error);
+    }
+}
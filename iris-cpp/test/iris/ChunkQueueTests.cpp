@@ -0,0 +1,98 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "iris/ChunkQueue.hpp"
+#include "iris/Types.hpp"
+
+TEST_CASE("Verify that chunk queues hand out each chunk once.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    ChunkQueue queue;
+    uint32     chunk = 0;
+
+    SECTION("Verify that an empty queue hands out nothing.")
+    {
+        CHECK(queue.size() == 0);
+        CHECK_FALSE(queue.pop(chunk));
+        CHECK_FALSE(queue.steal(chunk));
+    }
+
+    SECTION("Verify that an ill-formed range causes an exception.")
+    {
+        CHECK_THROWS(queue.assign(5, 4));
+        CHECK_NOTHROW(queue.assign(4, 4));
+        CHECK(queue.size() == 0);
+    }
+
+    SECTION("Verify that the owner and thieves take opposite ends.")
+    {
+        queue.assign(3, 7);
+
+        CHECK(queue.size() == 4);
+        CHECK(queue.pop(chunk));
+        CHECK(chunk == 3);
+        CHECK(queue.steal(chunk));
+        CHECK(chunk == 6);
+        CHECK(queue.pop(chunk));
+        CHECK(chunk == 4);
+        CHECK(queue.steal(chunk));
+        CHECK(chunk == 5);
+        CHECK_FALSE(queue.pop(chunk));
+        CHECK_FALSE(queue.steal(chunk));
+
+        queue.refill();
+
+        CHECK(queue.size() == 4);
+        CHECK(queue.steal(chunk));
+        CHECK(chunk == 6);
+    }
+
+    SECTION("Verify that concurrent takers never share a chunk.")
+    {
+        const uint32 numChunks = 20000;
+        const uint32 numTakers = 4;
+
+        std::vector<std::atomic<uint32>> taken(numChunks);
+        std::vector<std::thread>         takers;
+
+        for(auto& count : taken)
+        {
+            count = 0;
+        }
+
+        queue.assign(0, numChunks);
+
+        for(uint32 i = 0; i < numTakers; i++)
+        {
+            takers.emplace_back([&queue, &taken, i]() {
+                uint32 mine = 0;
+
+                // The first taker acts as the owner; the rest steal.
+                while((i == 0) ? queue.pop(mine) : queue.steal(mine))
+                {
+                    taken[mine]++;
+                }
+            });
+        }
+
+        for(auto& taker : takers)
+        {
+            taker.join();
+        }
+
+        auto once = true;
+
+        for(const auto& count : taken)
+        {
+            once = once && (count == 1);
+        }
+
+        CHECK(once);
+        CHECK(queue.size() == 0);
+    }
+}
@@ -0,0 +1,75 @@
+#include <catch.hpp>
+
+#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/DeltaBuffer.hpp"
+#include "iris/Types.hpp"
+
+TEST_CASE("Verify that delta buffers defer changes until merged.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    AgentStore  agents(4, ValueList{}, BehaviorList{});
+    DeltaBuffer deltas;
+
+    agents[0].addConnection(1);
+    agents.freezeNetworks();
+
+    deltas.addCommunication(0, 1);
+    deltas.addCommunication(0, 3);
+    deltas.addInfluence(0, 1, Agent::CommType::Censored);
+    deltas.addInfluence(2, 0, Agent::CommType::Reinforced);
+    deltas.addPrivilege(2);
+    deltas.addPrivilege(2);
+
+    SECTION("Verify that nothing is applied while recording.")
+    {
+        CHECK(deltas.size() == 6);
+        CHECK(agents.getEdgeInteractions()[0].m_communicated == 0);
+        CHECK(agents[2].getPrivilege() == 0);
+        CHECK(agents.getOutGroupInteractions(0).size() == 0);
+    }
+
+    SECTION("Verify that merging a range only applies its shards.")
+    {
+        deltas.merge(agents, 2, 3);
+
+        CHECK(deltas.size() == 3);
+        CHECK(agents[2].getPrivilege() == 2);
+        CHECK(agents.getOutGroupInteractions(2).find(2, 0)->m_reinforced == 1);
+        CHECK(agents.getEdgeInteractions()[0].m_communicated == 0);
+    }
+
+    SECTION("Verify that the tally outlives a merge until cleared.")
+    {
+        deltas.addTransition(1, 2);
+        deltas.merge(agents, 0, AgentStore::ShardCount);
+
+        CHECK(deltas.empty());
+        CHECK(deltas.getPrivilegeTally() == 2);
+        REQUIRE(deltas.getTransitions().size() == 1);
+        CHECK(deltas.getTransitions()[0].m_from == 1);
+        CHECK(deltas.getTransitions()[0].m_to == 2);
+
+        deltas.clearTally();
+
+        CHECK(deltas.getPrivilegeTally() == 0);
+        CHECK(deltas.getTransitions().empty());
+    }
+
+    SECTION("Verify that merging everything applies every change.")
+    {
+        deltas.merge(agents, 0, AgentStore::ShardCount);
+
+        const auto& edge    = agents.getEdgeInteractions()[0];
+        const auto  outside = agents.getOutGroupInteractions(0).find(0, 3);
+
+        CHECK(deltas.empty());
+        CHECK(edge.m_communicated == 2);
+        CHECK(edge.m_censored == 1);
+        CHECK(edge.m_reinforced == 0);
+        CHECK(outside->m_communicated == 1);
+        CHECK(agents[2].getPrivilege() == 2);
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch.hpp>
+
+#include "iris/InteractionTable.hpp"
+#include "iris/Types.hpp"
+
+TEST_CASE("Verify that interaction tables find and create counters.")
+{
+    using namespace iris;
+
+    InteractionTable table;
+
+    SECTION("Verify that an empty table finds nothing.")
+    {
+        CHECK(table.size() == 0);
+        CHECK(table.find(0, 1) == nullptr);
+        CHECK(table.begin() == table.end());
+    }
+
+    SECTION("Verify that pairs are directed and counted separately.")
+    {
+        table.get(0, 1).m_communicated++;
+        table.get(0, 1).m_communicated++;
+        table.get(1, 0).m_censored++;
+
+        CHECK(table.size() == 2);
+        CHECK(table.find(0, 1)->m_communicated == 2);
+        CHECK(table.find(1, 0)->m_censored == 1);
+        CHECK(table.find(1, 0)->m_communicated == 0);
+        CHECK(table.find(2, 0) == nullptr);
+    }
+
+    SECTION("Verify that entries survive growth and iterate in order.")
+    {
+        for(AgentID i = 0; i < 1000; i++)
+        {
+            table.get(i % 37, i).m_reinforced = i;
+        }
+
+        CHECK(table.size() == 1000);
+
+        AgentID expected = 0;
+
+        for(const auto& entry : table)
+        {
+            CHECK(entry.m_from == expected % 37);
+            CHECK(entry.m_to == expected);
+            CHECK(table.find(entry.m_from, entry.m_to)->m_reinforced ==
+                  expected);
+            expected++;
+        }
+    }
+
+    SECTION("Verify that sorting orders entries by pair.")
+    {
+        table.get(5, 1).m_communicated = 1;
+        table.get(2, 9).m_communicated = 2;
+        table.get(2, 3).m_communicated = 3;
+        table.sort();
+
+        auto iter = table.begin();
+
+        CHECK((iter->m_from == 2 && iter->m_to == 3));
+        ++iter;
+        CHECK((iter->m_from == 2 && iter->m_to == 9));
+        ++iter;
+        CHECK((iter->m_from == 5 && iter->m_to == 1));
+
+        CHECK(table.find(2, 3)->m_communicated == 3);
+        CHECK(table.find(2, 9)->m_communicated == 2);
+        CHECK(table.find(5, 1)->m_communicated == 1);
+    }
+
+    SECTION("Verify that clearing removes every entry.")
+    {
+        table.get(3, 4);
+        table.clear();
+
+        CHECK(table.size() == 0);
+        CHECK(table.find(3, 4) == nullptr);
+    }
+}
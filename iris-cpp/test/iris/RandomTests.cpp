@@ -0,0 +1,95 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include "iris/Random.hpp"
+#include "iris/Types.hpp"
+
+TEST_CASE("Verify that the Philox bijection matches the reference vectors.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    SECTION("Verify the all-zero counter and key.")
+    {
+        uint32 counter[4] = {0, 0, 0, 0};
+        uint32 key[2]     = {0, 0};
+
+        CounterRandom::encrypt(counter, key);
+
+        CHECK(counter[0] == 0x6627e8d5);
+        CHECK(counter[1] == 0xe169c58d);
+        CHECK(counter[2] == 0xbc57ac4c);
+        CHECK(counter[3] == 0x9b00dbd8);
+    }
+
+    SECTION("Verify the all-ones counter and key.")
+    {
+        uint32 counter[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+        uint32 key[2]     = {0xffffffff, 0xffffffff};
+
+        CounterRandom::encrypt(counter, key);
+
+        CHECK(counter[0] == 0x408f276d);
+        CHECK(counter[1] == 0x41c83b0e);
+        CHECK(counter[2] == 0xa20bc7c6);
+        CHECK(counter[3] == 0x6d5451fd);
+    }
+
+    SECTION("Verify the digits of pi.")
+    {
+        uint32 counter[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+        uint32 key[2]     = {0xa4093822, 0x299f31d0};
+
+        CounterRandom::encrypt(counter, key);
+
+        CHECK(counter[0] == 0xd16cfe09);
+        CHECK(counter[1] == 0x94fdcceb);
+        CHECK(counter[2] == 0x5001e420);
+        CHECK(counter[3] == 0x24126ea1);
+    }
+}
+
+TEST_CASE("Verify that random streams are reproducible and independent.")
+{
+    using namespace iris;
+    using namespace iris::types;
+
+    auto draw = [](uint64 seed, uint64 stream, uint64 step) {
+        CounterRandom       random(seed, stream, step);
+        std::vector<uint32> result;
+
+        for(auto i = 0; i < 10; i++)
+        {
+            result.push_back(random());
+        }
+
+        return result;
+    };
+
+    SECTION("Verify that the same key yields the same stream.")
+    {
+        CHECK(draw(42, 7, 3) == draw(42, 7, 3));
+    }
+
+    SECTION("Verify that every part of the key changes the stream.")
+    {
+        const auto base = draw(42, 7, 3);
+
+        CHECK(draw(43, 7, 3) != base);
+        CHECK(draw(42, 8, 3) != base);
+        CHECK(draw(42, 7, 4) != base);
+        CHECK(draw(42, 7ULL << 32, 3) != draw(42, 0, 3));
+        CHECK(draw(1ULL << 32, 7, 3) != draw(0, 7, 3));
+    }
+
+    SECTION("Verify that the first block is the encrypted counter.")
+    {
+        CounterRandom random(0, 0, 0);
+
+        CHECK(random.getDrawCount() == 0);
+        CHECK(random() == 0x6627e8d5);
+        CHECK(random() == 0xe169c58d);
+        CHECK(random.getDrawCount() == 2);
+    }
+}
@@ -3,9 +3,13 @@
 #include <algorithm>
 #include <atomic>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 #include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/Arena.hpp"
+#include "iris/DeltaBuffer.hpp"
 #include "iris/Parameters.hpp"
 #include "iris/Types.hpp"
 #include "iris/Threading.hpp"
@@ -40,13 +44,18 @@ TEST_CASE("Verify spread algorithm works correctly.")
         using namespace std;
 
         const auto           behavior   = Uint32List{};
-        std::atomic<uint32>  completion = {0};
+        StepBarrier          step(2);
+        StepBarrier          merge(1);
         auto                 params     = Parameters();
         std::atomic<uint64>  time       = {0};
-        auto                 worker     = ThreadWorker(completion, time);
+        auto                 worker     = ThreadWorker(step, merge, time);
+        auto                 deltas     = std::vector<DeltaBuffer>(1);
+        auto                 queues     = std::vector<ChunkQueue>(1);
 
-        CHECK_THROWS(worker.initialize(NULL, 3, 2, params, behavior));
-        CHECK_THROWS(worker.initialize(NULL, 4, 4, params, behavior));
+        CHECK_THROWS(worker.initialize(NULL, 0, 4, params, behavior));
+        CHECK_THROWS(worker.initialize(NULL, 4, 0, params, behavior));
+        CHECK_THROWS(worker.share(&deltas, &queues, 1));
+        CHECK_THROWS(worker.start(1));
     }
     
     SECTION("Test that range is calculated correctly.")
@@ -142,11 +151,12 @@ TEST_CASE("Verify that ThreadWorkers store and access external values"
     using namespace iris::types;
     using namespace std;
 
-    atomic<uint32> complete;
+    StepBarrier    step(2);
+    StepBarrier    merge(1);
     atomic<uint64> time     = {1};
     
-    Agent*       agents = new Agent[3]; 
-    ThreadWorker worker(complete, time);
+    AgentStore   agents(3, ValueList{2, 3, 2}, BehaviorList{2, 3, 2});
+    ThreadWorker worker(step, merge, time);
 
     BehaviorList behavList  = {2, 3, 2};
     Parameters   params;
@@ -167,14 +177,15 @@ TEST_CASE("Verify that ThreadWorkers store and access external values"
     
     SECTION("Ensure behaviors and parameters are copied correctly.")
     {
-        worker.initialize(agents, static_cast<AgentID>(0),
-                          static_cast<AgentID>(3),params,
+        worker.initialize(&agents, static_cast<AgentID>(3),
+                          static_cast<AgentID>(2), params,
                           behavList);
 
         const auto resultBehav  = worker.getBehaviorList();
         const auto resultParams = worker.getParameters();
 
         CHECK(resultBehav == behavList);
+        CHECK(worker.getChunkSize() == 2);
         
         CHECK(resultParams.m_lambda == params.m_lambda);
         CHECK(resultParams.m_n == params.m_n);
@@ -189,6 +200,177 @@ TEST_CASE("Verify that ThreadWorkers store and access external values"
         CHECK(resultParams.m_prob == Approx(params.m_prob));
         CHECK(resultParams.m_recip == Approx(params.m_recip));
     }
+}
+
+TEST_CASE("Verify that a worker pool steps every agent exactly once.")
+{
+    using namespace iris;
+    using namespace iris::types;
+    using namespace std;
+
+    const auto totalAgents = static_cast<AgentID>(100);
+    const auto totalSteps  = static_cast<uint64>(5);
+
+    AgentStore       agents(totalAgents, ValueList{2}, BehaviorList{2});
+    ThreadController controller;
+    atomic<uint64>   time = {0};
+    Parameters       params;
+
+    params.m_lambda    = 0.12;
+    params.m_n         = totalAgents;
+    params.m_qIn       = 2;
+    params.m_qOut      = 3;
+    params.m_resist    = 0.5;
+    params.m_resistMax = 0.95;
+    params.m_resistMin = 0.05;
+    params.m_seed      = 7;
+
+    agents.freezeNetworks();
+
+    controller.initialize(&agents, totalAgents, params, BehaviorList{2}, 4,
+                          8, AffinityPolicy::None, time);
+    controller.start();
+
+    for(uint64 t = 1; t <= totalSteps; t++)
+    {
+        time = t;
+        controller.signalAll();
+        controller.waitForCompletion();
+        agents.swapBehaviors();
+    }
+
+    controller.stopAll();
+    controller.tearDown();
+
+    SECTION("Verify that no contact was lost.")
+    {
+        // With empty networks, every agent contacts exactly qOut others per
+        // step, and both sides of each contact are counted.
+        uint64 communicated = 0;
+
+        for(const auto& table : agents.getOutGroupShards())
+        {
+            for(const auto& entry : table)
+            {
+                communicated += entry.m_counts.m_communicated;
+            }
+        }
+
+        CHECK(communicated == 2 * totalAgents * params.m_qOut * totalSteps);
+    }
+}
+
+TEST_CASE("Verify that a seeded run does not depend on the number of"
+          " threads.")
+{
+    using namespace iris;
+    using namespace iris::types;
+    using namespace std;
+
+    typedef tuple<AgentID, AgentID, uint64> Contact;
+
+    const auto totalAgents = static_cast<AgentID>(60);
+    const auto totalSteps  = static_cast<uint64>(4);
+
+    Parameters params;
+
+    params.m_lambda    = 0.12;
+    params.m_n         = totalAgents;
+    params.m_qIn       = 2;
+    params.m_qOut      = 3;
+    params.m_resist    = 0.5;
+    params.m_resistMax = 0.95;
+    params.m_resistMin = 0.05;
+    params.m_seed      = 12345;
+
+    // Runs a small ring of agents with the given number of workers (zero
+    // meaning on this thread) and records everything the writers would see.
+    auto simulate = [&](uint32 numThreads, vector<attribute_word>& behaviors,
+                        vector<unumeric>& privilege,
+                        vector<Contact>& contacts) {
+        AgentStore       agents(totalAgents, ValueList{3}, BehaviorList{3});
+        ScratchArena     arena;
+        DeltaBuffer      deltas;
+        ThreadController controller;
+        atomic<uint64>   time = {0};
+
+        for(AgentID i = 0; i < totalAgents; i++)
+        {
+            agents[i].setInitialBehavior(Uint32List{i % 3});
+            agents[i].setPowerful(i % 10 == 0);
+            agents[i].addConnection((i + 1) % totalAgents);
+            agents[i].addConnection((i + totalAgents - 1) % totalAgents);
+        }
+
+        agents.freezeNetworks();
+
+        if(numThreads > 0)
+        {
+            // A small chunk size leaves plenty of work to steal, and
+            // pinning must not change the results either.
+            controller.initialize(&agents, totalAgents, params,
+                                  BehaviorList{3}, numThreads, 7,
+                                  AffinityPolicy::Scatter, time);
+            controller.start();
+        }
+
+        for(uint64 t = 1; t <= totalSteps; t++)
+        {
+            time = t;
+
+            if(numThreads > 0)
+            {
+                controller.signalAll();
+                controller.waitForCompletion();
+            }
+            else
+            {
+                for(AgentID i = 0; i < totalAgents; i++)
+                {
+                    agents[i].step(params, agents, totalAgents,
+                                   BehaviorList{3}, t, deltas, arena);
+                }
+
+                deltas.merge(agents, 0, AgentStore::ShardCount);
+            }
+
+            agents.swapBehaviors();
+        }
+
+        controller.stopAll();
+        controller.tearDown();
+
+        agents.sortOutGroupInteractions();
+
+        for(AgentID i = 0; i < totalAgents; i++)
+        {
+            behaviors.push_back(agents.getBehaviorWord(i));
+            privilege.push_back(agents[i].getPrivilege());
+        }
+
+        for(const auto& table : agents.getOutGroupShards())
+        {
+            for(const auto& entry : table)
+            {
+                contacts.emplace_back(entry.m_from, entry.m_to,
+                                      entry.m_counts.m_communicated);
+            }
+        }
+
+        for(const auto& edge : agents.getEdgeInteractions())
+        {
+            contacts.emplace_back(0, 0, edge.m_communicated);
+        }
+    };
+
+    vector<attribute_word> serialBehaviors, pooledBehaviors;
+    vector<unumeric>       serialPrivilege, pooledPrivilege;
+    vector<Contact>        serialContacts,  pooledContacts;
+
+    simulate(0, serialBehaviors, serialPrivilege, serialContacts);
+    simulate(4, pooledBehaviors, pooledPrivilege, pooledContacts);
 
-    delete[] agents;
+    CHECK(serialBehaviors == pooledBehaviors);
+    CHECK(serialPrivilege == pooledPrivilege);
+    CHECK(serialContacts  == pooledContacts);
 }
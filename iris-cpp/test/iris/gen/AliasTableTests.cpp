@@ -0,0 +1,61 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include "iris/Types.hpp"
+
+#include "iris/gen/AliasTable.hpp"
+
+TEST_CASE("Verify alias tables reproduce their distribution.")
+{
+    using namespace iris::gen;
+    using namespace iris::types;
+
+    SECTION("Verify evenly spread draws land in proportion to the weights.")
+    {
+        const auto   weights = std::vector<fnumeric>{0.1, 0.4, 0.0, 0.2, 0.3};
+        const uint32 draws   = 100000;
+
+        AliasTable          table(weights);
+        std::vector<uint32> counts(weights.size(), 0);
+
+        for(uint32 i = 0; i < draws; i++)
+        {
+            counts[table.choose((i + 0.5) / draws)]++;
+        }
+
+        for(std::size_t i = 0; i < weights.size(); i++)
+        {
+            CHECK(counts[i] / (fnumeric)draws ==
+                  Approx(weights[i]).margin(0.001));
+        }
+
+        CHECK(table.size() == 5);
+        CHECK(table.getMean() == Approx(2.2));
+    }
+
+    SECTION("Verify weights need not sum to one.")
+    {
+        AliasTable table(std::vector<fnumeric>{2.0, 2.0});
+
+        CHECK(table.choose(0.1) == 0);
+        CHECK(table.choose(0.9) == 1);
+        CHECK(table.choose(1.0) == 1);
+    }
+
+    SECTION("Verify a single outcome is always chosen.")
+    {
+        AliasTable table(std::vector<fnumeric>{0.5});
+
+        CHECK(table.choose(0.0) == 0);
+        CHECK(table.choose(0.7) == 0);
+    }
+
+    SECTION("Verify invalid weights throw.")
+    {
+        CHECK_THROWS(AliasTable(std::vector<fnumeric>{}));
+        CHECK_THROWS(AliasTable(std::vector<fnumeric>{0.0, 0.0}));
+        CHECK_THROWS(AliasTable(std::vector<fnumeric>{0.5, -0.1}));
+        CHECK_THROWS(AliasTable().choose(0.5));
+    }
+}
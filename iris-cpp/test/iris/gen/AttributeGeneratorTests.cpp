@@ -1,13 +1,15 @@
 #include <catch.hpp>
 
+#include <algorithm>
 #include <random>
 
 #include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
 #include "iris/Types.hpp"
 
 #include "iris/gen/AttributeGenerator.hpp"
 
-iris::types::uint32 getPowerfulAgentCount(iris::Agent* agents,
+iris::types::uint32 getPowerfulAgentCount(iris::AgentStore& agents,
                                           iris::AgentID totalAgents)
 {
     using namespace iris;
@@ -83,7 +85,7 @@ TEST_CASE("Verify that population dispensers are being created correctly.")
         using namespace std;
 
         random_device    seed;
-        mersenne_twister random(seed());
+        CounterRandom    random(seed(), 0, 0);
         
         const auto variables = Uint32List{2};
         auto       popDist   = Uint32List(2);
@@ -101,6 +103,60 @@ TEST_CASE("Verify that population dispensers are being created correctly.")
     }
 }
 
+TEST_CASE("Verify that population dispensers dispense in bulk correctly.")
+{
+    using namespace iris;
+    using namespace iris::gen;
+    using namespace iris::types;
+
+    // Enough for several chunks, with a partial one at the end.
+    const AgentID totalAgents = 3 * PopulationDispenser::ShuffleChunk + 124;
+    const auto    variables   = Uint32List{3};
+
+    auto serial   = createPopulationDispensers(variables, totalAgents);
+    auto parallel = createPopulationDispensers(variables, totalAgents);
+
+    Uint32List groups;
+    Uint32List threaded;
+
+    serial[0].dispenseAll(groups, 42, 0, 1);
+    parallel[0].dispenseAll(threaded, 42, 0, 3);
+
+    SECTION("Check that every quota is dispensed exactly.")
+    {
+        Uint32List counts(3, 0);
+
+        for(const auto group : groups)
+        {
+            counts[group]++;
+        }
+
+        CHECK(groups.size() == totalAgents);
+        CHECK(counts[0] == 65578);
+        CHECK(counts[1] == 65577);
+        CHECK(counts[2] == 65577);
+        CHECK_FALSE(serial[0].hasMore());
+    }
+
+    SECTION("Check that the order is shuffled, and throughout.")
+    {
+        CHECK_FALSE(std::is_sorted(groups.begin(), groups.end()));
+        CHECK_FALSE(std::is_sorted(groups.end() - 1000, groups.end()));
+    }
+
+    SECTION("Check that the order does not depend on the thread count.")
+    {
+        CHECK(groups == threaded);
+    }
+
+    SECTION("Check that an empty dispenser dispenses nothing.")
+    {
+        serial[0].dispenseAll(groups, 42, 0, 2);
+
+        CHECK(groups.empty());
+    }
+}
+
 TEST_CASE("Verify that attribute lists are being created correctly.")
 {
     SECTION("Simple test case.")
@@ -111,7 +167,7 @@ TEST_CASE("Verify that attribute lists are being created correctly.")
         using namespace std;
 
         random_device    seed;
-        mersenne_twister random(seed());
+        CounterRandom    random(seed(), 0, 0);
         
         const auto variables = Uint32List{2};
         auto       popDisp   = createPopulationDispensers(variables, 2);
@@ -198,9 +254,9 @@ TEST_CASE("Verify that powerful agents are created correctly.")
     using namespace std;
 
     random_device    seed;
-    mersenne_twister random(seed());
+    const uint64     randomSeed = seed();
 
-    auto             agents = new Agent[20];
+    AgentStore       agents(20, ValueList{}, BehaviorList{});
 
     for(auto i = 0; i < 20; i++)
     {
@@ -210,7 +266,8 @@ TEST_CASE("Verify that powerful agents are created correctly.")
     
     SECTION("Correctly handle a power percentage of zero.")
     {
-        generatePowerfulAgents(agents, (AgentID)20, (fnumeric)0, true, random);
+        generatePowerfulAgents(agents, (AgentID)20, (fnumeric)0, true,
+                               randomSeed);
         
         const auto count = getPowerfulAgentCount(agents, (AgentID)20);
         CHECK(count == 0);
@@ -218,7 +275,7 @@ TEST_CASE("Verify that powerful agents are created correctly.")
 
     SECTION("Correctly handle a power percentage of ten.")
     {
-        generatePowerfulAgents(agents, (AgentID)20, 0.10, true, random);
+        generatePowerfulAgents(agents, (AgentID)20, 0.10, true, randomSeed);
         
         const auto count = getPowerfulAgentCount(agents, (AgentID)20);
         CHECK(count == 2);
@@ -226,7 +283,7 @@ TEST_CASE("Verify that powerful agents are created correctly.")
 
     SECTION("Correctly handle floor calculation.")
     {
-        generatePowerfulAgents(agents, (AgentID)20, 0.16, true, random);
+        generatePowerfulAgents(agents, (AgentID)20, 0.16, true, randomSeed);
 
         const auto count = getPowerfulAgentCount(agents, (AgentID)20);
         CHECK(count == 3);
@@ -234,7 +291,7 @@ TEST_CASE("Verify that powerful agents are created correctly.")
 
     SECTION("Correctly handle requiring at least one.")
     {
-        generatePowerfulAgents(agents, (AgentID)20, 0.01, true, random);
+        generatePowerfulAgents(agents, (AgentID)20, 0.01, true, randomSeed);
 
         const auto count = getPowerfulAgentCount(agents, (AgentID)20);
         CHECK(count == 1);
@@ -242,13 +299,36 @@ TEST_CASE("Verify that powerful agents are created correctly.")
 
     SECTION("Correctly handle not requiring at least one.")
     {
-        generatePowerfulAgents(agents, (AgentID)20, 0.01, false, random);
+        generatePowerfulAgents(agents, (AgentID)20, 0.01, false, randomSeed);
 
         const auto count = getPowerfulAgentCount(agents, (AgentID)20);
         CHECK(count == 0);
     }
 
-    delete[] agents;
+    SECTION("Check that the powerful agents are indexed in order.")
+    {
+        generatePowerfulAgents(agents, (AgentID)20, 0.5, true, randomSeed);
+
+        const auto& index = agents.getPowerfulAgents();
+
+        CHECK(index.size() == 10);
+        CHECK(getPowerfulAgentCount(agents, (AgentID)20) == 10);
+        CHECK(std::is_sorted(index.begin(), index.end()));
+
+        for(const auto i : index)
+        {
+            CHECK(agents[i].isPowerful());
+        }
+    }
+
+    SECTION("Correctly handle choosing every agent.")
+    {
+        generatePowerfulAgents(agents, (AgentID)20, 1.0, true, randomSeed);
+
+        CHECK(getPowerfulAgentCount(agents, (AgentID)20) == 20);
+        CHECK_THROWS(generatePowerfulAgents(agents, (AgentID)20, 1.5, true,
+                                            randomSeed));
+    }
 }
 
 TEST_CASE("Ensure that attribute list permutation works correctly.")
@@ -295,9 +375,9 @@ TEST_CASE("Verify that attribution generation works correctly.")
     using namespace std;
 
     random_device    seed;
-    mersenne_twister random(seed());
+    const uint64     randomSeed = seed();
 
-    auto agents = new Agent[2];
+    AgentStore agents(2, ValueList{2}, BehaviorList{2});
 
     SECTION("Check that behaviors are assigned as correct sub-lists when"
             " values and behavior sizes are equal.")
@@ -305,7 +385,7 @@ TEST_CASE("Verify that attribution generation works correctly.")
         const auto values    = Uint32List{2};
         const auto behaviors = Uint32List{2};
 
-        generateAttributes(agents, 2, values, behaviors, random);
+        generateAttributes(agents, 2, values, behaviors, randomSeed, 1);
 
         const auto behav0 = agents[0].getBehavior();
         const auto behav1 = agents[1].getBehavior();
@@ -323,6 +403,39 @@ TEST_CASE("Verify that attribution generation works correctly.")
             CHECK(behav1[0] == 0);
         }
     }
-    
-    delete[] agents;
+
+    SECTION("Check that the whole population is assigned independently of"
+            " the thread count.")
+    {
+        const AgentID n = 10000;
+
+        AgentStore serial(n, ValueList{3, 4}, BehaviorList{3});
+        AgentStore parallel(n, ValueList{3, 4}, BehaviorList{3});
+        Uint32List counts(3 * 4, 0);
+        bool       matches = true;
+
+        generateAttributes(serial, n, {3, 4}, {3}, randomSeed, 1);
+        generateAttributes(parallel, n, {3, 4}, {3}, randomSeed, 4);
+
+        for(AgentID i = 0; i < n; i++)
+        {
+            const auto value    = serial[i].getValues();
+            const auto behavior = serial[i].getBehavior();
+
+            counts[value[0] * 4 + value[1]]++;
+            matches = matches && (behavior[0] == value[0]) &&
+                (value == parallel[i].getValues()) &&
+                (behavior == parallel[i].getBehavior());
+        }
+
+        CHECK(matches);
+
+        // Each variable alone is dispensed exactly...
+        CHECK(counts[0] + counts[1] + counts[2] + counts[3] == 3334);
+        CHECK(counts[8] + counts[9] + counts[10] + counts[11] == 3333);
+        CHECK(counts[0] + counts[4] + counts[8] == 2500);
+
+        // ...but independently of the others.
+        CHECK(*std::min_element(counts.begin(), counts.end()) > 700);
+    }
 }
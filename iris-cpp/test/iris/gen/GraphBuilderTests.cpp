@@ -0,0 +1,261 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "iris/AgentStore.hpp"
+#include "iris/Types.hpp"
+
+#include "iris/gen/GraphBuilder.hpp"
+#include "iris/gen/GraphGenerator.hpp"
+
+#include "iris/io/reader/CensusReader.hpp"
+
+template <typename T>
+bool equals(const iris::Span<T>& a, const iris::Span<T>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+TEST_CASE("Verify the parallel graph builder produces valid networks.")
+{
+    using namespace iris;
+    using namespace iris::gen;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    const AgentID    n      = 3000;
+    const uint32     out    = 10;
+    const CensusData census = CensusData{0.3, 0.3, 0.2, 0.1, 0.1};
+
+    AgentStore   built(n, ValueList{}, BehaviorList{});
+    AgentStore   wired(n, ValueList{}, BehaviorList{});
+    GraphBuilder builder(n, census, out, 0.5, 0.5, 7);
+
+    builder.build(built, 3);
+    wireGraph(wired, n, census, out, 0.5, 0.5, 7);
+    wired.freezeNetworks();
+
+    REQUIRE(built.isFrozen());
+
+    SECTION("Verify families are drawn exactly as by wireGraph.")
+    {
+        CHECK(built.getFamilySizes() == wired.getFamilySizes());
+    }
+
+    SECTION("Verify every network is sorted, unique, loop-free, and capped.")
+    {
+        for(AgentID i = 0; i < n; i++)
+        {
+            const auto network = built.getNetwork(i);
+            const auto family  = built.getFamilySizes()[i] - 1;
+
+            CHECK(std::adjacent_find(network.begin(), network.end(),
+                                     [](AgentID a, AgentID b) {
+                                         return a >= b;
+                                     }) == network.end());
+            CHECK(!std::binary_search(network.begin(), network.end(), i));
+            CHECK(network.size() <= out + family);
+        }
+    }
+
+    SECTION("Verify the networks are exactly those of wireGraph.")
+    {
+        CHECK(equals(built.getNetworkOffsets(), wired.getNetworkOffsets()));
+        CHECK(equals(built.getNetworkTargets(), wired.getNetworkTargets()));
+    }
+
+    SECTION("Verify the result does not depend on the number of threads.")
+    {
+        for(const uint32 threads : {1u, 2u, 8u})
+        {
+            AgentStore other(n, ValueList{}, BehaviorList{});
+
+            builder.build(other, threads);
+
+            CHECK(equals(other.getNetworkOffsets(), built.getNetworkOffsets()));
+            CHECK(equals(other.getNetworkTargets(), built.getNetworkTargets()));
+        }
+    }
+}
+
+TEST_CASE("Verify family units are laid out from their own streams.")
+{
+    using namespace iris;
+    using namespace iris::gen;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    const AgentID    n      = 100000;
+    const CensusData census = CensusData{0.3, 0.3, 0.2, 0.1, 0.1};
+    const AliasTable table(census);
+
+    std::vector<uint32> familySizes(n, 0);
+
+    const auto units =
+        GraphBuilder::layoutFamilies(table, n, 17, 3, familySizes);
+
+    SECTION("Verify the units tile the population in order.")
+    {
+        REQUIRE(!units.empty());
+        CHECK(units.front().first == 0);
+        CHECK(units.back().second == n);
+
+        bool tiled = true;
+
+        for(std::size_t k = 0; k < units.size(); k++)
+        {
+            const auto size   = familySizes[units[k].first];
+            const auto length = units[k].second - units[k].first;
+
+            tiled = tiled && length > 0 && length <= size &&
+                familySizes[units[k].second - 1] == size;
+
+            if(k + 1 < units.size())
+            {
+                tiled = tiled && units[k].second == units[k + 1].first &&
+                    length == size;
+            }
+        }
+
+        CHECK(tiled);
+    }
+
+    SECTION("Verify family sizes follow the census.")
+    {
+        std::vector<uint32> counts(census.size(), 0);
+
+        for(const auto& unit : units)
+        {
+            counts[familySizes[unit.first] - 1]++;
+        }
+
+        for(std::size_t i = 0; i < census.size(); i++)
+        {
+            CHECK(counts[i] / (fnumeric)units.size() ==
+                  Approx(census[i]).margin(0.01));
+        }
+    }
+
+    SECTION("Verify the layout does not depend on the number of threads.")
+    {
+        std::vector<uint32> serialSizes(n, 0);
+
+        const auto serial =
+            GraphBuilder::layoutFamilies(table, n, 17, 1, serialSizes);
+
+        CHECK(serial == units);
+        CHECK(serialSizes == familySizes);
+    }
+}
+
+TEST_CASE("Verify streaming a graph to disk matches building it in memory.")
+{
+    using namespace iris;
+    using namespace iris::gen;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    const AgentID     n        = 2000;
+    const CensusData  census   = CensusData{0.3, 0.3, 0.2, 0.1, 0.1};
+    const std::string filename = "graph-builder-test.bin";
+
+    AgentStore   built(n, ValueList{}, BehaviorList{});
+    GraphBuilder builder(n, census, 10, 0.6, 0.7, 5);
+
+    builder.build(built, 2);
+
+    for(const AgentID blockSize : {1u, 97u, 5000u})
+    {
+        AgentStore streamed(n, ValueList{}, BehaviorList{});
+
+        builder.stream(streamed, filename, blockSize, 3);
+
+        CHECK(streamed.isFrozen());
+        CHECK(streamed.getFamilySizes() == built.getFamilySizes());
+        CHECK(equals(streamed.getNetworkOffsets(),
+                     built.getNetworkOffsets()));
+        CHECK(equals(streamed.getNetworkTargets(),
+                     built.getNetworkTargets()));
+        CHECK(streamed.getEdgeInteractions().size() ==
+              built.getEdgeInteractions().size());
+
+        // Every run is cleaned up once merged.
+        CHECK(!std::ifstream(filename + ".run0"));
+    }
+
+    std::remove(filename.c_str());
+
+    SECTION("Verify a block size of zero throws.")
+    {
+        AgentStore streamed(n, ValueList{}, BehaviorList{});
+        CHECK_THROWS(builder.stream(streamed, filename, 0, 1));
+    }
+}
+
+TEST_CASE("Verify the parallel graph builder handles the edge cases.")
+{
+    using namespace iris;
+    using namespace iris::gen;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    SECTION("Verify a certain connection to everyone makes a full graph.")
+    {
+        AgentStore   agents(20, ValueList{}, BehaviorList{});
+        GraphBuilder builder(20, CensusData{1.0}, 1000000, 1.0, 1.0, 3);
+
+        builder.build(agents, 4);
+
+        for(AgentID i = 0; i < 20; i++)
+        {
+            CHECK(agents.getNetwork(i).size() == 19);
+        }
+    }
+
+    SECTION("Verify no out-group connections leaves only families.")
+    {
+        AgentStore   agents(50, ValueList{}, BehaviorList{});
+        GraphBuilder builder(50, CensusData{0.5, 0.5}, 0, 1.0, 1.0, 3);
+
+        builder.build(agents, 2);
+
+        for(AgentID i = 0; i < 50; i++)
+        {
+            CHECK(agents.getNetwork(i).size() <=
+                  agents.getFamilySizes()[i] - 1);
+        }
+    }
+
+    SECTION("Verify caps match wireGraph under heavy reciprocity.")
+    {
+        const CensusData census = CensusData{0.4, 0.3, 0.3};
+
+        for(const AgentID n : {15u, 400u})
+        {
+            AgentStore   built(n, ValueList{}, BehaviorList{});
+            AgentStore   wired(n, ValueList{}, BehaviorList{});
+            GraphBuilder builder(n, census, 20, 0.9, 1.0, 11);
+
+            builder.build(built, 4);
+            wireGraph(wired, n, census, 20, 0.9, 1.0, 11);
+            wired.freezeNetworks();
+
+            CHECK(equals(built.getNetworkOffsets(), wired.getNetworkOffsets()));
+            CHECK(equals(built.getNetworkTargets(), wired.getNetworkTargets()));
+        }
+    }
+
+    SECTION("Verify bad stores and thread counts throw.")
+    {
+        AgentStore   agents(10, ValueList{}, BehaviorList{});
+        GraphBuilder builder(20, CensusData{1.0}, 5, 0.5, 0.5, 3);
+        GraphBuilder fitting(10, CensusData{1.0}, 5, 0.5, 0.5, 3);
+
+        CHECK_THROWS(builder.build(agents, 1));
+        CHECK_THROWS(fitting.build(agents, 0));
+    }
+}
@@ -5,28 +5,30 @@
 #include <vector>
 
 #include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
 #include "iris/Types.hpp"
 
 #include "iris/gen/GraphGenerator.hpp"
 
 #include "iris/io/reader/CensusReader.hpp"
 
-void testForDuplicates(const iris::Agent::Network& network)
+void testForDuplicates(const iris::Agent::NetworkView& network)
 {
     if(network.size() == 0)
     {
         return;
     }
     
-    for(iris::Agent::Network::size_type i = 0; i < network.size() - 1; i++)
+    for(iris::Agent::NetworkView::size_type i = 0; i < network.size() - 1; i++)
     {
         CHECK(network[i] != network[i + 1]);
     }
 }
 
-void testForLoops(const iris::AgentID& id, const iris::Agent::Network& network)
+void testForLoops(const iris::AgentID& id,
+                  const iris::Agent::NetworkView& network)
 {
-    for(iris::Agent::Network::size_type i = 0; i < network.size(); i++)
+    for(iris::Agent::NetworkView::size_type i = 0; i < network.size(); i++)
     {
         CHECK(network[i] != id);
     }
@@ -97,14 +99,16 @@ TEST_CASE("Wire a family unit together.")
         using namespace iris;
         using namespace iris::gen;
 
-        Agent      agent;
+        AgentStore store(1, ValueList{}, BehaviorList{});
+        Agent      agent      = store[0];
         const auto familyUnit = FamilyUnit{0, 4};
 
         agent.setUId(0);
         wireFamilyUnit(agent, familyUnit);
 
         const auto expected = Agent::Network{1, 2, 3};
-        const auto result   = agent.getNetwork();
+        const auto view     = agent.getNetwork();
+        const auto result   = Agent::Network(view.begin(), view.end());
         
         CHECK(expected == result);
     }
@@ -114,7 +118,7 @@ TEST_CASE("Wire a family unit together.")
         using namespace iris;
         using namespace iris::gen;
 
-        Agent        agents[5];
+        AgentStore   agents(5, ValueList{}, BehaviorList{});
         const auto   familyUnit = FamilyUnit{0, 5};
 
         // Set up the agent family, first.
@@ -135,7 +139,7 @@ TEST_CASE("Wire a family unit together.")
             expected.erase(std::find(expected.begin(), expected.end(), j));
 
             const auto result = agents[j].getNetwork();
-            CHECK(expected == result);
+            CHECK(expected == Agent::Network(result.begin(), result.end()));
 
             SECTION("Verify there are no duplicates.")
             {
@@ -168,9 +172,9 @@ TEST_CASE("Verify out-group connection creation is correct and unique.")
     using namespace std;
 
     random_device    seed;
-    mersenne_twister random(seed());
+    CounterRandom    random(seed(), 0, 0);
 
-    Agent*           agents = new Agent[20];
+    AgentStore       agents(20, ValueList{}, BehaviorList{});
 
     for(auto i = 0; i < 20; i++)
     {
@@ -248,6 +252,4 @@ TEST_CASE("Verify out-group connection creation is correct and unique.")
             }
         }
     }
-
-    delete[] agents;
 }
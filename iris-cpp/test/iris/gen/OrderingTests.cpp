@@ -0,0 +1,117 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "iris/AgentStore.hpp"
+#include "iris/Types.hpp"
+
+#include "iris/gen/Ordering.hpp"
+
+TEST_CASE("Verify that orderings are parsed correctly.")
+{
+    using namespace iris::gen;
+
+    CHECK(parseOrdering("none") == Ordering::None);
+    CHECK(parseOrdering("bfs") == Ordering::BreadthFirst);
+    CHECK(parseOrdering("rcm") == Ordering::ReverseCuthillMcKee);
+    CHECK_THROWS(parseOrdering("random"));
+}
+
+TEST_CASE("Verify that traversal orders follow the network.")
+{
+    using namespace iris;
+    using namespace iris::gen;
+
+    // A path of six agents, whose positions have been scrambled:
+    //    4 - 0 - 5 - 2 - 3 - 1
+    const IDList path = {4, 0, 5, 2, 3, 1};
+
+    AgentStore agents(6, ValueList{}, BehaviorList{});
+
+    for(std::size_t i = 0; i + 1 < path.size(); i++)
+    {
+        agents[path[i]].addConnection(path[i + 1]);
+        agents[path[i + 1]].addConnection(path[i]);
+    }
+
+    agents.freezeNetworks();
+
+    SECTION("Verify that no ordering keeps every position.")
+    {
+        CHECK(computeOrder(agents, Ordering::None) ==
+              (IDList{0, 1, 2, 3, 4, 5}));
+    }
+
+    SECTION("Verify the breadth-first order.")
+    {
+        // Starting from position zero, both of its neighbours come next.
+        CHECK(orderBreadthFirst(agents) == (IDList{0, 4, 5, 2, 3, 1}));
+    }
+
+    SECTION("Verify the reverse Cuthill-McKee order.")
+    {
+        // Starting from the lowest-degree end (position one) and reversing
+        // recovers the path itself.
+        CHECK(orderReverseCuthillMcKee(agents) == path);
+    }
+}
+
+TEST_CASE("Verify that renumbering narrows the span of every network.")
+{
+    using namespace iris;
+    using namespace iris::gen;
+
+    const AgentID totalAgents = 210;
+
+    // A ring, plus a few isolated agents, scattered across the store by a
+    // multiplicative permutation.
+    AgentStore agents(totalAgents, ValueList{}, BehaviorList{});
+
+    const auto scatter = [totalAgents](AgentID i) {
+        return static_cast<AgentID>((i * 97) % totalAgents);
+    };
+
+    for(AgentID i = 0; i < 200; i++)
+    {
+        agents[scatter(i)].addConnection(scatter((i + 1) % 200));
+        agents[scatter((i + 1) % 200)].addConnection(scatter(i));
+    }
+
+    agents.freezeNetworks();
+
+    const auto bandwidth = [&agents, totalAgents]() {
+        AgentID widest = 0;
+
+        for(AgentID i = 0; i < totalAgents; i++)
+        {
+            for(const auto other : agents.getNetwork(i))
+            {
+                widest = std::max(widest, (other > i) ? other - i : i - other);
+            }
+        }
+
+        return widest;
+    };
+
+    const auto before = bandwidth();
+
+    for(const auto ordering : {Ordering::BreadthFirst,
+                               Ordering::ReverseCuthillMcKee})
+    {
+        auto sorted = computeOrder(agents, ordering);
+
+        std::sort(sorted.begin(), sorted.end());
+
+        IDList identity(totalAgents);
+        std::iota(identity.begin(), identity.end(), 0);
+
+        CHECK(sorted == identity);
+    }
+
+    agents.renumber(orderReverseCuthillMcKee(agents));
+
+    CHECK(before > 100);
+    CHECK(bandwidth() <= 2);
+}
@@ -0,0 +1,254 @@
+#include <catch.hpp>
+
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/Types.hpp"
+
+#include "iris/io/Columnar.hpp"
+#include "iris/io/reader/ColumnReader.hpp"
+#include "iris/io/writer/AttributeWriter.hpp"
+#include "iris/io/writer/BarrierWriter.hpp"
+#include "iris/io/writer/ColumnWriter.hpp"
+#include "iris/io/writer/NetworkWriter.hpp"
+#include "iris/io/writer/StatisticsWriter.hpp"
+
+TEST_CASE("Ensure that column files convert back to the CSV they replace.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    AgentStore agents(3, ValueList{100, 1000}, BehaviorList{100, 1000});
+
+    for(auto i = 0; i < 3; i++)
+    {
+        const auto value = static_cast<uint32>(i * 7);
+
+        agents[i].setFamilySize(i + 1);
+        agents[i].setUId(i * 10);
+        agents[i].setInitialValues(Uint32List{value, value * 11});
+        agents[i].setInitialBehavior(Uint32List{value % 3, value});
+    }
+
+    agents[0].addConnection(1);
+    agents[0].addConnection(2);
+    agents[1].addConnection(0);
+    agents[2].addConnection(0);
+    agents[1].increasePrivilege();
+    agents[2].setPowerful(true);
+
+    // Writes a column file through the specified function, then converts it
+    // back to CSV.
+    const auto convert = [](const ColumnList& columns,
+                            const std::function<void(ColumnWriter&)>& output) {
+        std::ostringstream stream;
+        ColumnWriter       writer(stream, columns, Metadata{{"run", "1"}});
+
+        output(writer);
+        writer.flush();
+
+        // A string stream need not be aligned, so copy it into words first.
+        const auto          contents = stream.str();
+        std::vector<uint64> words((contents.size() + 7) / 8, 0);
+
+        std::memcpy(words.data(), contents.data(), contents.size());
+
+        ColumnReader       reader(reinterpret_cast<const uint8*>(
+                                      words.data()), contents.size());
+        std::ostringstream csv;
+
+        outputCsv(csv, reader);
+        return csv.str();
+    };
+
+    SECTION("Verify that attributes convert back.")
+    {
+        std::ostringstream expected;
+
+        outputAttributes(expected, agents, 3);
+        CHECK(convert(getAttributeColumns(), [&](ColumnWriter& out) {
+                    outputAttributes(out, agents, 3);
+                }) == expected.str());
+    }
+
+    SECTION("Verify that the network converts back.")
+    {
+        std::ostringstream expected;
+
+        outputNetwork(expected, agents, 3);
+        CHECK(convert(getNetworkColumns(), [&](ColumnWriter& out) {
+                    outputNetwork(out, agents, 3);
+                }) == expected.str());
+    }
+
+    SECTION("Verify that barrier waits convert back.")
+    {
+        std::ostringstream expected;
+
+        writeBarrierHeader(expected, 2);
+        writeBarrierWaits(expected, 1, std::vector<uint64>{10, 0});
+        writeBarrierWaits(expected, 2, std::vector<uint64>{3, 2500});
+
+        CHECK(convert(getBarrierColumns(2), [](ColumnWriter& out) {
+                    writeBarrierWaits(out, 1, std::vector<uint64>{10, 0});
+                    writeBarrierWaits(out, 2, std::vector<uint64>{3, 2500});
+                }) == expected.str());
+    }
+
+    SECTION("Verify that a dense and a sparse census convert back.")
+    {
+        // The census must be given the ranges of the agents' behaviors.
+        AgentStore census(3, ValueList{3, 15}, BehaviorList{3, 15});
+
+        census[0].setInitialBehavior(Uint32List{2, 7});
+        census[1].setInitialBehavior(Uint32List{0, 14});
+        census[2].setInitialBehavior(Uint32List{2, 7});
+        census[1].increasePrivilege();
+
+        for(auto sparse : {false, true})
+        {
+            StatisticsWriter   statWriter;
+            std::ostringstream expected;
+
+            if(sparse)
+            {
+                statWriter.initializeSparse(Uint32List{3, 15}, 1, 0);
+            }
+            else
+            {
+                statWriter.initialize(Uint32List{3, 15}, 1);
+            }
+
+            statWriter.writeHeader(expected);
+            statWriter.writeStatistics(expected, census, 3, 0);
+            statWriter.writeStatistics(expected, census, 3, 1);
+
+            CHECK(convert(statWriter.getColumns(), [&](ColumnWriter& out) {
+                        for(uint64 time = 0; time < 2; time++)
+                        {
+                            statWriter.count(census, 3);
+                            statWriter.write(out, time);
+                        }
+                    }) == expected.str());
+        }
+    }
+}
+
+TEST_CASE("Ensure that contents which are not a column file are refused.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    std::ostringstream stream;
+    ColumnWriter       writer(stream, ColumnList{
+                                  ColumnSpec{"Time", ColumnType::UInt64}},
+                              Metadata());
+
+    writer.putUnsigned(1).endRow();
+    writer.flush();
+
+    const auto          contents = stream.str();
+    std::vector<uint64> words((contents.size() + 7) / 8 + 1, 0);
+
+    std::memcpy(words.data(), contents.data(), contents.size());
+
+    const auto data = reinterpret_cast<uint8*>(words.data());
+
+    SECTION("Verify that the intact contents are accepted.")
+    {
+        ColumnReader reader(data, contents.size());
+        CHECK(reader.getRows() == 1);
+    }
+
+    SECTION("Verify that truncated contents are refused.")
+    {
+        CHECK_THROWS_AS(ColumnReader(data, contents.size() - 1),
+                        std::runtime_error);
+        CHECK_THROWS_AS(ColumnReader(data, 4), std::runtime_error);
+    }
+
+    SECTION("Verify that a different magic number is refused.")
+    {
+        data[0] = 'X';
+        CHECK_THROWS_AS(ColumnReader(data, contents.size()),
+                        std::runtime_error);
+    }
+
+    SECTION("Verify that trailing bytes are refused.")
+    {
+        CHECK_THROWS_AS(ColumnReader(data, contents.size() + 8),
+                        std::runtime_error);
+    }
+}
+
+TEST_CASE("Ensure that text whose offsets are out of place is refused.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    std::ostringstream stream;
+    ColumnWriter       writer(stream, ColumnList{
+                                  ColumnSpec{"Name", ColumnType::Text}},
+                              Metadata());
+
+    writer.putText("ab").endRow();
+    writer.putText("cde").endRow();
+    writer.flush();
+
+    const auto          contents = stream.str();
+    std::vector<uint64> words((contents.size() + 7) / 8, 0);
+
+    std::memcpy(words.data(), contents.data(), contents.size());
+
+    const auto data = reinterpret_cast<uint8*>(words.data());
+
+    // The only block holds two offsets and five characters (padded to
+    // eight), after its header of rows and bytes.
+    auto* ends   = &words[words.size() - 3];
+    auto* header = ends - 2;
+
+    REQUIRE(header[0] == 2);
+    REQUIRE(header[1] == 24);
+    REQUIRE(ends[0] == 2);
+    REQUIRE(ends[1] == 5);
+
+    SECTION("Verify that the intact text is read, and only within its rows.")
+    {
+        ColumnReader reader(data, contents.size());
+
+        CHECK(reader.getText(0, 0, 0) == "ab");
+        CHECK(reader.getText(0, 0, 1) == "cde");
+        CHECK_THROWS_AS(reader.getText(0, 0, 2), std::out_of_range);
+    }
+
+    SECTION("Verify that a truncated text block is refused.")
+    {
+        header[1] = 16;
+        CHECK_THROWS_AS(ColumnReader(data, contents.size() - 8),
+                        std::runtime_error);
+    }
+
+    SECTION("Verify that text running past its block is refused.")
+    {
+        ends[1] = ~static_cast<uint64>(0) - 4;
+        CHECK_THROWS_AS(ColumnReader(data, contents.size()),
+                        std::runtime_error);
+    }
+
+    SECTION("Verify that offsets out of order are refused.")
+    {
+        ends[0] = 4;
+        ends[1] = 3;
+        CHECK_THROWS_AS(ColumnReader(data, contents.size()),
+                        std::runtime_error);
+    }
+}
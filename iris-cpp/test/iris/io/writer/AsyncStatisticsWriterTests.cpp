@@ -0,0 +1,166 @@
+#include <catch.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/Types.hpp"
+
+#include "iris/io/Columnar.hpp"
+#include "iris/io/reader/ColumnReader.hpp"
+#include "iris/io/writer/AsyncStatisticsWriter.hpp"
+#include "iris/io/writer/ColumnWriter.hpp"
+#include "iris/io/writer/StatisticsWriter.hpp"
+
+TEST_CASE("Verify that statistics written in the background match those"
+          " written in place.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    AgentStore agents(5, ValueList{3, 2}, BehaviorList{3, 2});
+
+    agents[0].setInitialBehavior(Uint32List{2, 1});
+    agents[1].setInitialBehavior(Uint32List{0, 1});
+    agents[2].setInitialBehavior(Uint32List{2, 1});
+    agents[3].setInitialBehavior(Uint32List{1, 0});
+    agents[4].setInitialBehavior(Uint32List{2, 1});
+
+    // Changes the census a little every step, so that every row differs.
+    const auto change = [&agents](uint64 time) {
+        agents[time % 5].setInitialBehavior(
+            Uint32List{static_cast<uint32>(time % 3),
+                       static_cast<uint32>(time % 2)});
+        agents[time % 5].increasePrivilege();
+    };
+
+    for(auto sparse : {false, true})
+    {
+        for(uint32 capacity : {1u, 2u, 8u})
+        {
+            StatisticsWriter expectedWriter;
+            StatisticsWriter statWriter;
+
+            if(sparse)
+            {
+                expectedWriter.initializeSparse(Uint32List{3, 2}, 1, 2);
+                statWriter.initializeSparse(Uint32List{3, 2}, 1, 2);
+            }
+            else
+            {
+                expectedWriter.initialize(Uint32List{3, 2}, 1);
+                statWriter.initialize(Uint32List{3, 2}, 1);
+            }
+
+            std::ostringstream expected;
+            std::ostringstream stream;
+
+            {
+                AsyncStatisticsWriter async(statWriter, stream, capacity);
+
+                for(uint64 time = 0; time < 200; time++)
+                {
+                    change(time);
+
+                    expectedWriter.writeStatistics(expected, agents, 5, time);
+                    statWriter.count(agents, 5);
+                    async.push(time);
+                }
+
+                async.close();
+
+                const auto metrics = async.getMetrics();
+
+                CHECK(metrics.m_pushes == 200);
+                CHECK(metrics.m_peakDepth >= 1);
+                CHECK(metrics.m_peakDepth <= capacity);
+                CHECK(metrics.m_blocks == 1);
+                CHECK_THROWS_AS(async.push(200), std::runtime_error);
+            }
+
+            CHECK(stream.str() == expected.str());
+        }
+    }
+}
+
+TEST_CASE("Verify that statistics may be written to a column file in the"
+          " background.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    AgentStore       agents(3, ValueList{2}, BehaviorList{2});
+    StatisticsWriter statWriter;
+
+    agents[0].setInitialBehavior(Uint32List{1});
+    agents[1].setInitialBehavior(Uint32List{0});
+    agents[2].setInitialBehavior(Uint32List{1});
+
+    statWriter.initialize(Uint32List{2}, 1);
+
+    std::ostringstream stream;
+    ColumnWriter       columns(stream, statWriter.getColumns(), Metadata());
+
+    {
+        AsyncStatisticsWriter async(statWriter, columns, 2);
+
+        for(uint64 time = 0; time < 10; time++)
+        {
+            statWriter.count(agents, 3);
+            async.push(time);
+        }
+
+        // Everything handed over is written even without closing.
+    }
+
+    // A string stream need not be aligned, so copy it into words first.
+    const auto          contents = stream.str();
+    std::vector<uint64> words((contents.size() + 7) / 8, 0);
+
+    std::memcpy(words.data(), contents.data(), contents.size());
+
+    ColumnReader reader(reinterpret_cast<const uint8*>(words.data()),
+                        contents.size());
+
+    REQUIRE(reader.getRows() == 10);
+    CHECK(reader.getValues<uint64>(0, 0)[9] == 9);
+    CHECK(reader.getValues<uint64>(0, 2)[9] == 1);
+    CHECK(reader.getValues<uint64>(0, 3)[9] == 2);
+}
+
+TEST_CASE("Verify that a statistics queue needs room for a step.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    StatisticsWriter   statWriter;
+    std::ostringstream stream;
+
+    statWriter.initialize(Uint32List{2}, 1);
+
+    CHECK_THROWS_AS(AsyncStatisticsWriter(statWriter, stream, 0),
+                    std::runtime_error);
+}
+
+TEST_CASE("Verify that the metrics of a statistics queue are written"
+          " correctly.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    QueueMetrics       metrics{100, 3, 4500, 8, 2, 70000};
+    std::ostringstream stream;
+
+    outputQueueMetrics(stream, metrics);
+    CHECK(stream.str() == "Pushes,Stalls,StallTime,PeakDepth,Blocks,"
+                          "BusyTime\n"
+                          "100,3,4500,8,2,70000\n");
+}
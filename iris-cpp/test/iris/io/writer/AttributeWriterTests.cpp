@@ -4,6 +4,7 @@
 #include <string>
 
 #include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
 #include "iris/Types.hpp"
 
 #include "iris/io/writer/AttributeWriter.hpp"
@@ -14,7 +15,9 @@ TEST_CASE("Ensure that agent attributes are written to a stream correctly.")
     using namespace iris::io;
     using namespace iris::types;
 
-    Agent* agents = new Agent[2];
+    // Every agent has the same number of values and behaviors, so the ranges
+    // are large enough to hold the custom attributes used below.
+    AgentStore agents(2, ValueList{100, 1000}, BehaviorList{100, 1000});
 
     for(auto i = 0; i < 2; i++)
     {
@@ -24,8 +27,8 @@ TEST_CASE("Ensure that agent attributes are written to a stream correctly.")
         const auto value    = static_cast<uint32>(i);
         const auto behavior = static_cast<uint32>(i);
         
-        agents[i].setInitialValues(Uint32List{value});
-        agents[i].setInitialBehavior(Uint32List{behavior});
+        agents[i].setInitialValues(Uint32List{value, value});
+        agents[i].setInitialBehavior(Uint32List{behavior, behavior});
     }
 
     agents[0].addConnection(1);
@@ -35,8 +38,8 @@ TEST_CASE("Ensure that agent attributes are written to a stream correctly.")
     {
         const auto expected = std::string(
             "AgentID,FamilySize,Power,Privilege,Values,Behavior\n"
-            "0,1,0,0,0,0\n"
-            "1,1,0,0,1,1\n"
+            "0,1,0,0,00,00\n"
+            "1,1,0,0,11,11\n"
         );
         auto       stream   = std::ostringstream();
 
@@ -59,14 +62,12 @@ TEST_CASE("Ensure that agent attributes are written to a stream correctly.")
 
         const auto expected = std::string(
             "AgentID,FamilySize,Power,Privilege,Values,Behavior\n"
-            "47,1,0,1,0,9912\n"
-            "100,1,1,0,45445,1\n"
+            "47,1,0,1,00,9912\n"
+            "100,1,1,0,45445,11\n"
         );
         auto       stream   = std::ostringstream();
 
         outputAttributes(stream, agents, 2);
         CHECK(stream.str() == expected);
     }
-
-    delete[] agents;
 }
@@ -0,0 +1,26 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "iris/Types.hpp"
+
+#include "iris/io/writer/BarrierWriter.hpp"
+
+TEST_CASE("Ensure that barrier waits are written to a stream correctly.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    std::ostringstream stream;
+
+    writeBarrierHeader(stream, 3);
+    writeBarrierWaits(stream, 1, std::vector<uint64>{10, 0, 2500});
+    writeBarrierWaits(stream, 2, std::vector<uint64>{0, 7, 1});
+
+    CHECK(stream.str() == "Time,Thread1,Thread2,Thread3\n"
+                          "1,10,0,2500\n"
+                          "2,0,7,1\n");
+}
@@ -0,0 +1,152 @@
+#include <catch.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "iris/Types.hpp"
+
+#include "iris/io/Columnar.hpp"
+#include "iris/io/reader/ColumnReader.hpp"
+#include "iris/io/writer/ColumnWriter.hpp"
+
+TEST_CASE("Ensure that rows written to a column file are read back intact.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    const auto columns = ColumnList{
+        ColumnSpec{"Id", ColumnType::UInt32},
+        ColumnSpec{"Flag", ColumnType::UInt8},
+        ColumnSpec{"Name", ColumnType::Text},
+        ColumnSpec{"Score", ColumnType::Float64},
+        ColumnSpec{"Count", ColumnType::UInt64}
+    };
+    const auto metadata = Metadata{{"run", "3"}, {"seed", "42"}};
+
+    std::ostringstream stream;
+    ColumnWriter       writer(stream, columns, metadata);
+
+    // A string stream need not be aligned, so copy it into words first.
+    std::vector<uint64> words;
+
+    const auto copy = [&stream, &words]() {
+        const auto contents = stream.str();
+
+        words.assign((contents.size() + 7) / 8, 0);
+        std::memcpy(words.data(), contents.data(), contents.size());
+
+        return contents.size();
+    };
+
+    SECTION("Verify values, text, and metadata in a single block.")
+    {
+        writer.putUnsigned(7).putUnsigned(1).putText("alpha").putReal(0.5)
+            .putUnsigned(1ull << 40).endRow();
+        writer.putUnsigned(8).putUnsigned(0).putText("").putReal(-2.25)
+            .putUnsigned(0).endRow();
+        writer.putUnsigned(9).putUnsigned(255).putText("gamma ray")
+            .putReal(1e10).putUnsigned(12).endRow();
+        writer.flush();
+
+        const auto   size = copy();
+        ColumnReader reader(reinterpret_cast<const uint8*>(words.data()),
+                            size);
+
+        REQUIRE(reader.getBlockCount() == 1);
+        CHECK(reader.getRows() == 3);
+        CHECK(reader.getColumns().size() == 5);
+        CHECK(reader.getColumns()[2].m_name == "Name");
+        CHECK(reader.getMetadata() == metadata);
+        CHECK(reader.getMetadata("seed") == "42");
+        CHECK_THROWS_AS(reader.getMetadata("missing"), std::runtime_error);
+
+        const auto ids    = reader.getValues<uint32>(0, 0);
+        const auto flags  = reader.getValues<uint8>(0, 1);
+        const auto scores = reader.getValues<fnumeric>(0, 3);
+        const auto counts = reader.getValues<uint64>(0, 4);
+
+        CHECK(std::vector<uint32>(ids.begin(), ids.end()) ==
+              std::vector<uint32>({7, 8, 9}));
+        CHECK(std::vector<uint8>(flags.begin(), flags.end()) ==
+              std::vector<uint8>({1, 0, 255}));
+        CHECK(std::vector<fnumeric>(scores.begin(), scores.end()) ==
+              std::vector<fnumeric>({0.5, -2.25, 1e10}));
+        CHECK(std::vector<uint64>(counts.begin(), counts.end()) ==
+              std::vector<uint64>({1ull << 40, 0, 12}));
+
+        CHECK(reader.getText(0, 2, 0) == "alpha");
+        CHECK(reader.getText(0, 2, 1) == "");
+        CHECK(reader.getText(0, 2, 2) == "gamma ray");
+
+        CHECK_THROWS_AS(reader.getValues<uint64>(0, 0), std::runtime_error);
+        CHECK_THROWS_AS(reader.getText(0, 0, 0), std::runtime_error);
+    }
+
+    SECTION("Verify that every flush starts a new block.")
+    {
+        for(uint32 i = 0; i < 5; i++)
+        {
+            writer.putUnsigned(i).putUnsigned(i).putText(std::string(i, 'x'))
+                .putReal(i).putUnsigned(i).endRow();
+
+            if(i % 2 == 1)
+            {
+                writer.flush();
+            }
+        }
+
+        // Flushing without new rows adds nothing.
+        writer.flush();
+        writer.flush();
+
+        const auto   size = copy();
+        ColumnReader reader(reinterpret_cast<const uint8*>(words.data()),
+                            size);
+
+        REQUIRE(reader.getBlockCount() == 3);
+        CHECK(writer.getRows() == 5);
+        CHECK(reader.getRows() == 5);
+        CHECK(reader.getBlockRows(0) == 2);
+        CHECK(reader.getBlockRows(1) == 2);
+        CHECK(reader.getBlockRows(2) == 1);
+        CHECK(reader.getValues<uint32>(1, 0)[1] == 3);
+        CHECK(reader.getText(1, 2, 0) == "xx");
+        CHECK(reader.getText(2, 2, 0) == "xxxx");
+    }
+
+    SECTION("Verify that a value of the wrong kind is refused.")
+    {
+        CHECK_THROWS_AS(writer.putReal(1.0), std::runtime_error);
+        CHECK_THROWS_AS(writer.putText("1"), std::runtime_error);
+
+        writer.putUnsigned(1).putUnsigned(1);
+        CHECK_THROWS_AS(writer.putUnsigned(1), std::runtime_error);
+    }
+
+    SECTION("Verify that a value too large for its column is refused.")
+    {
+        CHECK_THROWS_AS(writer.putUnsigned(1ull << 32), std::runtime_error);
+
+        writer.putUnsigned((1ull << 32) - 1);
+        CHECK_THROWS_AS(writer.putUnsigned(256), std::runtime_error);
+
+        writer.putUnsigned(255).putText("").putReal(0.0)
+            .putUnsigned(~0ull).endRow();
+        CHECK(writer.getRows() == 1);
+    }
+
+    SECTION("Verify that an incomplete row is refused.")
+    {
+        writer.putUnsigned(1).putUnsigned(1).putText("a");
+        CHECK_THROWS_AS(writer.endRow(), std::runtime_error);
+
+        writer.putReal(1.0).putUnsigned(2).endRow();
+        CHECK_THROWS_AS(writer.putUnsigned(3).putUnsigned(3).putText("b")
+                        .putReal(3.0).putUnsigned(3).putUnsigned(3),
+                        std::runtime_error);
+    }
+}
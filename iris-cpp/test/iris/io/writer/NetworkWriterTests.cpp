@@ -4,6 +4,7 @@
 #include <string>
 
 #include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
 #include "iris/Types.hpp"
 
 #include "iris/io/writer/NetworkWriter.hpp"
@@ -13,7 +14,7 @@ TEST_CASE("Ensure that agents are written to a stream correctly.")
     using namespace iris;
     using namespace iris::io;
 
-    Agent* agents = new Agent[2];
+    AgentStore agents(2, ValueList{}, BehaviorList{});
 
     for(auto i = 0; i < 2; i++)
     {
@@ -50,5 +51,42 @@ TEST_CASE("Ensure that agents are written to a stream correctly.")
         CHECK(stream.str() == expected);
     }
 
-    delete[] agents;
+    SECTION("Verify that frozen networks are written identically.")
+    {
+        agents[0].addConnection(4);
+        agents[1].addConnection(3);
+        agents.freezeNetworks();
+
+        const auto expected = std::string(
+            "From,To\n1,0\n4,0\n0,1\n3,1\n"
+        );
+        auto       stream   = std::ostringstream();
+
+        outputNetwork(stream, agents, 2);
+        CHECK(stream.str() == expected);
+    }
+}
+
+TEST_CASE("Ensure that renumbered agents are written with their original ids.")
+{
+    using namespace iris;
+    using namespace iris::io;
+
+    AgentStore agents(3, ValueList{}, BehaviorList{});
+
+    agents[0].addConnection(1);
+    agents[2].addConnection(0);
+    agents.freezeNetworks();
+
+    std::ostringstream before;
+    outputNetwork(before, agents, 3);
+
+    agents.renumber(IDList{2, 0, 1});
+
+    std::ostringstream after;
+    outputNetwork(after, agents, 3);
+
+    // Rows follow the new positions, but every edge is unchanged.
+    CHECK(before.str() == "From,To\n1,0\n0,2\n");
+    CHECK(after.str() == "From,To\n0,2\n1,0\n");
 }
@@ -4,6 +4,8 @@
 #include <string>
 
 #include "iris/Agent.hpp"
+#include "iris/AgentStore.hpp"
+#include "iris/DeltaBuffer.hpp"
 #include "iris/Types.hpp"
 
 #include "iris/io/writer/StatisticsWriter.hpp"
@@ -19,7 +21,7 @@ TEST_CASE("Verify that the statistics writer outputs compiled histogram data"
     random_device    seed;
     mersenne_twister random(seed());
 
-    Agent*           agents = new Agent[2];
+    AgentStore       agents(2, ValueList{2}, BehaviorList{2});
 
     for(auto i = 0; i < 2; i++)
     {
@@ -35,7 +37,7 @@ TEST_CASE("Verify that the statistics writer outputs compiled histogram data"
 
     StatisticsWriter statWriter;
 
-    statWriter.initialize(Uint32List{2});
+    statWriter.initialize(Uint32List{2}, 1);
     
     SECTION("Verify that the header is written correctly.")
     {
@@ -144,6 +146,248 @@ TEST_CASE("Verify that the statistics writer outputs compiled histogram data"
         statWriter.writeStatistics(stream, agents, 2, 4);
         CHECK(stream.str() == expected);
     }
+}
+
+TEST_CASE("Verify that the census is indexed and counted by integer.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    SECTION("Verify that permutations are indexed in the order written.")
+    {
+        AgentStore       agents(1, ValueList{3, 2}, BehaviorList{3, 2});
+        StatisticsWriter statWriter;
+
+        statWriter.initialize(Uint32List{3, 2}, 1);
+
+        const auto& codec = agents.getBehaviorCodec();
+
+        CHECK(statWriter.getIndex(codec.encode(Uint32List{0, 0})) == 0);
+        CHECK(statWriter.getIndex(codec.encode(Uint32List{0, 1})) == 1);
+        CHECK(statWriter.getIndex(codec.encode(Uint32List{1, 0})) == 2);
+        CHECK(statWriter.getIndex(codec.encode(Uint32List{2, 1})) == 5);
+
+        // The first behavior has room for a fourth choice it never makes.
+        CHECK(statWriter.getIndex(codec.set(0, 0, 3)) == 6);
+    }
+
+    SECTION("Verify that partial histograms add up on several threads.")
+    {
+        const AgentID n = 3 * StatisticsWriter::MinAgentsPerPart + 7;
+
+        AgentStore       agents(n, ValueList{3, 2}, BehaviorList{3, 2});
+        StatisticsWriter statWriter;
+
+        statWriter.initialize(Uint32List{3, 2}, 4);
+
+        std::vector<uint64> expected(6, 0);
+
+        for(AgentID i = 0; i < n; i++)
+        {
+            const auto behavior = Uint32List{(i / 5) % 3, i % 2};
+
+            agents[i].setInitialBehavior(behavior);
+            expected[behavior[0] * 2 + behavior[1]]++;
+        }
+
+        agents[n - 1].increasePrivilege();
+
+        std::ostringstream stream;
+
+        statWriter.writeStatistics(stream, agents, n, 0);
+
+        const auto& census = statWriter.getCensus();
+
+        CHECK(std::vector<uint64>(census.begin(), census.begin() + 6) ==
+              expected);
+        CHECK(stream.str().substr(0, 4) == "0,1,");
+    }
+
+    SECTION("Verify that behaviors too wide for a table are still counted.")
+    {
+        AgentStore       agents(3, ValueList{2, 65536}, BehaviorList{2, 65536});
+        StatisticsWriter statWriter;
+
+        statWriter.initialize(Uint32List{2, 65536}, 2);
+
+        agents[0].setInitialBehavior(Uint32List{1, 65535});
+        agents[1].setInitialBehavior(Uint32List{1, 65535});
+        agents[2].setInitialBehavior(Uint32List{0, 1});
+
+        std::ostringstream stream;
+
+        statWriter.writeStatistics(stream, agents, 3, 0);
+
+        const auto& census = statWriter.getCensus();
+
+        CHECK(census[131071] == 2);
+        CHECK(census[1] == 1);
+        CHECK(census[0] == 0);
+    }
+}
+
+TEST_CASE("Verify that the census may be kept up to date incrementally.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    AgentStore       agents(4, ValueList{3, 2}, BehaviorList{3, 2});
+    DeltaBuffer      deltas;
+    StatisticsWriter statWriter;
+
+    statWriter.initialize(Uint32List{3, 2}, 1);
+
+    agents[0].setInitialBehavior(Uint32List{0, 0});
+    agents[1].setInitialBehavior(Uint32List{0, 0});
+    agents[2].setInitialBehavior(Uint32List{1, 1});
+    agents[3].setInitialBehavior(Uint32List{2, 0});
+
+    statWriter.count(agents, 4);
+
+    // Agent 1 changes its first behavior and agent 3 gains privilege.
+    agents[1].updateState(0, 2);
+    deltas.addTransition(agents.getBehaviorWord(1),
+                         agents.getNextBehaviorWord(1));
+    deltas.addPrivilege(3);
+    deltas.merge(agents, 0, AgentStore::ShardCount);
+    agents.swapBehaviors();
+
+    statWriter.update(deltas);
+
+    SECTION("Verify that an update follows the changes of a step.")
+    {
+        const auto& census = statWriter.getCensus();
 
-    delete[] agents;
+        CHECK(census[0] == 1);
+        CHECK(census[3] == 1);
+        CHECK(census[4] == 2);
+        CHECK(statWriter.getTotalPrivilege() == 1);
+        CHECK(statWriter.verify(agents, 4));
+    }
+
+    SECTION("Verify that a drift is found and corrected.")
+    {
+        statWriter.update(deltas);
+
+        CHECK(!statWriter.verify(agents, 4));
+        CHECK(statWriter.getCensus()[0] == 1);
+        CHECK(statWriter.getTotalPrivilege() == 1);
+        CHECK(statWriter.verify(agents, 4));
+    }
+
+    SECTION("Verify that a row is written from the current census.")
+    {
+        std::ostringstream stream;
+
+        statWriter.write(stream, 7);
+
+        CHECK(stream.str() == "7,1,1,0,0,1,2,0\n");
+    }
+}
+
+TEST_CASE("Verify that a sparse census only counts occupied permutations.")
+{
+    using namespace iris;
+    using namespace iris::io;
+    using namespace iris::types;
+
+    AgentStore       agents(5, ValueList{3, 2}, BehaviorList{3, 2});
+    StatisticsWriter statWriter;
+
+    agents[0].setInitialBehavior(Uint32List{2, 1});
+    agents[1].setInitialBehavior(Uint32List{0, 1});
+    agents[2].setInitialBehavior(Uint32List{2, 1});
+    agents[3].setInitialBehavior(Uint32List{1, 0});
+    agents[4].setInitialBehavior(Uint32List{2, 1});
+    agents[3].increasePrivilege();
+
+    SECTION("Verify that occupied permutations are written in long form.")
+    {
+        std::ostringstream stream;
+
+        statWriter.initializeSparse(Uint32List{3, 2}, 1, 0);
+        statWriter.writeHeader(stream);
+        statWriter.writeStatistics(stream, agents, 5, 3);
+
+        CHECK(statWriter.isSparse());
+        CHECK(statWriter.getCensus().empty());
+        CHECK(stream.str() == "Time,Privilege,Behavior,Count\n"
+                              "3,1,01,1\n"
+                              "3,1,10,1\n"
+                              "3,1,21,3\n");
+    }
+
+    SECTION("Verify that a limit keeps only the most common permutations.")
+    {
+        std::ostringstream stream;
+
+        statWriter.initializeSparse(Uint32List{3, 2}, 1, 2);
+        statWriter.writeStatistics(stream, agents, 5, 3);
+
+        CHECK(statWriter.getOccupied().size() == 3);
+        CHECK(stream.str() == "3,1,01,1\n"
+                              "3,1,21,3\n");
+    }
+
+    SECTION("Verify that a sparse census may be kept up to date.")
+    {
+        DeltaBuffer deltas;
+
+        statWriter.initializeSparse(Uint32List{3, 2}, 1, 0);
+        statWriter.count(agents, 5);
+
+        // Agent 1 leaves its permutation empty, and agent 0 opens a new one.
+        agents[1].updateState(0, 1);
+        agents[0].updateState(1, 0);
+        deltas.addTransition(agents.getBehaviorWord(1),
+                             agents.getNextBehaviorWord(1));
+        deltas.addTransition(agents.getBehaviorWord(0),
+                             agents.getNextBehaviorWord(0));
+        agents.swapBehaviors();
+
+        statWriter.update(deltas);
+
+        const auto& occupied = statWriter.getOccupied();
+
+        REQUIRE(occupied.size() == 4);
+        CHECK(occupied[0].m_index == 2);
+        CHECK(occupied[0].m_count == 1);
+        CHECK(occupied[1].m_index == 3);
+        CHECK(occupied[1].m_count == 1);
+        CHECK(occupied[2].m_index == 4);
+        CHECK(occupied[2].m_count == 1);
+        CHECK(occupied[3].m_index == 5);
+        CHECK(occupied[3].m_count == 2);
+        CHECK(statWriter.verify(agents, 5));
+    }
+
+    SECTION("Verify that the runs of several threads are combined.")
+    {
+        const AgentID n = 2 * StatisticsWriter::MinAgentsPerPart + 3;
+
+        AgentStore       many(n, ValueList{3, 2}, BehaviorList{3, 2});
+        StatisticsWriter dense;
+
+        for(AgentID i = 0; i < n; i++)
+        {
+            many[i].setInitialBehavior(Uint32List{(i / 7) % 3, i % 2});
+        }
+
+        dense.initialize(Uint32List{3, 2}, 1);
+        dense.count(many, n);
+        statWriter.initializeSparse(Uint32List{3, 2}, 3, 0);
+        statWriter.count(many, n);
+
+        const auto& occupied = statWriter.getOccupied();
+
+        REQUIRE(occupied.size() == 6);
+
+        for(std::size_t j = 0; j < occupied.size(); j++)
+        {
+            CHECK(occupied[j].m_index == j);
+            CHECK(occupied[j].m_count == dense.getCensus()[j]);
+        }
+    }
 }